@@ -0,0 +1,93 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "detail/waiter_queue.hpp"
+
+namespace rod
+{
+	/** Asynchronous reusable barrier used to suspend sender operations or coroutines until all expected arrivals of the current phase have arrived. */
+	class async_barrier : _detail::waiter_queue<async_barrier>
+	{
+		friend class _detail::waiter_queue<async_barrier>;
+
+		using sender_t = _waiter_queue::sender<async_barrier>;
+
+		/* Request of a waiter that arrives at the barrier once the sender is started, as opposed to a waiter that waits for an arrival token. */
+		static constexpr std::uint64_t arrive_request = std::uint64_t(1) << 32;
+
+	public:
+		/** Token identifying the phase of an arrival at the barrier. */
+		class arrival_token
+		{
+			friend class async_barrier;
+
+			constexpr explicit arrival_token(std::uint32_t phase) noexcept : _phase(phase) {}
+
+		public:
+			arrival_token() = delete;
+
+		private:
+			std::uint32_t _phase;
+		};
+
+	public:
+		/** Initializes the barrier with \a expected number of arrivals per phase. */
+		constexpr explicit async_barrier(std::uint32_t expected) noexcept : _state(expected), _expected(expected) {}
+
+		/** Returns a sender that arrives at the barrier once started, and completes once the current phase of the barrier is complete.
+		 * If the stop token of the connected receiver is triggered before the sender is started, the sender completes via the stop channel without arriving at the barrier.
+		 * If the stop token is triggered after the arrival, the arrival is not undone.
+		 * Expression `co_await barrier.async_arrive_and_wait()` suspends a coroutine that supports awaiting senders until the phase is complete. */
+		[[nodiscard]] sender_t async_arrive_and_wait() noexcept { return sender_t{this, arrive_request}; }
+		/** Returns a sender that completes once the phase identified by \a tok is complete.
+		 * If the stop token of the connected receiver is triggered before the phase is complete, the sender completes via the stop channel. */
+		[[nodiscard]] sender_t async_wait(arrival_token tok) noexcept { return sender_t{this, tok._phase}; }
+
+		/** Arrives at the barrier \a n times, and returns an arrival token for the current phase.
+		 * If the arrival completes the phase, all waiters of the phase are resumed and the next phase begins. */
+		[[nodiscard]] arrival_token arrive(std::uint32_t n = 1) noexcept
+		{
+			for (auto state = _state.load(std::memory_order_relaxed);;)
+			{
+				const auto phase = static_cast<std::uint32_t>(state >> 32);
+				const auto remaining = static_cast<std::uint32_t>(state) - n;
+
+				/* Completing arrival starts the next phase, resetting the counter to the expected number of arrivals. */
+				const auto next = remaining == 0 ? (std::uint64_t(phase + 1) << 32) | _expected.load(std::memory_order_relaxed) : (state & ~std::uint64_t(0xffff'ffff)) | remaining;
+				if (!_state.compare_exchange_weak(state, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+					continue;
+
+				if (remaining == 0)
+					process();
+				return arrival_token{phase};
+			}
+		}
+		/** Decrements the expected number of arrivals of the following phases, and arrives at the barrier once. */
+		void arrive_and_drop() noexcept
+		{
+			_expected.fetch_sub(1, std::memory_order_relaxed);
+			static_cast<void>(arrive());
+		}
+
+	private:
+		[[nodiscard]] std::uint32_t phase() const noexcept { return static_cast<std::uint32_t>(_state.load() >> 32); }
+
+		void prepare_request(_detail::queued_waiter *node) noexcept
+		{
+			if (node->_request == arrive_request)
+				node->_request = arrive()._phase;
+		}
+		/* Waiters of different phases may be queued in any order, so waiters of the current phase do not block the following ones. */
+		_detail::grant_result try_grant(_detail::queued_waiter *node) noexcept { return phase() != node->_request ? _detail::grant_result::granted : _detail::grant_result::skipped; }
+		void revoke(_detail::queued_waiter *) noexcept {}
+
+		/* Phase number in the upper half, and the remaining number of arrivals in the lower half. */
+		std::atomic<std::uint64_t> _state;
+		std::atomic<std::uint32_t> _expected;
+	};
+}
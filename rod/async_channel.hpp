@@ -0,0 +1,473 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <memory>
+#include <atomic>
+#include <thread>
+
+#include "detail/cache_line.hpp"
+#include "detail/waiter_queue.hpp"
+
+namespace rod
+{
+	template<typename T> requires std::is_nothrow_move_constructible_v<T>
+	class async_channel;
+
+	namespace _async_channel
+	{
+		/* Outcome of a request of a channel waiter. */
+		enum request_t : std::uint64_t { permit, closed };
+
+		/* Bounded ring buffer of channel elements. Slots are reserved by incrementing the head or tail index, and each slot
+		 * carries a sequence number that is advanced once the element is written or read. Channel permits guarantee that a reserved
+		 * slot is either available or is about to become available, in which case the reserving thread waits for the other side to finish. */
+		template<typename T>
+		class ring_buffer
+		{
+			struct slot
+			{
+				std::atomic<std::size_t> seq;
+				alignas(T) unsigned char data[sizeof(T)];
+			};
+
+		public:
+			ring_buffer(const ring_buffer &) = delete;
+			ring_buffer &operator=(const ring_buffer &) = delete;
+
+			explicit ring_buffer(std::size_t capacity) : _slots(std::make_unique<slot[]>(capacity)), _capacity(capacity)
+			{
+				for (std::size_t i = 0; i < capacity; ++i)
+					_slots[i].seq.store(i, std::memory_order_relaxed);
+			}
+			~ring_buffer()
+			{
+				for (auto head = _head.load(); head != _tail.load(); ++head)
+					std::destroy_at(data(_slots[head % _capacity]));
+			}
+
+			[[nodiscard]] std::size_t capacity() const noexcept { return _capacity; }
+
+			/* Writes the value into the next free slot. Caller must hold a free slot permit. */
+			void push(T &&value) noexcept
+			{
+				const auto pos = _tail.fetch_add(1, std::memory_order_relaxed);
+				auto &s = wait_slot(pos, pos);
+				std::construct_at(data(s), std::move(value));
+				s.seq.store(pos + 1, std::memory_order_release);
+			}
+			/* Reads the value from the next filled slot. Caller must hold a filled slot permit. */
+			[[nodiscard]] T pop() noexcept
+			{
+				const auto pos = _head.fetch_add(1, std::memory_order_relaxed);
+				auto &s = wait_slot(pos, pos + 1);
+				auto value = std::move(*data(s));
+				std::destroy_at(data(s));
+				s.seq.store(pos + _capacity, std::memory_order_release);
+				return value;
+			}
+
+		private:
+			static T *data(slot &s) noexcept { return std::launder(reinterpret_cast<T *>(s.data)); }
+
+			slot &wait_slot(std::size_t pos, std::size_t seq) noexcept
+			{
+				auto &s = _slots[pos % _capacity];
+				while (s.seq.load(std::memory_order_acquire) != seq)
+					std::this_thread::yield();
+				return s;
+			}
+
+			std::unique_ptr<slot[]> _slots;
+			std::size_t _capacity;
+
+			alignas(_detail::cache_line_size) std::atomic<std::size_t> _head = {};
+			alignas(_detail::cache_line_size) std::atomic<std::size_t> _tail = {};
+		};
+
+		/* State of a channel shared between both of its waiter queues. `_senders` contains the number of active send operations
+		 * and the closed flag in the highest bit. Receivers observe the channel as closed only once all active send operations are complete,
+		 * so that values sent concurrently with `close` are not lost. Sequentially-consistent operations are used throughout, so that either
+		 * a waiter observes a state change, or the thread changing the state observes the queued waiter. */
+		struct channel_state;
+
+		struct send_queue : _detail::waiter_queue<send_queue>
+		{
+			constexpr explicit send_queue(channel_state *state, std::ptrdiff_t free) noexcept : _state(state), _free(free) {}
+
+			inline _detail::grant_result try_grant(_detail::queued_waiter *node) noexcept;
+			void revoke(_detail::queued_waiter *node) noexcept
+			{
+				if (node->_request == permit)
+					_free.fetch_add(1);
+			}
+
+			bool try_take() noexcept
+			{
+				for (auto free = _free.load(); free > 0;)
+					if (_free.compare_exchange_weak(free, free - 1))
+						return true;
+				return false;
+			}
+			void release() noexcept
+			{
+				_free.fetch_add(1);
+				if (has_waiters())
+					process();
+			}
+
+			channel_state *_state;
+			std::atomic<std::ptrdiff_t> _free;
+		};
+		struct receive_queue : _detail::waiter_queue<receive_queue>
+		{
+			constexpr explicit receive_queue(channel_state *state) noexcept : _state(state) {}
+
+			inline _detail::grant_result try_grant(_detail::queued_waiter *node) noexcept;
+			void revoke(_detail::queued_waiter *node) noexcept
+			{
+				if (node->_request == permit)
+					_filled.fetch_add(1);
+			}
+
+			bool try_take() noexcept
+			{
+				for (auto filled = _filled.load(); filled > 0;)
+					if (_filled.compare_exchange_weak(filled, filled - 1))
+						return true;
+				return false;
+			}
+			void release() noexcept
+			{
+				_filled.fetch_add(1);
+				if (has_waiters())
+					process();
+			}
+
+			channel_state *_state;
+			std::atomic<std::ptrdiff_t> _filled = {};
+		};
+
+		struct channel_state
+		{
+			static constexpr std::uint64_t closed_bit = std::uint64_t(1) << 63;
+
+			channel_state(const channel_state &) = delete;
+			channel_state &operator=(const channel_state &) = delete;
+
+			constexpr explicit channel_state(std::size_t capacity) noexcept : _send_queue(this, static_cast<std::ptrdiff_t>(capacity)), _receive_queue(this) {}
+
+			[[nodiscard]] bool is_closed() const noexcept { return _senders.load() & closed_bit; }
+			/* Receivers may only complete as closed once there are no active send operations. */
+			[[nodiscard]] bool is_drained() const noexcept { return _senders.load() == closed_bit; }
+
+			/* Registers an active send operation, unless the channel is closed. */
+			bool enter() noexcept
+			{
+				for (auto senders = _senders.load(); !(senders & closed_bit);)
+					if (_senders.compare_exchange_weak(senders, senders + 1))
+						return true;
+				return false;
+			}
+			/* Completes an active send operation. The last send operation of a closed channel notifies the receivers of the channel being closed. */
+			void leave() noexcept
+			{
+				if (_senders.fetch_sub(1) == closed_bit + 1 && _receive_queue.has_waiters())
+					_receive_queue.process();
+			}
+			void close() noexcept
+			{
+				if (_senders.fetch_or(closed_bit) & closed_bit)
+					return;
+				_send_queue.process();
+				_receive_queue.process();
+			}
+
+			std::atomic<std::uint64_t> _senders = {};
+			send_queue _send_queue;
+			receive_queue _receive_queue;
+		};
+
+		_detail::grant_result send_queue::try_grant(_detail::queued_waiter *node) noexcept
+		{
+			if (_state->is_closed())
+				node->_request = closed;
+			else if (try_take())
+				node->_request = permit;
+			else
+				return _detail::grant_result::blocked;
+			return _detail::grant_result::granted;
+		}
+		_detail::grant_result receive_queue::try_grant(_detail::queued_waiter *node) noexcept
+		{
+			/* Filled slots are re-checked after observing the channel as drained, since the last send operation may have filled a slot in between. */
+			if (try_take())
+				node->_request = permit;
+			else if (!_state->is_drained())
+				return _detail::grant_result::blocked;
+			else if (try_take())
+				node->_request = permit;
+			else
+				node->_request = closed;
+			return _detail::grant_result::granted;
+		}
+
+		template<typename T>
+		struct channel_base : channel_state
+		{
+			explicit channel_base(std::size_t capacity) : channel_state(capacity), _buffer(capacity) {}
+
+			void push(T &&value) noexcept
+			{
+				_buffer.push(std::move(value));
+				_receive_queue.release();
+			}
+			[[nodiscard]] T pop() noexcept
+			{
+				auto value = _buffer.pop();
+				_send_queue.release();
+				return value;
+			}
+
+			ring_buffer<T> _buffer;
+		};
+
+		template<typename T, typename Rcv>
+		struct send_operation { class type; };
+		template<typename T, typename Rcv>
+		struct receive_operation { class type; };
+
+		/* Common implementation of channel operations. `Op` implements `on_start`, `on_granted` and `on_closed`. */
+		template<typename Op, typename Queue, typename Rcv>
+		class operation_base : public _detail::queued_waiter, public empty_base<Rcv>
+		{
+			using rcv_base = empty_base<Rcv>;
+
+			struct stop_trigger
+			{
+				void operator()() const noexcept { _op->_queue->cancel(_op); }
+				operation_base *_op;
+			};
+			using stop_cb_t = std::optional<stop_callback_for_t<stop_token_of_t<env_of_t<Rcv> &>, stop_trigger>>;
+
+		public:
+			operation_base(operation_base &&) = delete;
+			operation_base &operator=(operation_base &&) = delete;
+
+			constexpr explicit operation_base(Queue *queue, Rcv &&rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>) : rcv_base(std::forward<Rcv>(rcv)), _queue(queue)
+			{
+				_notify = [](async_waiter *ptr) noexcept { static_cast<operation_base *>(ptr)->complete(); };
+			}
+
+			void start() noexcept
+			{
+				auto tok = get_stop_token(get_env(rcv_base::value()));
+				if (tok.stop_requested())
+					return set_stopped(std::move(rcv_base::value()));
+				if (!op().on_start())
+					return op().on_closed();
+
+				if (_queue->try_immediate(this))
+					return complete();
+				if (tok.stop_possible())
+					_stop_cb.emplace(std::move(tok), stop_trigger{this});
+				_queue->enqueue(this);
+			}
+
+		protected:
+			[[nodiscard]] Rcv &&receiver() noexcept { return std::move(rcv_base::value()); }
+
+		private:
+			[[nodiscard]] Op &op() noexcept { return static_cast<Op &>(*this); }
+
+			void complete() noexcept
+			{
+				_stop_cb.reset();
+				if (!is_granted())
+					op().on_stopped();
+				else if (_request == permit)
+					op().on_granted();
+				else
+					op().on_closed();
+			}
+
+			Queue *_queue;
+			stop_cb_t _stop_cb;
+		};
+
+		template<typename T, typename Rcv>
+		class send_operation<T, Rcv>::type : public operation_base<type, send_queue, Rcv>
+		{
+			friend class operation_base<type, send_queue, Rcv>;
+
+		public:
+			constexpr explicit type(channel_base<T> *chan, T &&value, Rcv &&rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>)
+					: operation_base<type, send_queue, Rcv>(&chan->_send_queue, std::forward<Rcv>(rcv)), _chan(chan), _value(std::move(value)) {}
+
+			friend void tag_invoke(start_t, type &op) noexcept { op.start(); }
+
+		private:
+			bool on_start() noexcept { return _chan->enter(); }
+			void on_granted() noexcept
+			{
+				_chan->push(std::move(_value));
+				_chan->leave();
+				set_value(this->receiver(), true);
+			}
+			void on_closed() noexcept
+			{
+				if (this->is_granted())
+					_chan->leave();
+				set_value(this->receiver(), false);
+			}
+			void on_stopped() noexcept
+			{
+				_chan->leave();
+				set_stopped(this->receiver());
+			}
+
+			channel_base<T> *_chan;
+			T _value;
+		};
+		template<typename T, typename Rcv>
+		class receive_operation<T, Rcv>::type : public operation_base<type, receive_queue, Rcv>
+		{
+			friend class operation_base<type, receive_queue, Rcv>;
+
+		public:
+			constexpr explicit type(channel_base<T> *chan, Rcv &&rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>)
+					: operation_base<type, receive_queue, Rcv>(&chan->_receive_queue, std::forward<Rcv>(rcv)), _chan(chan) {}
+
+			friend void tag_invoke(start_t, type &op) noexcept { op.start(); }
+
+		private:
+			static constexpr bool on_start() noexcept { return true; }
+			void on_granted() noexcept { set_value(this->receiver(), std::optional<T>{_chan->pop()}); }
+			void on_closed() noexcept { set_value(this->receiver(), std::optional<T>{}); }
+			void on_stopped() noexcept { set_stopped(this->receiver()); }
+
+			channel_base<T> *_chan;
+		};
+
+		template<typename T>
+		class send_sender
+		{
+			template<typename Rcv>
+			using operation_t = typename send_operation<T, Rcv>::type;
+
+		public:
+			using is_sender = std::true_type;
+			using signs_t = completion_signatures<set_value_t(bool), set_stopped_t()>;
+
+		public:
+			constexpr explicit send_sender(channel_base<T> *chan, T &&value) noexcept : _chan(chan), _value(std::move(value)) {}
+
+			template<decays_to_same<send_sender> S, typename Env>
+			friend constexpr signs_t tag_invoke(get_completion_signatures_t, S &&, Env) noexcept { return {}; }
+			template<rod::receiver_of<signs_t> Rcv>
+			friend constexpr operation_t<Rcv> tag_invoke(connect_t, send_sender &&s, Rcv rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>)
+			{
+				return operation_t<Rcv>{s._chan, std::move(s._value), std::move(rcv)};
+			}
+			template<rod::receiver_of<signs_t> Rcv> requires std::copy_constructible<T>
+			friend constexpr operation_t<Rcv> tag_invoke(connect_t, const send_sender &s, Rcv rcv) noexcept(std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_move_constructible_v<Rcv>)
+			{
+				return operation_t<Rcv>{s._chan, T{s._value}, std::move(rcv)};
+			}
+
+		private:
+			channel_base<T> *_chan;
+			T _value;
+		};
+		template<typename T>
+		class receive_sender
+		{
+			template<typename Rcv>
+			using operation_t = typename receive_operation<T, Rcv>::type;
+
+		public:
+			using is_sender = std::true_type;
+			using signs_t = completion_signatures<set_value_t(std::optional<T>), set_stopped_t()>;
+
+		public:
+			constexpr explicit receive_sender(channel_base<T> *chan) noexcept : _chan(chan) {}
+
+			template<decays_to_same<receive_sender> S, typename Env>
+			friend constexpr signs_t tag_invoke(get_completion_signatures_t, S &&, Env) noexcept { return {}; }
+			template<decays_to_same<receive_sender> S, rod::receiver_of<signs_t> Rcv>
+			friend constexpr operation_t<Rcv> tag_invoke(connect_t, S &&s, Rcv rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>)
+			{
+				return operation_t<Rcv>{s._chan, std::move(rcv)};
+			}
+
+		private:
+			channel_base<T> *_chan;
+		};
+	}
+
+	/** Bounded multi-producer multi-consumer channel used to pass values between sender operations or coroutines.
+	 * Send operations suspend while the channel is full, and receive operations suspend while the channel is empty, which applies backpressure
+	 * to the producers instead of buffering an unbounded number of values. Suspended operations are resumed in the order they have been queued.
+	 * @tparam T Type of values passed through the channel. */
+	template<typename T> requires std::is_nothrow_move_constructible_v<T>
+	class async_channel : _async_channel::channel_base<T>
+	{
+		using base_t = _async_channel::channel_base<T>;
+		using send_sender_t = _async_channel::send_sender<T>;
+		using receive_sender_t = _async_channel::receive_sender<T>;
+
+	public:
+		using value_type = T;
+
+	public:
+		/** Initializes the channel with a buffer of \a capacity values.
+		 * @throw std::bad_alloc On failure to allocate the buffer. */
+		explicit async_channel(std::size_t capacity) : base_t(capacity) { assert(capacity != 0); }
+
+		/** Returns the maximum number of values buffered by the channel. */
+		[[nodiscard]] std::size_t capacity() const noexcept { return base_t::_buffer.capacity(); }
+		/** Checks if the channel has been closed. */
+		[[nodiscard]] bool is_closed() const noexcept { return base_t::is_closed(); }
+
+		/** Returns a sender that sends \a value through the channel, suspending until there is space in the buffer of the channel.
+		 * The sender completes with `true` once the value is buffered, or with `false` if the channel is closed before the value can be buffered, in which case the value is discarded.
+		 * If the stop token of the connected receiver is triggered before the value is buffered, the sender completes via the stop channel.
+		 * Expression `co_await chan.send(value)` suspends a coroutine that supports awaiting senders until the value is sent. */
+		[[nodiscard]] send_sender_t send(T value) noexcept { return send_sender_t{this, std::move(value)}; }
+		/** Returns a sender that receives a value from the channel, suspending until there is a value in the buffer of the channel.
+		 * The sender completes with the received value, or with an empty `std::optional` once the channel is closed and all buffered values have been received.
+		 * If the stop token of the connected receiver is triggered before a value is received, the sender completes via the stop channel.
+		 * Expression `co_await chan.receive()` suspends a coroutine that supports awaiting senders until a value is received. */
+		[[nodiscard]] receive_sender_t receive() noexcept { return receive_sender_t{this}; }
+
+		/** Attempts to send \a value through the channel without waiting.
+		 * @return `true` if the value was buffered, `false` if the channel is full, closed, or there are queued senders. */
+		bool try_send(T &&value) noexcept
+		{
+			if (!base_t::enter())
+				return false;
+
+			auto &queue = base_t::_send_queue;
+			const auto result = !queue.has_waiters() && queue.try_take();
+			if (result)
+				base_t::push(std::move(value));
+			return (base_t::leave(), result);
+		}
+		/** Attempts to receive a value from the channel without waiting.
+		 * @return Received value, or an empty `std::optional` if the channel is empty or there are queued receivers. */
+		[[nodiscard]] std::optional<T> try_receive() noexcept
+		{
+			auto &queue = base_t::_receive_queue;
+			if (!queue.has_waiters() && queue.try_take())
+				return base_t::pop();
+			return std::nullopt;
+		}
+
+		/** Closes the channel. Queued and following send operations complete with `false`, while receive operations
+		 * complete with the remaining buffered values and then with an empty `std::optional`. */
+		void close() noexcept { base_t::close(); }
+	};
+}
@@ -0,0 +1,43 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#pragma once
+
+#include "detail/waiter_queue.hpp"
+
+namespace rod
+{
+	/** Asynchronous single-use latch used to suspend sender operations or coroutines until the internal counter reaches zero. */
+	class async_latch : _detail::waiter_queue<async_latch>
+	{
+		friend class _detail::waiter_queue<async_latch>;
+
+		using sender_t = _waiter_queue::sender<async_latch>;
+
+	public:
+		/** Initializes the latch with internal counter set to \a expected. */
+		constexpr explicit async_latch(std::ptrdiff_t expected) noexcept : _count(expected) {}
+
+		/** Returns a sender that completes once the internal counter of the latch reaches zero.
+		 * If the stop token of the connected receiver is triggered before the counter reaches zero, the sender completes via the stop channel.
+		 * Expression `co_await latch.async_wait()` suspends a coroutine that supports awaiting senders until the counter reaches zero. */
+		[[nodiscard]] sender_t async_wait() noexcept { return sender_t{this}; }
+
+		/** Decrements the internal counter of the latch by \a n. Once the counter reaches zero, all waiters are resumed. */
+		void count_down(std::ptrdiff_t n = 1) noexcept
+		{
+			if (_count.fetch_sub(n) == n)
+				process();
+		}
+		/** Checks if the internal counter of the latch has reached zero. */
+		[[nodiscard]] bool try_wait() const noexcept { return _count.load(std::memory_order_acquire) == 0; }
+
+	private:
+		/* Sequentially-consistent, so that either the waiter observes the counter reaching zero, or the final `count_down` processes the queued waiter. */
+		_detail::grant_result try_grant(_detail::queued_waiter *) noexcept { return _count.load() == 0 ? _detail::grant_result::granted : _detail::grant_result::blocked; }
+		void revoke(_detail::queued_waiter *) noexcept {}
+
+		std::atomic<std::ptrdiff_t> _count;
+	};
+}
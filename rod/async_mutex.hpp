@@ -4,70 +4,56 @@
 
 #pragma once
 
-#include "detail/config.hpp"
-
-#ifdef ROD_HAS_COROUTINES
-
-#include <coroutine>
 #include <utility>
 #include <atomic>
 #include <mutex>
 
+#include "detail/queries/scheduler.hpp"
+#include "detail/waiter_queue.hpp"
+
+#ifdef ROD_HAS_COROUTINES
+#include <coroutine>
+#endif
+
 namespace rod
 {
 	class async_mutex;
 	class async_lock_guard;
 
-	/** Coroutine mutex used to suspend a coroutine until the lock is acquired. */
-	class async_mutex
+	namespace _async_mutex
 	{
-		class awaiter
-		{
-			friend class async_mutex;
+		using waiter_base = _detail::async_waiter;
 
-		public:
-			explicit awaiter(async_mutex &mtx) noexcept : _mtx(mtx) {}
+		inline bool lock_or_enqueue(async_mutex &mtx, waiter_base *node) noexcept;
 
-			constexpr void await_resume() const noexcept {}
-			constexpr bool await_ready() const noexcept { return false; }
-			bool await_suspend(std::coroutine_handle<> cont) noexcept
-			{
-				_cont = cont;
-				for (auto state = _mtx._state.load(std::memory_order_acquire);;)
-				{
-					if (!state)
-					{
-						if (_mtx._state.compare_exchange_weak(
-								state, &_mtx._state,
-								std::memory_order_acquire,
-								std::memory_order_relaxed))
-							return false;
-						continue;
-					}
-
-					_next = static_cast<awaiter *>(state);
-					if (_mtx._state.compare_exchange_weak(
-							state, this,
-							std::memory_order_release,
-							std::memory_order_relaxed))
-						return true;
-				}
-			}
+#ifdef ROD_HAS_COROUTINES
+		template<bool Guard>
+		class awaiter;
+#endif
+		template<bool Guard>
+		class sender;
+		template<typename, bool>
+		struct scheduled_sender { class type; };
+		template<bool, typename>
+		struct operation { class type; };
+		template<typename, bool, typename>
+		struct scheduled_operation { class type; };
+		template<typename, bool, typename>
+		struct scheduled_receiver { class type; };
+		template<typename>
+		struct env { class type; };
 
-		private:
-			std::coroutine_handle<> _cont = {};
-			awaiter *_next = {};
+		template<bool Guard>
+		using value_signs_t = std::conditional_t<Guard, completion_signatures<set_value_t(async_lock_guard)>, completion_signatures<set_value_t()>>;
+	}
 
-		protected:
-			async_mutex &_mtx;
-		};
-		class guard_awaiter : public awaiter
-		{
-		public:
-			using awaiter::awaiter;
+	/** Asynchronous mutex used to suspend a coroutine or a sender operation until the lock is acquired.
+	 * Waiters acquire the lock in the order they have been queued. */
+	class async_mutex
+	{
+		friend bool _async_mutex::lock_or_enqueue(async_mutex &, _async_mutex::waiter_base *) noexcept;
 
-			[[nodiscard]] inline async_lock_guard await_resume() const noexcept;
-		};
+		using waiter_base = _async_mutex::waiter_base;
 
 	public:
 		async_mutex(const async_mutex &) = delete;
@@ -77,11 +63,23 @@ namespace rod
 
 		constexpr async_mutex() noexcept = default;
 
-		/** Asynchronously locks the mutex and returns an awaiter suspended until the lock is acquired. */
-		[[nodiscard]] awaiter async_lock() noexcept { return awaiter{*this}; }
-		/** Asynchronously locks the mutex and returns a lock guard awaiter suspended until the lock is acquired.
+		/** Returns a sender that locks the mutex and completes once the lock is acquired.
+		 * The lock is handed off to the sender inside the call to `unlock` that released it.
+		 * Expression `co_await mtx.async_lock()` suspends the coroutine until the lock is acquired. */
+		[[nodiscard]] inline _async_mutex::sender<false> async_lock() noexcept;
+		/** Returns a sender that locks the mutex and completes on \a sch once the lock is acquired.
+		 * The lock is handed off to the sender by scheduling it onto \a sch, allowing the unlocking thread to continue without running the critical section of the waiter.
+		 * @note If scheduling onto \a sch fails, the mutex is unlocked before the error or stop completion is forwarded to the receiver. */
+		template<rod::scheduler Sch>
+		[[nodiscard]] typename _async_mutex::scheduled_sender<std::decay_t<Sch>, false>::type async_lock(Sch &&sch) noexcept(std::is_nothrow_constructible_v<std::decay_t<Sch>, Sch>);
+
+		/** Returns a sender that locks the mutex and completes with an RAII lock guard once the lock is acquired.
 		 * Expression `co_await mtx.async_scoped_lock()` evaluates to an RAII lock guard for the locked mutex. */
-		[[nodiscard]] guard_awaiter async_scoped_lock() noexcept { return guard_awaiter{*this}; }
+		[[nodiscard]] inline _async_mutex::sender<true> async_scoped_lock() noexcept;
+		/** Returns a sender that locks the mutex and completes on \a sch with an RAII lock guard once the lock is acquired.
+		 * @note If scheduling onto \a sch fails, the mutex is unlocked before the error or stop completion is forwarded to the receiver. */
+		template<rod::scheduler Sch>
+		[[nodiscard]] typename _async_mutex::scheduled_sender<std::decay_t<Sch>, true>::type async_scoped_lock(Sch &&sch) noexcept(std::is_nothrow_constructible_v<std::decay_t<Sch>, Sch>);
 
 		/** Attempts to lock the mutex.
 		 * @return `true` is locked successfully, `false` if the mutex is already locked. */
@@ -90,7 +88,9 @@ namespace rod
 			void *old = nullptr;
 			return _state.compare_exchange_strong(old, &_state, std::memory_order_acquire, std::memory_order_relaxed);
 		}
-		/** Unlocks the mutex and resumes the next waiting coroutine inside this call. */
+		/** Unlocks the mutex and hands the lock off to the next waiter inside this call.
+		 * @note If called from within a handoff of the current thread (i.e. by a waiter that has been resumed inline by another `unlock`),
+		 * the next handoff is deferred until the outer handoff returns, rather than being executed recursively. */
 		void unlock()
 		{
 			auto front = _queue;
@@ -103,8 +103,9 @@ namespace rod
 						std::memory_order_relaxed))
 					return;
 
+				/* Take all queued waiters at once, and reverse them into FIFO order. */
 				state = _state.exchange(&_state, std::memory_order_acquire);
-				for (auto node = static_cast<awaiter *>(state);;)
+				for (auto node = static_cast<waiter_base *>(state);;)
 				{
 					const auto next = node->_next;
 					node->_next = std::exchange(front, node);
@@ -113,16 +114,40 @@ namespace rod
 				}
 			}
 
-			/* Un-link & resume the blocked coroutine. */
+			/* Un-link & notify the blocked waiter. */
 			_queue = front->_next;
-			front->_cont.resume();
+			_detail::local_trampoline.handoff(front);
 		}
 
 	private:
+		/* Acquires the lock if it is not locked, or queues the waiter otherwise. Returns `true` if the lock has been acquired. */
+		bool lock_or_enqueue(waiter_base *node) noexcept
+		{
+			for (auto state = _state.load(std::memory_order_acquire);;)
+			{
+				if (!state)
+				{
+					if (_state.compare_exchange_weak(
+							state, &_state,
+							std::memory_order_acquire,
+							std::memory_order_relaxed))
+						return true;
+					continue;
+				}
+
+				node->_next = state == &_state ? nullptr : static_cast<waiter_base *>(state);
+				if (_state.compare_exchange_weak(
+						state, node,
+						std::memory_order_release,
+						std::memory_order_relaxed))
+					return false;
+			}
+		}
+
 		/* _state == &_state - locked with no waiters.
 		 * _state == nullptr - not locked. */
 		std::atomic<void *> _state = {};
-		awaiter *_queue = {};
+		waiter_base *_queue = {};
 	};
 
 	/** RAII lock guard for the `async_mutex` mutex type. */
@@ -140,6 +165,224 @@ namespace rod
 		async_mutex *_mtx;
 	};
 
-	async_lock_guard async_mutex::guard_awaiter::await_resume() const noexcept { return {_mtx, std::adopt_lock}; }
-}
+	namespace _async_mutex
+	{
+		bool lock_or_enqueue(async_mutex &mtx, waiter_base *node) noexcept { return mtx.lock_or_enqueue(node); }
+
+		template<bool Guard, typename Rcv>
+		inline void complete_value(Rcv &&rcv, async_mutex &mtx) noexcept
+		{
+			if constexpr (Guard)
+				set_value(std::forward<Rcv>(rcv), async_lock_guard(mtx, std::adopt_lock));
+			else
+				set_value(std::forward<Rcv>(rcv));
+		}
+
+#ifdef ROD_HAS_COROUTINES
+		template<bool Guard>
+		class awaiter : waiter_base
+		{
+		public:
+			explicit awaiter(async_mutex &mtx) noexcept : _mtx(mtx) {}
+
+			constexpr bool await_ready() const noexcept { return false; }
+			bool await_suspend(std::coroutine_handle<> cont) noexcept
+			{
+				_notify = [](waiter_base *ptr) noexcept { static_cast<awaiter *>(ptr)->_cont.resume(); };
+				_cont = cont;
+				return !lock_or_enqueue(_mtx, this);
+			}
+			decltype(auto) await_resume() const noexcept
+			{
+				if constexpr (Guard)
+					return async_lock_guard(_mtx, std::adopt_lock);
+			}
+
+		private:
+			std::coroutine_handle<> _cont = {};
+			async_mutex &_mtx;
+		};
 #endif
+
+		template<bool Guard, typename Rcv>
+		class operation<Guard, Rcv>::type : waiter_base, empty_base<Rcv>
+		{
+			using rcv_base = empty_base<Rcv>;
+
+		public:
+			type(type &&) = delete;
+			type &operator=(type &&) = delete;
+
+			constexpr explicit type(async_mutex &mtx, Rcv &&rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>) : rcv_base(std::forward<Rcv>(rcv)), _mtx(mtx)
+			{
+				_notify = [](waiter_base *ptr) noexcept { static_cast<type *>(ptr)->complete(); };
+			}
+
+			friend void tag_invoke(start_t, type &op) noexcept { if (lock_or_enqueue(op._mtx, &op)) op.complete(); }
+
+		private:
+			void complete() noexcept { complete_value<Guard>(std::move(rcv_base::value()), _mtx); }
+
+			async_mutex &_mtx;
+		};
+
+		template<bool Guard>
+		class sender
+		{
+			template<typename Rcv>
+			using operation_t = typename operation<Guard, Rcv>::type;
+
+		public:
+			using is_sender = std::true_type;
+
+		public:
+			constexpr explicit sender(async_mutex &mtx) noexcept : _mtx(&mtx) {}
+
+			template<decays_to_same<sender> T, typename Env>
+			friend constexpr value_signs_t<Guard> tag_invoke(get_completion_signatures_t, T &&, Env) noexcept { return {}; }
+			template<decays_to_same<sender> T, rod::receiver_of<value_signs_t<Guard>> Rcv>
+			friend constexpr operation_t<Rcv> tag_invoke(connect_t, T &&s, Rcv rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>)
+			{
+				return operation_t<Rcv>{*s._mtx, std::move(rcv)};
+			}
+
+#ifdef ROD_HAS_COROUTINES
+			/** Returns an awaiter that suspends the coroutine until the lock is acquired. */
+			[[nodiscard]] awaiter<Guard> operator co_await() const noexcept { return awaiter<Guard>{*_mtx}; }
+#endif
+
+		private:
+			async_mutex *_mtx;
+		};
+
+		template<typename Sch>
+		class env<Sch>::type : empty_base<Sch>
+		{
+			using sch_base = empty_base<Sch>;
+
+		public:
+			template<typename Sch2>
+			constexpr explicit type(Sch2 &&sch) noexcept(std::is_nothrow_constructible_v<Sch, Sch2>) : sch_base(std::forward<Sch2>(sch)) {}
+
+			template<decays_to_same<type> E>
+			friend constexpr Sch tag_invoke(get_completion_scheduler_t<set_value_t>, E &&e) noexcept(std::is_nothrow_copy_constructible_v<Sch>) { return e.sch_base::value(); }
+		};
+
+		template<typename Sch, bool Guard, typename Rcv>
+		class scheduled_receiver<Sch, Guard, Rcv>::type
+		{
+			using operation_t = typename scheduled_operation<Sch, Guard, Rcv>::type;
+
+		public:
+			using is_receiver = std::true_type;
+
+		public:
+			constexpr explicit type(operation_t *op) noexcept : _op(op) {}
+
+			friend env_of_t<Rcv> tag_invoke(get_env_t, const type &r) noexcept(_detail::nothrow_callable<get_env_t, const Rcv &>) { return r.get_env(); }
+
+			template<_detail::completion_channel C> requires decays_to_same<C, set_value_t>
+			friend void tag_invoke(C, type &&r) noexcept { r.complete_value(); }
+			template<_detail::completion_channel C, typename... Args> requires(!decays_to_same<C, set_value_t> && _detail::callable<C, Rcv, Args...>)
+			friend void tag_invoke(C, type &&r, Args &&...args) noexcept { r.complete_forward(C{}, std::forward<Args>(args)...); }
+
+		private:
+			inline env_of_t<Rcv> get_env() const;
+			inline void complete_value() noexcept;
+			template<typename C, typename... Args>
+			inline void complete_forward(C, Args &&...args) noexcept;
+
+			operation_t *_op;
+		};
+
+		template<typename Sch, bool Guard, typename Rcv>
+		class scheduled_operation<Sch, Guard, Rcv>::type : waiter_base, empty_base<Rcv>
+		{
+			friend class scheduled_receiver<Sch, Guard, Rcv>::type;
+
+			using rcv_base = empty_base<Rcv>;
+			using receiver_t = typename scheduled_receiver<Sch, Guard, Rcv>::type;
+			using state_t = connect_result_t<schedule_result_t<Sch>, receiver_t>;
+
+		public:
+			type(type &&) = delete;
+			type &operator=(type &&) = delete;
+
+			constexpr explicit type(async_mutex &mtx, const Sch &sch, Rcv &&rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv> && _detail::nothrow_callable<schedule_t, const Sch &> && _detail::nothrow_callable<connect_t, schedule_result_t<Sch>, receiver_t>)
+					: rcv_base(std::forward<Rcv>(rcv)), _mtx(mtx), _state(connect(schedule(sch), receiver_t{this}))
+			{
+				_notify = [](waiter_base *ptr) noexcept { start(static_cast<type *>(ptr)->_state); };
+			}
+
+			friend void tag_invoke(start_t, type &op) noexcept { if (lock_or_enqueue(op._mtx, &op)) start(op._state); }
+
+		private:
+			async_mutex &_mtx;
+			state_t _state;
+		};
+
+		template<typename Sch, bool Guard, typename Rcv>
+		env_of_t<Rcv> scheduled_receiver<Sch, Guard, Rcv>::type::get_env() const { return rod::get_env(_op->rcv_base::value()); }
+		template<typename Sch, bool Guard, typename Rcv>
+		void scheduled_receiver<Sch, Guard, Rcv>::type::complete_value() noexcept { _async_mutex::complete_value<Guard>(std::move(_op->rcv_base::value()), _op->_mtx); }
+		template<typename Sch, bool Guard, typename Rcv>
+		template<typename C, typename... Args>
+		void scheduled_receiver<Sch, Guard, Rcv>::type::complete_forward(C, Args &&...args) noexcept
+		{
+			/* The lock is owned by this operation at this point, release it before reporting failure to schedule. */
+			_op->_mtx.unlock();
+			C{}(std::move(_op->rcv_base::value()), std::forward<Args>(args)...);
+		}
+
+		template<typename Sch, bool Guard>
+		class scheduled_sender<Sch, Guard>::type : empty_base<typename env<Sch>::type>
+		{
+			using env_t = typename env<Sch>::type;
+			using env_base = empty_base<env_t>;
+
+			template<typename Rcv>
+			using operation_t = typename scheduled_operation<Sch, Guard, Rcv>::type;
+			template<typename Rcv>
+			using receiver_t = typename scheduled_receiver<Sch, Guard, Rcv>::type;
+
+			template<typename...>
+			using value_t = value_signs_t<Guard>;
+			template<typename Env>
+			using signs_t = make_completion_signatures<schedule_result_t<Sch>, Env, completion_signatures<>, value_t>;
+
+		public:
+			using is_sender = std::true_type;
+
+		public:
+			template<typename Sch2>
+			constexpr explicit type(async_mutex &mtx, Sch2 &&sch) noexcept(std::is_nothrow_constructible_v<Sch, Sch2>) : env_base(std::forward<Sch2>(sch)), _mtx(&mtx) {}
+
+			friend constexpr const env_t &tag_invoke(get_env_t, const type &s) noexcept { return s.env_base::value(); }
+			template<decays_to_same<type> T, typename Env>
+			friend constexpr signs_t<Env> tag_invoke(get_completion_signatures_t, T &&, Env) noexcept { return {}; }
+
+			template<decays_to_same<type> T, rod::receiver Rcv> requires sender_to<schedule_result_t<Sch>, receiver_t<Rcv>>
+			friend constexpr operation_t<Rcv> tag_invoke(connect_t, T &&s, Rcv rcv) noexcept(std::is_nothrow_constructible_v<operation_t<Rcv>, async_mutex &, const Sch &, Rcv>)
+			{
+				return operation_t<Rcv>{*s._mtx, get_completion_scheduler<set_value_t>(s.env_base::value()), std::move(rcv)};
+			}
+
+		private:
+			async_mutex *_mtx;
+		};
+	}
+
+	_async_mutex::sender<false> async_mutex::async_lock() noexcept { return _async_mutex::sender<false>{*this}; }
+	_async_mutex::sender<true> async_mutex::async_scoped_lock() noexcept { return _async_mutex::sender<true>{*this}; }
+
+	template<rod::scheduler Sch>
+	typename _async_mutex::scheduled_sender<std::decay_t<Sch>, false>::type async_mutex::async_lock(Sch &&sch) noexcept(std::is_nothrow_constructible_v<std::decay_t<Sch>, Sch>)
+	{
+		return typename _async_mutex::scheduled_sender<std::decay_t<Sch>, false>::type{*this, std::forward<Sch>(sch)};
+	}
+	template<rod::scheduler Sch>
+	typename _async_mutex::scheduled_sender<std::decay_t<Sch>, true>::type async_mutex::async_scoped_lock(Sch &&sch) noexcept(std::is_nothrow_constructible_v<std::decay_t<Sch>, Sch>)
+	{
+		return typename _async_mutex::scheduled_sender<std::decay_t<Sch>, true>::type{*this, std::forward<Sch>(sch)};
+	}
+}
@@ -0,0 +1,60 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#pragma once
+
+#include <limits>
+
+#include "detail/waiter_queue.hpp"
+
+namespace rod
+{
+	/** Asynchronous counting semaphore used to suspend a sender operation or a coroutine until a permit is acquired.
+	 * Queued waiters acquire permits in the order they have been queued. */
+	class async_semaphore : _detail::waiter_queue<async_semaphore>
+	{
+		friend class _detail::waiter_queue<async_semaphore>;
+
+		using sender_t = _waiter_queue::sender<async_semaphore>;
+
+	public:
+		/** Returns the maximum value of the internal counter. */
+		[[nodiscard]] static constexpr std::ptrdiff_t max() noexcept { return std::numeric_limits<std::ptrdiff_t>::max(); }
+
+	public:
+		/** Initializes the semaphore with \a count permits. */
+		constexpr explicit async_semaphore(std::ptrdiff_t count = 0) noexcept : _count(count) {}
+
+		/** Returns a sender that completes once a permit of the semaphore is acquired.
+		 * If the stop token of the connected receiver is triggered before a permit is acquired, the sender completes via the stop channel without acquiring a permit.
+		 * Expression `co_await sem.async_acquire()` suspends a coroutine that supports awaiting senders until a permit is acquired. */
+		[[nodiscard]] sender_t async_acquire() noexcept { return sender_t{this}; }
+
+		/** Attempts to acquire a permit of the semaphore without waiting.
+		 * @return `true` if a permit was acquired, `false` if there are no available permits or there are queued waiters. */
+		bool try_acquire() noexcept { return !has_waiters() && try_take(); }
+		/** Releases \a n permits of the semaphore, and grants them to the queued waiters. */
+		void release(std::ptrdiff_t n = 1) noexcept
+		{
+			_count.fetch_add(n);
+			if (has_waiters())
+				process();
+		}
+
+	private:
+		bool try_take() noexcept
+		{
+			/* Sequentially-consistent, so that either the waiter observes a concurrent `release`, or `release` observes the queued waiter. */
+			for (auto count = _count.load(); count > 0;)
+				if (_count.compare_exchange_weak(count, count - 1))
+					return true;
+			return false;
+		}
+
+		_detail::grant_result try_grant(_detail::queued_waiter *) noexcept { return try_take() ? _detail::grant_result::granted : _detail::grant_result::blocked; }
+		void revoke(_detail::queued_waiter *) noexcept { _count.fetch_add(1); }
+
+		std::atomic<std::ptrdiff_t> _count;
+	};
+}
@@ -0,0 +1,81 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#pragma once
+
+#include "detail/waiter_queue.hpp"
+
+namespace rod
+{
+	/** Asynchronous reader-writer mutex used to suspend a sender operation or a coroutine until an exclusive or a shared lock is acquired.
+	 * Queued waiters acquire the lock in the order they have been queued, so that a queued exclusive waiter is not starved by shared waiters queued after it. */
+	class async_shared_mutex : _detail::waiter_queue<async_shared_mutex>
+	{
+		friend class _detail::waiter_queue<async_shared_mutex>;
+
+		using sender_t = _waiter_queue::sender<async_shared_mutex>;
+
+		enum request_t : std::uint64_t { exclusive, shared };
+
+	public:
+		constexpr async_shared_mutex() noexcept = default;
+
+		/** Returns a sender that completes once an exclusive lock of the mutex is acquired.
+		 * If the stop token of the connected receiver is triggered before the lock is acquired, the sender completes via the stop channel without acquiring the lock.
+		 * Expression `co_await mtx.async_lock()` suspends a coroutine that supports awaiting senders until the lock is acquired. */
+		[[nodiscard]] sender_t async_lock() noexcept { return sender_t{this, exclusive}; }
+		/** Returns a sender that completes once a shared lock of the mutex is acquired.
+		 * If the stop token of the connected receiver is triggered before the lock is acquired, the sender completes via the stop channel without acquiring the lock.
+		 * Expression `co_await mtx.async_lock_shared()` suspends a coroutine that supports awaiting senders until the lock is acquired. */
+		[[nodiscard]] sender_t async_lock_shared() noexcept { return sender_t{this, shared}; }
+
+		/** Attempts to acquire an exclusive lock of the mutex without waiting.
+		 * @return `true` if locked successfully, `false` if the mutex is already locked or there are queued waiters. */
+		bool try_lock() noexcept { return !has_waiters() && try_take(exclusive); }
+		/** Attempts to acquire a shared lock of the mutex without waiting.
+		 * @return `true` if locked successfully, `false` if the mutex is locked exclusively or there are queued waiters. */
+		bool try_lock_shared() noexcept { return !has_waiters() && try_take(shared); }
+
+		/** Releases an exclusive lock of the mutex, and hands the lock off to the queued waiters. */
+		void unlock() noexcept
+		{
+			_state.store(0);
+			if (has_waiters())
+				process();
+		}
+		/** Releases a shared lock of the mutex. Once all shared locks are released, the lock is handed off to the queued waiters. */
+		void unlock_shared() noexcept
+		{
+			if (_state.fetch_sub(1) == 1 && has_waiters())
+				process();
+		}
+
+	private:
+		/* `_state` is the number of shared locks held, or -1 if the mutex is locked exclusively. Sequentially-consistent operations are
+		 * used, so that either a waiter observes a concurrent unlock, or the unlocking thread observes the queued waiter. */
+		bool try_take(std::uint64_t req) noexcept
+		{
+			if (req == exclusive)
+			{
+				std::ptrdiff_t state = 0;
+				return _state.compare_exchange_strong(state, -1);
+			}
+			for (auto state = _state.load(); state >= 0;)
+				if (_state.compare_exchange_weak(state, state + 1))
+					return true;
+			return false;
+		}
+
+		_detail::grant_result try_grant(_detail::queued_waiter *node) noexcept { return try_take(node->_request) ? _detail::grant_result::granted : _detail::grant_result::blocked; }
+		void revoke(_detail::queued_waiter *node) noexcept
+		{
+			if (node->_request == exclusive)
+				_state.store(0);
+			else
+				_state.fetch_sub(1);
+		}
+
+		std::atomic<std::ptrdiff_t> _state = 0;
+	};
+}
@@ -6,9 +6,11 @@
 
 #include <algorithm>
 #include <optional>
-#include <vector>
+#include <ranges>
+#include <span>
 
 #include "../../stop_token.hpp"
+#include "../queries/allocator.hpp"
 #include "../async_base.hpp"
 #include "transfer.hpp"
 
@@ -16,14 +18,16 @@ namespace rod
 {
 	namespace _accumulate
 	{
-		template<typename State, typename Res, typename Acc, typename Rcv>
+		template<typename Snd, typename Policy, typename Rcv>
 		struct operation_base { struct type; };
-		template<typename Rng, typename Res, typename Acc, typename Rcv>
+		template<typename Rng, typename Policy, typename Rcv>
 		struct operation { class type; };
-		template<typename Rng, typename Res, typename Acc, typename Rcv>
+		template<typename Snd, typename Policy, typename Rcv>
 		struct receiver { class type; };
-		template<typename Rng, typename Res, typename Acc>
+		template<typename Rng, typename Policy>
 		struct sender { class type; };
+		template<typename Res, typename Acc>
+		struct fold { class type; };
 		template<typename Env>
 		struct env { class type; };
 
@@ -64,28 +68,45 @@ namespace rod
 		template<typename T>
 		using env_for_t = typename env<env_of_t<T>>::type;
 
-		template<typename State, typename Res, typename Acc, typename Rcv>
-		struct operation_base<State, Res, Acc, Rcv>::type : empty_base<State>, empty_base<Acc>, empty_base<Rcv>
+		/* Result slot of a single child operation. Every child owns its slot, so values are stored without synchronization and reduced once all children have completed. */
+		template<typename Snd, typename Env>
+		using slot_t = value_types_of_t<Snd, Env, _detail::decayed_tuple, _detail::bind_front<std::variant, std::monostate>::template type>;
+
+		template<typename... Errs>
+		using make_error_data = std::variant<std::tuple<set_error_t, std::decay_t<Errs>>...>;
+		template<typename... Errs>
+		using make_error_signs = completion_signatures<set_error_t(std::decay_t<Errs>)...>;
+
+		template<typename Snd, typename Policy, typename Env>
+		using is_nothrow_reduce = std::conjunction<value_types_of_t<Snd, Env, _detail::all_nothrow_decay_copyable, std::conjunction>, std::bool_constant<Policy::template is_nothrow<Snd, Env>>>;
+
+		template<typename Snd, typename Policy, typename Env>
+		using make_data = unique_tuple_t<_detail::concat_tuples_t<std::variant<std::tuple<set_stopped_t>>, error_types_of_t<Snd, Env, make_error_data>,
+				std::conditional_t<is_nothrow_reduce<Snd, Policy, Env>::value, std::variant<>, std::variant<std::tuple<set_error_t, std::exception_ptr>>>>>;
+		template<typename Snd, typename Policy, typename Env>
+		using make_signs = unique_tuple_t<_detail::concat_tuples_t<typename Policy::template value_signs<Snd, Env>, completion_signatures<set_stopped_t()>, error_types_of_t<Snd, Env, make_error_signs>,
+				std::conditional_t<is_nothrow_reduce<Snd, Policy, Env>::value, completion_signatures<>, completion_signatures<set_error_t(std::exception_ptr)>>>>;
+
+		template<typename Snd, typename Policy, typename Rcv>
+		struct operation_base<Snd, Policy, Rcv>::type : empty_base<Policy>, empty_base<Rcv>
 		{
 			using stop_cb_t = std::optional<stop_callback_for_t<stop_token_of_t<env_of_t<Rcv> &>, stop_trigger>>;
-			using state_base = empty_base<State>;
-			using acc_base = empty_base<Acc>;
+			using slot_t = _accumulate::slot_t<Snd, env_for_t<Rcv>>;
+			using data_t = make_data<Snd, Policy, env_for_t<Rcv>>;
+			using policy_base = empty_base<Policy>;
 			using rcv_base = empty_base<Rcv>;
 
-			template<typename Res2, typename Acc2>
-			constexpr type(Res2 &&res, Acc2 &&acc, Rcv &&rcv, std::size_t count) noexcept(std::is_nothrow_constructible_v<State, std::tuple<set_value_t, Res>> && std::is_nothrow_constructible_v<Acc, Acc2> && std::is_nothrow_move_constructible_v<Rcv>)
-					: state_base(std::tuple<set_value_t, Res>(set_value_t{}, std::forward<Res2>(res))), acc_base(std::forward<Acc2>(acc)), rcv_base(std::forward<Rcv>(rcv)), count(count) {}
+			template<typename Policy2>
+			constexpr type(Policy2 &&policy, Rcv &&rcv, std::size_t count) noexcept(std::is_nothrow_constructible_v<Policy, Policy2> && std::is_nothrow_move_constructible_v<Rcv>)
+					: policy_base(std::forward<Policy2>(policy)), rcv_base(std::forward<Rcv>(rcv)), count(count) {}
 
 			template<typename... Args>
-			void set_value(Args &&...args) noexcept
+			void set_value(slot_t &slot, Args &&...args) noexcept
 			{
-				if (status.load(std::memory_order_acquire) != status_t::running)
-					return;
-
-				if constexpr (!noexcept(emplace_value(std::forward<Args>(args)...)))
-					try { emplace_value(std::forward<Args>(args)...); } catch (...) { set_error(std::current_exception()); }
+				if constexpr (!_detail::all_nothrow_decay_copyable<Args...>::value)
+					try { slot.template emplace<_detail::decayed_tuple<Args...>>(std::forward<Args>(args)...); } catch (...) { set_error(std::current_exception()); }
 				else
-					emplace_value(std::forward<Args>(args)...);
+					slot.template emplace<_detail::decayed_tuple<Args...>>(std::forward<Args>(args)...);
 			}
 			template<typename Err>
 			void set_error(Err &&err) noexcept
@@ -94,7 +115,7 @@ namespace rod
 					return;
 
 				stop_src.request_stop();
-				if constexpr (!noexcept(emplace_error(std::forward<Err>(err))))
+				if constexpr (!_detail::nothrow_decay_copyable<Err>::value)
 					try { emplace_error(std::forward<Err>(err)); } catch (...) { emplace_error(std::current_exception()); }
 				else
 					emplace_error(std::forward<Err>(err));
@@ -102,10 +123,7 @@ namespace rod
 			void set_stopped() noexcept
 			{
 				if (auto expected = status_t::running; status.compare_exchange_strong(expected, status_t::stopped, std::memory_order_acq_rel))
-				{
 					stop_src.request_stop();
-					state_base::value().template emplace<std::tuple<set_stopped_t>>(set_stopped_t{});
-				}
 			}
 
 			void submit() noexcept
@@ -117,24 +135,26 @@ namespace rod
 			{
 				stop_cb.reset();
 
-				/* By this point all children have submitted. */
-				std::visit([&](auto &tpl) { std::apply([&](auto c, auto &...args) { c(std::move(rcv_base::value()), std::move(args)...); }, tpl); }, state_base::value());
+				/* By this point all children have submitted, so the slots are only accessed by this thread. */
+				if (status.load(std::memory_order_acquire) == status_t::running)
+				{
+					if constexpr (!is_nothrow_reduce<Snd, Policy, env_for_t<Rcv>>::value)
+						try { policy_base::value().reduce(std::move(rcv_base::value()), slots); } catch (...) { rod::set_error(std::move(rcv_base::value()), std::current_exception()); }
+					else
+						policy_base::value().reduce(std::move(rcv_base::value()), slots);
+				}
+				else
+				{
+					auto &rcv = rcv_base::value();
+					std::visit([&](auto &tpl) { std::apply([&](auto c, auto &...args) { c(std::move(rcv), std::move(args)...); }, tpl); }, data);
+				}
 			}
 
-			template<typename... Args>
-			constexpr void emplace_value(Args &&...args) noexcept(_detail::nothrow_decay_copyable<Res>::value && std::is_nothrow_invocable_v<Acc, std::add_lvalue_reference_t<Res>, Args...>)
-			{
-				static_assert(std::invocable<Acc, std::add_lvalue_reference_t<Res>, Args...>, "Accumulator must be invocable with result type and source senders' value types");
-				static_assert(std::assignable_from<std::add_lvalue_reference_t<Res>, std::invoke_result_t<Acc, std::add_lvalue_reference_t<Res>, Args...>>, "Result type must be assignable from the accumuilator's return type");
-
-				decltype(auto) value = std::get<1>(std::get<std::tuple<set_value_t, Res>>(state_base::value()));
-				value = std::invoke(acc_base::value(), value, std::forward<Args>(args)...);
-			}
 			template<typename Err>
 			constexpr void emplace_error(Err &&err) noexcept(_detail::nothrow_decay_copyable<Err>::value)
 			{
-				static_assert(requires { state_base::value().template emplace<std::tuple<set_error_t, std::decay_t<Err>>>(set_error_t{}, std::forward<Err>(err)); });
-				state_base::value().template emplace<std::tuple<set_error_t, std::decay_t<Err>>>(set_error_t{}, std::forward<Err>(err));
+				static_assert(requires { data.template emplace<std::tuple<set_error_t, std::decay_t<Err>>>(set_error_t{}, std::forward<Err>(err)); });
+				data.template emplace<std::tuple<set_error_t, std::decay_t<Err>>>(set_error_t{}, std::forward<Err>(err));
 			}
 
 			std::atomic<status_t> status = status_t::running;
@@ -142,47 +162,29 @@ namespace rod
 
 			in_place_stop_source stop_src = {};
 			stop_cb_t stop_cb = {};
-		};
-
-		template<typename... Errs>
-		using make_error_state = std::variant<std::tuple<set_error_t, std::decay_t<Errs>>...>;
-		template<typename... Errs>
-		using make_error_signs = completion_signatures<set_error_t(std::decay_t<Errs>)...>;
-
-		template<typename Snd, typename Res, typename Acc, typename Env>
-		using make_sender_state = unique_tuple_t<_detail::concat_tuples<std::variant<std::tuple<set_value_t, Res>, std::tuple<set_stopped_t>>, error_types_of_t<Snd, Env, make_error_state>>>;
-		template<typename Snd, typename Res, typename Acc, typename Env>
-		using make_sender_signs = unique_tuple_t<_detail::concat_tuples<completion_signatures<set_value_t(Res), set_stopped_t()>, error_types_of_t<Snd, Env, make_error_signs>>>;
 
-		template<typename Snd, typename Res, typename Acc, typename Env>
-		using is_non_throwing_accum = value_types_of_t<Snd, Env, _detail::bind_front<std::is_nothrow_invocable, Acc, Res>::template type, std::conjunction>;
-		template<typename Snd, typename Res, typename Acc, typename Env>
-		using is_non_throwing_state = _detail::apply_tuple_list_t<_detail::all_nothrow_decay_copyable, make_sender_state<Snd, Res, Acc, Env>>;
-
-		template<typename Snd, typename Res, typename Acc, typename Env>
-		using make_accum_state = std::conditional_t<is_non_throwing_accum<Res, Acc, Snd, Env>::value && is_non_throwing_state<Res, Acc, Snd, Env>::value, std::variant<>, std::variant<std::tuple<set_error_t, std::exception_ptr>>>;
-		template<typename Snd, typename Res, typename Acc, typename Env>
-		using make_accum_signs = std::conditional_t<is_non_throwing_accum<Res, Acc, Snd, Env>::value && is_non_throwing_state<Res, Acc, Snd, Env>::value, completion_signatures<>, completion_signatures<set_error_t(std::exception_ptr)>>;
-
-		template<typename Snd, typename Res, typename Acc, typename Env>
-		using make_state = unique_tuple_t<_detail::concat_tuples<make_sender_state<Snd, Res, Acc, Env>, make_accum_state<Snd, Res, Acc, Env>>>;
-		template<typename Snd, typename Res, typename Acc, typename Env>
-		using make_signs = unique_tuple_t<_detail::concat_tuples<make_sender_signs<Snd, Res, Acc, Env>, make_accum_signs<Snd, Res, Acc, Env>>>;;
+			std::span<slot_t> slots = {};
+			data_t data = std::tuple<set_stopped_t>{};
+		};
 
-		template<typename Rng, typename Res, typename Acc, typename Rcv>
-		class receiver<Rng, Res, Acc, Rcv>::type
+		template<typename Snd, typename Policy, typename Rcv>
+		class receiver<Snd, Policy, Rcv>::type
 		{
-			using operation_base = typename operation_base<make_state<std::ranges::range_value_t<Rng>, Res, Acc, Rcv>, Res, Acc, Rcv>::type;
+			using operation_base = typename operation_base<Snd, Policy, Rcv>::type;
+			using slot_t = typename operation_base::slot_t;
+
+		public:
+			using is_receiver = std::true_type;
 
 		public:
-			constexpr explicit type(operation_base *op) noexcept : _op(op) {}
+			constexpr explicit type(operation_base *op, slot_t *slot) noexcept : _op(op), _slot(slot) {}
 
 			friend constexpr env_for_t<Rcv> tag_invoke(get_env_t, const type &r) noexcept(_detail::nothrow_callable<get_env_t, const Rcv &>) { return env_for_t<Rcv>(get_env(r._op->rcv_base::value()), r._op->stop_src.get_token()); }
 
 			template<typename... Args>
 			friend void tag_invoke(set_value_t, type &&r, Args &&...args) noexcept
 			{
-				r._op->set_value(std::forward<Args>(args)...);
+				r._op->set_value(*r._slot, std::forward<Args>(args)...);
 				r._op->submit();
 			}
 			template<typename Err>
@@ -199,66 +201,58 @@ namespace rod
 
 		private:
 			operation_base *_op = {};
+			slot_t *_slot = {};
 		};
 
-		template<typename Rng, typename T>
-		struct select_allocator { using type = std::allocator<T>; };
-		template<typename Rng, typename T>
-		struct select_range { using type = std::vector<T, typename select_allocator<Rng, T>::type>; };
-
 		template<typename Rng>
 		concept has_allocator = requires(Rng rng) { typename std::decay_t<Rng>::allocator_type; rng.get_allocator(); };
-		template<typename Rng>
-		concept is_tuple_like = requires(Rng rng) { typename std::tuple_size<std::decay_t<Rng>>; std::get<0>(rng); };
-
-		template<typename Rng, typename T> requires has_allocator<Rng>
-		struct select_allocator<Rng, T> { using type = typename std::allocator_traits<typename std::decay_t<Rng>::allocator_type>::template rebind_alloc<T>; };
-		template<typename Rng, typename T> requires is_tuple_like<Rng>
-		struct select_range<Rng, T> { using type = std::array<T, std::tuple_size_v<std::decay_t<Rng>>>; };
 
-		template<typename Rng, typename Res, typename Acc, typename Rcv>
-		class operation<Rng, Res, Acc, Rcv>::type : operation_base<make_state<std::ranges::range_value_t<Rng>, Res, Acc, Rcv>, Res, Acc, Rcv>::type
+		/* Child operations are allocated using the allocator of the receiver's environment if it provides one, since it is explicitly requested
+		 * for the operation. Otherwise, the allocator of the source range is used if it has one, falling back to `std::allocator`. */
+		template<typename Rng, typename Rcv>
+		[[nodiscard]] constexpr auto select_allocator(const Rng &rng, const Rcv &rcv) noexcept
 		{
-			using operation_base = typename operation_base<make_state<std::ranges::range_value_t<Rng>, Res, Acc, Rcv>, Res, Acc, Rcv>::type;
-			using receiver_t = typename receiver<Rng, Res, Acc, Rcv>::type;
+			if constexpr (_detail::callable<get_allocator_t, const env_of_t<Rcv> &>)
+				return get_allocator(get_env(rcv));
+			else if constexpr (has_allocator<Rng>)
+				return rng.get_allocator();
+			else
+				return std::allocator<std::byte>();
+		}
+
+		template<typename Rng, typename Policy, typename Rcv>
+		class operation<Rng, Policy, Rcv>::type : operation_base<copy_cvref_t<Rng, std::ranges::range_value_t<Rng>>, Policy, Rcv>::type
+		{
+			using sender_t = copy_cvref_t<Rng, std::ranges::range_value_t<Rng>>;
+			using operation_base = typename operation_base<sender_t, Policy, Rcv>::type;
+			using receiver_t = typename receiver<sender_t, Policy, Rcv>::type;
+			using state_t = connect_result_t<sender_t, receiver_t>;
+			using slot_t = typename operation_base::slot_t;
 
-			using sender_state = typename select_range<Rng, connect_result_t<std::ranges::range_value_t<Rng>, receiver_t>>::type;
-			using result_state = make_state<std::ranges::range_value_t<Rng>, Res, Acc, Rcv>;
+			/* Child operations and their result slots are placed within a single allocation of blocks, which are aligned for both. */
+			struct alignas(std::max(alignof(state_t), alignof(slot_t))) block_t { std::byte data[std::max(alignof(state_t), alignof(slot_t))]; };
 
-			template<typename Rng2>
-			static constexpr sender_state connect_rng(operation_base *op, Rng2 &&rng)
-			{
-				auto state = sender_state();
-				state.reserve(std::ranges::size(rng));
-				for (decltype(auto) snd : rng)
-				{
-					const auto connect_snd = [&]() { return _detail::eval_t{[&]() { return connect(std::forward<decltype(snd)>(snd), receiver_t(op)); }}; };
-					state.emplace_back(connect_snd());
-				}
-				return state;
-			}
-			template<std::size_t... Is, typename Rng2>
-			static constexpr sender_state connect_tpl(operation_base *op, Rng2 &&rng, std::index_sequence<Is>...)
-			{
-				const auto connect_snd = [&]<std::size_t I>(std::in_place_index_t<I>) { return _detail::eval_t{[&]() { return connect(std::get<I>(std::forward<Rng2>(rng)), op); }}; };
-				return sender_state{connect_snd(std::in_place_index_t<Is>())...};
-			}
-			template<typename Rng2>
-			static constexpr sender_state connect_all(operation_base *op, Rng2 &&rng) noexcept(_detail::nothrow_callable<connect_t, copy_cvref_t<Rng2, std::ranges::range_value_t<Rng>>, receiver_t> && is_tuple_like<Rng>)
+			using alloc_t = typename std::allocator_traits<decltype(select_allocator(std::declval<const std::remove_cvref_t<Rng> &>(), std::declval<const Rcv &>()))>::template rebind_alloc<block_t>;
+			using alloc_traits = std::allocator_traits<alloc_t>;
+
+			[[nodiscard]] static constexpr std::size_t slots_offset(std::size_t n) noexcept
 			{
-				if constexpr (is_tuple_like<Rng>)
-					return connect_tpl(op, std::forward<Rng2>(rng), std::make_index_sequence<std::tuple_size_v<Rng>>());
-				else
-					return connect_rng(op, std::forward<Rng2>(rng));
+				const auto bytes = n * sizeof(state_t);
+				return bytes + (alignof(slot_t) - bytes % alignof(slot_t)) % alignof(slot_t);
 			}
+			[[nodiscard]] static constexpr std::size_t blocks_size(std::size_t n) noexcept { return (slots_offset(n) + n * sizeof(slot_t) + sizeof(block_t) - 1) / sizeof(block_t); }
 
 		public:
 			type(type &&) = delete;
 			type &operator=(type &&) = delete;
 
-			template<typename Rng2, typename Res2, typename Acc2>
-			constexpr explicit type(Rng2 &&rng, Res2 &&res, Acc2 &&acc, Rcv &&rcv) noexcept(std::is_nothrow_constructible_v<operation_base, Res2, Acc2, Rcv, std::size_t> && noexcept(connect_all(this, std::forward<Rng2>(rng))))
-					: operation_base(std::forward<Res2>(res), std::forward<Acc2>(acc), std::forward<Rcv>(rcv), std::ranges::size(rng)), _state(connect_all(this, std::forward<Rng2>(rng))) {}
+			template<typename Rng2, typename Policy2>
+			constexpr explicit type(Rng2 &&rng, Policy2 &&policy, Rcv &&rcv) : operation_base(std::forward<Policy2>(policy), std::forward<Rcv>(rcv), std::ranges::size(rng)), _alloc(select_allocator(rng, operation_base::rcv_base::value()))
+			{
+				if (const auto n = std::ranges::size(rng); n != 0)
+					connect_all(std::forward<Rng2>(rng), n);
+			}
+			~type() { destroy(_size); }
 
 			friend void tag_invoke(start_t, type &op) noexcept
 			{
@@ -266,55 +260,145 @@ namespace rod
 					op.stop_cb.emplace(get_stop_token(get_env(op.rcv_base::value())), stop_trigger{op.stop_src});
 
 				if (op.stop_src.stop_requested()) [[unlikely]]
-					set_stopped(std::move(op.rcv_base::value()));
-				else if (!std::ranges::empty(op._state))
-					std::ranges::for_each(op._state, [](auto &st) noexcept { start(st); });
+				{
+					op.stop_cb.reset();
+					rod::set_stopped(std::move(op.rcv_base::value()));
+				}
+				else if (op._size != 0)
+					start_all(std::span<state_t>(op.states(), op._size));
 				else
 					op.complete();
 			}
 
 		private:
-			sender_state _state;
+			[[nodiscard]] state_t *states() const noexcept { return reinterpret_cast<state_t *>(std::to_address(_blocks)); }
+			[[nodiscard]] slot_t *slots(std::size_t n) const noexcept { return reinterpret_cast<slot_t *>(reinterpret_cast<std::byte *>(std::to_address(_blocks)) + slots_offset(n)); }
+
+			template<typename Rng2>
+			void connect_all(Rng2 &&rng, std::size_t n)
+			{
+				_blocks = alloc_traits::allocate(_alloc, blocks_size(n));
+				_capacity = n;
+
+				/* Slots are constructed up-front, since receivers of the child operations reference them. */
+				const auto slot_ptr = slots(n);
+				std::uninitialized_value_construct_n(slot_ptr, n);
+				operation_base::slots = std::span<slot_t>(slot_ptr, n);
+
+				try
+				{
+					for (auto state_ptr = states(); auto &&snd : rng)
+					{
+						std::construct_at(state_ptr + _size, _detail::eval_t{[&]() { return connect(static_cast<sender_t &&>(snd), receiver_t(this, slot_ptr + _size)); }});
+						++_size;
+					}
+				}
+				catch (...)
+				{
+					destroy(_size);
+					throw;
+				}
+			}
+			void destroy(std::size_t n) noexcept
+			{
+				if (!_blocks) return;
+
+				std::destroy_n(states(), n);
+				std::destroy_n(operation_base::slots.data(), _capacity);
+				alloc_traits::deallocate(_alloc, std::exchange(_blocks, {}), blocks_size(_capacity));
+			}
+
+			ROD_NO_UNIQUE_ADDRESS alloc_t _alloc;
+			typename alloc_traits::pointer _blocks = {};
+			std::size_t _capacity = 0;
+			std::size_t _size = 0;
 		};
 
-		template<typename Rng, typename Res, typename Acc>
-		class sender<Rng, Res, Acc>::type : empty_base<Rng>, empty_base<Res>, empty_base<Acc>
+		template<typename Rng, typename Policy>
+		class sender<Rng, Policy>::type : empty_base<Rng>, empty_base<Policy>
 		{
 			using rng_base = empty_base<Rng>;
-			using res_base = empty_base<Res>;
-			using acc_base = empty_base<Acc>;
+			using policy_base = empty_base<Policy>;
 
 			template<typename T, typename Env>
-			using signs_t = make_signs<copy_cvref_t<T, std::ranges::range_value_t<Rng>>, Res, Acc, Env>;
-			template<typename T, typename Rcv>
-			using operation_t = typename operation<copy_cvref_t<T, Rng>, Res, Acc, Rcv>::type;
+			using signs_t = make_signs<copy_cvref_t<copy_cvref_t<T, Rng>, std::ranges::range_value_t<Rng>>, Policy, typename env<Env>::type>;
 			template<typename T, typename Rcv>
-			using receiver_t = typename receiver<copy_cvref_t<T, Rng>, Res, Acc, Rcv>::type;
+			using operation_t = typename operation<copy_cvref_t<T, Rng>, Policy, Rcv>::type;
 
 		public:
 			using is_sender = std::true_type;
 
 		public:
-			template<typename Rng2, typename Res2, typename Acc2>
-			constexpr explicit type(Rng2 &&rng, Res2 &&res, Acc2 &&acc) noexcept(std::is_nothrow_constructible_v<Rng, Rng2> && std::is_nothrow_constructible_v<Res, Res2> && std::is_nothrow_constructible_v<Acc, Acc2>)
-					: rng_base(std::forward<Rng2>(rng)), res_base(std::forward<Res2>(res)), acc_base(std::forward<Acc2>(acc)) {}
+			template<typename Rng2, typename Policy2>
+			constexpr explicit type(Rng2 &&rng, Policy2 &&policy) noexcept(std::is_nothrow_constructible_v<Rng, Rng2> && std::is_nothrow_constructible_v<Policy, Policy2>)
+					: rng_base(std::forward<Rng2>(rng)), policy_base(std::forward<Policy2>(policy)) {}
 
 		public:
-			friend constexpr empty_env tag_invoke(get_env_t, const type &s) noexcept { return {}; }
+			friend constexpr empty_env tag_invoke(get_env_t, const type &) noexcept { return {}; }
 			template<decays_to_same<type> T, typename Env>
 			friend constexpr signs_t<T, Env> tag_invoke(get_completion_signatures_t, T &&, Env) noexcept { return {}; }
 
 			template<decays_to_same<type> T, rod::receiver Rcv> requires receiver_of<Rcv, signs_t<T, env_of_t<Rcv>>>
-			friend constexpr operation_t<T, Rcv> tag_invoke(connect_t, T &&s, Rcv rcv) noexcept(std::is_nothrow_constructible_v<operation_t<T, Rcv>, copy_cvref_t<T, Rng>, Rcv>)
+			friend constexpr operation_t<T, Rcv> tag_invoke(connect_t, T &&s, Rcv rcv)
+			{
+				return operation_t<T, Rcv>(std::forward<T>(s).rng_base::value(), std::forward<T>(s).policy_base::value(), std::move(rcv));
+			}
+		};
+
+		/* Reduction policy used by `accumulate`, which folds the values of child operations in the order of the source range. */
+		template<typename Res, typename Acc>
+		class fold<Res, Acc>::type : empty_base<Res>, empty_base<Acc>
+		{
+			using res_base = empty_base<Res>;
+			using acc_base = empty_base<Acc>;
+
+			template<typename... Args>
+			using is_nothrow_accum = std::conjunction<std::is_nothrow_invocable<Acc &, Res &, std::decay_t<Args>...>, std::is_nothrow_assignable<Res &, std::invoke_result_t<Acc &, Res &, std::decay_t<Args>...>>>;
+
+		public:
+			template<typename Snd, typename Env>
+			using value_signs = completion_signatures<set_value_t(Res)>;
+			template<typename Snd, typename Env>
+			static constexpr bool is_nothrow = std::is_nothrow_move_constructible_v<Res> && value_types_of_t<Snd, Env, is_nothrow_accum, std::conjunction>::value;
+
+		public:
+			template<typename Res2, typename Acc2>
+			constexpr explicit type(Res2 &&res, Acc2 &&acc) noexcept(std::is_nothrow_constructible_v<Res, Res2> && std::is_nothrow_constructible_v<Acc, Acc2>)
+					: res_base(std::forward<Res2>(res)), acc_base(std::forward<Acc2>(acc)) {}
+
+			template<typename Rcv, typename Slot>
+			void reduce(Rcv &&rcv, std::span<Slot> slots)
 			{
-				return operation_t<T, Rcv>(std::forward<T>(s).rng_base::value(), std::forward<T>(s).res_base::value(), std::forward<T>(s).acc_base::value(), std::move(rcv));
+				for (auto &slot : slots) fold_slot(slot);
+				rod::set_value(std::forward<Rcv>(rcv), std::move(res_base::value()));
+			}
+
+		private:
+			template<typename Slot>
+			constexpr void fold_slot(Slot &slot)
+			{
+				auto &res = res_base::value();
+				auto &acc = acc_base::value();
+				std::visit([&]<typename T>(T &vals)
+				{
+					if constexpr (!std::same_as<T, std::monostate>)
+						std::apply([&]<typename... Args>(Args &...args)
+						{
+							static_assert(std::invocable<Acc &, Res &, Args...>, "Accumulator must be invocable with result type and source senders' value types");
+							static_assert(std::assignable_from<Res &, std::invoke_result_t<Acc &, Res &, Args...>>, "Result type must be assignable from the accumulator's return type");
+
+							res = std::invoke(acc, res, std::move(args)...);
+						}, vals);
+				}, slot);
 			}
 		};
 
-		struct accumulate_t
+		class accumulate_t
 		{
+			template<typename Res, typename Acc>
+			using fold_t = typename fold<std::decay_t<Res>, std::decay_t<Acc>>::type;
 			template<typename Rng, typename Res, typename Acc>
-			using sender_t = typename sender<Rng, std::decay_t<Res>, std::decay_t<Acc>>::type;
+			using sender_t = typename sender<Rng, fold_t<Res, Acc>>::type;
 
 		public:
 			template<std::ranges::sized_range Rng, movable_value Res, movable_value Acc> requires tag_invocable<accumulate_t, Rng, Res, Acc>
@@ -323,15 +407,20 @@ namespace rod
 				return tag_invoke(*this, std::forward<Rng>(rng), std::forward<Res>(res), std::forward<Acc>(acc));
 			}
 			template<std::ranges::sized_range Rng, movable_value Res, movable_value Acc> requires(!tag_invocable<accumulate_t, Rng, Res, Acc>)
-			[[nodiscard]] constexpr sender_t<Rng, Res, Acc> operator()(Rng &&rng, Res &&res, Acc &&acc) const noexcept(std::is_nothrow_constructible_v<sender_t<Rng, Res, Acc>, Rng, Res, Acc>)
+			[[nodiscard]] constexpr sender_t<Rng, Res, Acc> operator()(Rng &&rng, Res &&res, Acc &&acc) const noexcept(std::is_nothrow_constructible_v<sender_t<Rng, Res, Acc>, Rng, fold_t<Res, Acc>> && std::is_nothrow_constructible_v<fold_t<Res, Acc>, Res, Acc>)
 			{
-				return sender_t<Rng, Res, Acc>(std::forward<Rng>(rng), std::forward<Res>(res), std::forward<Acc>(acc));
+				return sender_t<Rng, Res, Acc>(std::forward<Rng>(rng), fold_t<Res, Acc>(std::forward<Res>(res), std::forward<Acc>(acc)));
 			}
 		};
 	}
 
 	using _accumulate::accumulate_t;
 
-	/* TODO: Document usage. */
+	/** Customization point object used to start all senders of a sized range and fold their value results.
+	 * @param rng Sized range of senders to start. All senders are connected within a single allocation, using the allocator of the receiver's environment if it provides one, or the allocator of \a rng if it has one otherwise.
+	 * @param res Initial value of the result.
+	 * @param acc Accumulator invoked as `res = acc(res, vals...)` with values of every sender, in the order of \a rng.
+	 * @return Sender completing with the accumulated result once all senders of \a rng complete, or with the first error or stop completion.
+	 * @note Values of the senders are stored separately and accumulated once all senders have completed, so the accumulator is never invoked concurrently. */
 	inline constexpr auto accumulate = accumulate_t{};
 }
\ No newline at end of file
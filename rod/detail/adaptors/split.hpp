@@ -7,6 +7,7 @@
 #include <optional>
 
 #include "../../stop_token.hpp"
+#include "../queries/allocator.hpp"
 #include "../shared_ref.hpp"
 #include "../async_base.hpp"
 #include "closure.hpp"
@@ -31,6 +32,14 @@ namespace rod
 		template<typename>
 		struct env { class type; };
 
+		struct deleter
+		{
+			template<typename State>
+			void operator()(State *state) const noexcept { _detail::delete_with_allocator(state->alloc, state); }
+		};
+		template<typename State>
+		using shared_handle_t = _detail::shared_handle<State, deleter>;
+
 		struct operation_base
 		{
 			using notify_func = void(operation_base *) noexcept;
@@ -94,6 +103,7 @@ namespace rod
 			using receiver_t = typename receiver<Snd, Env>::type;
 			using state_t = connect_result_t<Snd, receiver_t>;
 			using env_t = typename env<Env>::type;
+			using alloc_t = _detail::env_allocator_t<Env>;
 
 			using values_list = _detail::gather_signatures_t<set_value_t, Snd, env_t, _detail::bind_front<_detail::decayed_tuple, set_value_t>::template type, type_list_t>;
 			using errors_list = _detail::gather_signatures_t<set_error_t, Snd, env_t, _detail::bind_front<_detail::decayed_tuple, set_error_t>::template type, type_list_t>;
@@ -101,7 +111,7 @@ namespace rod
 			using bind_data = typename _detail::bind_front<std::variant, std::tuple<set_stopped_t>, std::tuple<set_error_t, std::exception_ptr>>::template type<Ts...>;
 			using data_t = unique_tuple_t<_detail::apply_tuple_list_t<bind_data, _detail::concat_tuples_t<values_list, errors_list>>>;
 
-			constexpr type(Snd &&snd) : empty_base<Env>(get_env(snd)), state(connect(std::forward<Snd>(snd), receiver_t(this))) {}
+			constexpr type(Snd &&snd) : empty_base<Env>(get_env(snd)), alloc(_detail::allocator_from(env())), state(connect(std::forward<Snd>(snd), receiver_t(this))) {}
 
 			[[nodiscard]] constexpr decltype(auto) env() noexcept { return empty_base<Env>::value(); }
 			[[nodiscard]] constexpr decltype(auto) env() const noexcept { return empty_base<Env>::value(); }
@@ -118,6 +128,7 @@ namespace rod
 				}
 			}
 
+			ROD_NO_UNIQUE_ADDRESS alloc_t alloc;
 			in_place_stop_source stop_src;
 			state_t state;
 
@@ -160,7 +171,7 @@ namespace rod
 			type(type &&) = delete;
 			type &operator=(type &&) = delete;
 
-			constexpr explicit type(Rcv &&rcv, _detail::shared_handle<shared_state_t> handle) noexcept(std::is_nothrow_move_constructible_v<Rcv>)
+			constexpr explicit type(Rcv &&rcv, shared_handle_t<shared_state_t> handle) noexcept(std::is_nothrow_move_constructible_v<Rcv>)
 					: operation_base{{}, notify_complete}, empty_base<Rcv>(std::forward<Rcv>(rcv)), _state(std::move(handle)) {}
 
 			friend constexpr void tag_invoke(start_t, type &op) noexcept { op.start(); }
@@ -200,7 +211,7 @@ namespace rod
 				}
 			}
 
-			_detail::shared_handle<shared_state_t> _state;
+			shared_handle_t<shared_state_t> _state;
 			stop_cb_t _stop_cb = {};
 		};
 
@@ -224,15 +235,18 @@ namespace rod
 			using signs_t = make_completion_signatures<copy_cvref_t<T, Snd>, env_t, completion_signatures<set_error_t(std::exception_ptr), set_stopped_t()>, value_signs_t, error_signs_t>;
 
 		public:
-			constexpr explicit type(Snd &&snd) : _state(new shared_state_t{std::forward<Snd>(snd)}) {}
+			constexpr explicit type(Snd &&snd) : _state(make_state(std::forward<Snd>(snd))) {}
 
 			template<decays_to_same<type> T, typename E>
 			friend constexpr signs_t<T> tag_invoke(get_completion_signatures_t, T &&, E) noexcept { return {}; }
 			template<decays_to_same<type> T, receiver_of<signs_t<T>> Rcv>
-			friend constexpr operation_t<Rcv> tag_invoke(connect_t, T &&s, Rcv rcv) noexcept(std::is_nothrow_constructible_v<operation_t<Rcv>, Rcv, _detail::shared_handle<shared_state_t>>) { return operation_t<Rcv>{std::move(rcv), s._state}; }
+			friend constexpr operation_t<Rcv> tag_invoke(connect_t, T &&s, Rcv rcv) noexcept(std::is_nothrow_constructible_v<operation_t<Rcv>, Rcv, shared_handle_t<shared_state_t>>) { return operation_t<Rcv>{std::move(rcv), s._state}; }
 
 		private:
-			_detail::shared_handle<shared_state_t> _state;
+			/* Shared state is allocated using the allocator of the adapted sender's environment, which is also used as the environment of the child operation. */
+			static shared_state_t *make_state(Snd &&snd) { return _detail::new_with_allocator<shared_state_t>(_detail::allocator_from(get_env(snd)), std::forward<Snd>(snd)); }
+
+			shared_handle_t<shared_state_t> _state;
 		};
 
 		class split_t
@@ -270,6 +284,6 @@ namespace rod
 	/** Customization point object used to adapt a sender into a sender that can be connected multiple times.
 	 * @param snd Sender to adapt. If omitted, creates a pipe-able sender adaptor.
 	 * @return Sender wrapper for \a snd that can be connected multiple times.
-	 * @note Splitting a sender requires dynamic allocation of shared state. */
+	 * @note Splitting a sender requires dynamic allocation of shared state, which uses the allocator obtained via `get_allocator` from the environment of \a snd, or `std::allocator` if none is provided. */
 	inline constexpr auto split = split_t{};
 }
@@ -272,7 +272,7 @@ namespace rod
 				if (op.stop_src.stop_requested()) [[unlikely]]
 					set_stopped(std::move(op.rcv_base::value()));
 				else if constexpr (sizeof...(Snds) != 0)
-					std::apply([](auto &...ops) noexcept { (start(ops), ...); }, op._state);
+					std::apply([](auto &...ops) noexcept { start_all(ops...); }, op._state);
 				else
 					op.complete();
 			}
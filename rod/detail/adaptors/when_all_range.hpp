@@ -0,0 +1,90 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "accumulate.hpp"
+
+namespace rod
+{
+	namespace _when_all_range
+	{
+		template<typename... Ts>
+		struct collect_values { using type = std::vector<std::tuple<std::decay_t<Ts>...>>; };
+		template<typename T>
+		struct collect_values<T> { using type = std::vector<std::decay_t<T>>; };
+		template<>
+		struct collect_values<> { using type = void; };
+
+		template<typename... Ts>
+		using collect_values_t = typename collect_values<Ts...>::type;
+		template<typename Snd, typename Env>
+		using result_t = value_types_of_t<Snd, Env, collect_values_t, std::type_identity_t>;
+
+		template<typename T>
+		struct make_value_signs { using type = completion_signatures<set_value_t(T)>; };
+		template<>
+		struct make_value_signs<void> { using type = completion_signatures<set_value_t()>; };
+
+		/* Reduction policy used by `when_all_range`, which moves the values of child operations into a vector in the order of the source range. */
+		struct collect
+		{
+			template<typename Snd, typename Env>
+			using value_signs = typename make_value_signs<result_t<Snd, Env>>::type;
+			template<typename Snd, typename Env>
+			static constexpr bool is_nothrow = std::is_void_v<result_t<Snd, Env>>;
+
+			template<typename Rcv, typename... Ts>
+			void reduce(Rcv &&rcv, std::span<std::variant<std::monostate, std::tuple<Ts...>>> slots)
+			{
+				if constexpr (sizeof...(Ts) == 0)
+					rod::set_value(std::forward<Rcv>(rcv));
+				else
+				{
+					auto result = collect_values_t<Ts...>();
+					result.reserve(slots.size());
+
+					for (auto &slot : slots)
+					{
+						if constexpr (sizeof...(Ts) == 1)
+							result.emplace_back(std::get<0>(std::move(std::get<1>(slot))));
+						else
+							result.emplace_back(std::move(std::get<1>(slot)));
+					}
+					rod::set_value(std::forward<Rcv>(rcv), std::move(result));
+				}
+			}
+			template<typename Rcv>
+			void reduce(Rcv &&rcv, std::span<std::variant<std::monostate>>) { rod::set_value(std::forward<Rcv>(rcv)); }
+		};
+
+		class when_all_range_t
+		{
+			template<typename Rng>
+			using sender_t = typename _accumulate::sender<Rng, collect>::type;
+
+		public:
+			template<std::ranges::sized_range Rng> requires tag_invocable<when_all_range_t, Rng>
+			[[nodiscard]] constexpr rod::sender auto operator()(Rng &&rng) const noexcept(nothrow_tag_invocable<when_all_range_t, Rng>)
+			{
+				return tag_invoke(*this, std::forward<Rng>(rng));
+			}
+			template<std::ranges::sized_range Rng> requires(!tag_invocable<when_all_range_t, Rng>)
+			[[nodiscard]] constexpr sender_t<Rng> operator()(Rng &&rng) const noexcept(std::is_nothrow_constructible_v<sender_t<Rng>, Rng, collect>)
+			{
+				return sender_t<Rng>(std::forward<Rng>(rng), collect{});
+			}
+		};
+	}
+
+	using _when_all_range::when_all_range_t;
+
+	/** Customization point object used to start all senders of a sized range and wait for their completion.
+	 * @param rng Sized range of senders to start. All senders are connected within a single allocation, using the allocator of the receiver's environment if it provides one, or the allocator of \a rng if it has one otherwise.
+	 * @return Sender completing with an `std::vector` of values of all senders in the order of \a rng (or with no values if the senders complete with no values), or with the first error or stop completion.
+	 * @note Senders of \a rng must have at most one value completion signature. Values of senders with multiple values are stored as tuples. */
+	inline constexpr auto when_all_range = when_all_range_t{};
+}
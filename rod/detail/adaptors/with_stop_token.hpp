@@ -106,7 +106,7 @@ namespace rod
 			template<decays_to_same<type> T, typename Env>
 			friend constexpr signs_t<Env> tag_invoke(get_completion_signatures_t, T &&, Env) noexcept { return {}; }
 
-			template<decays_to_same<type> T, typename Rcv> requires sender_to<copy_cvref_t<T, Snd>, receiver_t<Rcv>, env_t<env_of_t<Rcv>>>
+			template<decays_to_same<type> T, rod::receiver Rcv> requires sender_to<copy_cvref_t<T, Snd>, receiver_t<Rcv>, env_t<env_of_t<Rcv>>>
 			friend constexpr auto tag_invoke(connect_t, T &&s, Rcv rcv) noexcept(std::is_nothrow_constructible_v<receiver_t<Rcv>, copy_cvref_t<T, Snd>, Rcv, copy_cvref_t<T, Snd>>)
 			{
 				return connect(std::forward<T>(s).snd_base::value(), receiver_t<Rcv>(std::move(rcv), std::forward<T>(s).tok_base::value()));
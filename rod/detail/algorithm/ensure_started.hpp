@@ -8,6 +8,7 @@
 
 #include "../adaptors/closure.hpp"
 #include "../../stop_token.hpp"
+#include "../queries/allocator.hpp"
 #include "../shared_ref.hpp"
 #include "../async_base.hpp"
 
@@ -34,6 +35,16 @@ namespace rod
 
 		struct operation_base { void (*_notify)(operation_base *) noexcept = {}; };
 
+		struct deleter
+		{
+			template<typename State>
+			void operator()(State *state) const noexcept { _detail::delete_with_allocator(state->alloc, state); }
+		};
+		template<typename Snd, typename Env>
+		struct shared_state;
+		template<typename Snd, typename Env>
+		using shared_handle_t = _detail::shared_handle<shared_state<Snd, Env>, deleter>;
+
 		template<typename Env>
 		class env<Env>::type
 		{
@@ -59,17 +70,18 @@ namespace rod
 			using receiver_t = typename receiver<Snd, Env>::type;
 			using state_t = connect_result_t<Snd, receiver_t>;
 			using env_t = typename env<Env>::type;
+			using alloc_t = _detail::env_allocator_t<Env>;
 
 			using value_data_t = _detail::gather_signatures_t<set_value_t, Snd, env_t, _detail::bind_front<_detail::decayed_tuple, set_value_t>::template type, std::variant>;
-			using error_data_t = _detail::gather_signatures_t<set_error_t, Snd, env_t, _detail::bind_front<_detail::decayed_tuple, set_value_t>::template type, std::variant>;
+			using error_data_t = _detail::gather_signatures_t<set_error_t, Snd, env_t, _detail::bind_front<_detail::decayed_tuple, set_error_t>::template type, std::variant>;
 			using data_t = unique_tuple_t<_detail::concat_tuples_t<std::variant<std::tuple<set_stopped_t>, std::tuple<set_error_t, std::exception_ptr>>, value_data_t, error_data_t>>;
 
-			constexpr shared_state(Snd &&snd) : empty_base<Env>(get_env(snd)), state2(connect(std::forward<Snd>(snd))) { start(state2); }
+			constexpr shared_state(Snd &&snd) : empty_base<Env>(get_env(snd)), alloc(_detail::allocator_from(env())), state2(connect_child(std::forward<Snd>(snd))) { start(state2); }
 
 			[[nodiscard]] constexpr decltype(auto) env() noexcept { return empty_base<Env>::value(); }
 			[[nodiscard]] constexpr decltype(auto) env() const noexcept { return empty_base<Env>::value(); }
 
-			inline auto connect(Snd &&) noexcept(_detail::nothrow_callable<connect_t, Snd, receiver_t>);
+			inline auto connect_child(Snd &&) noexcept(_detail::nothrow_callable<connect_t, Snd, receiver_t>);
 			void detach() noexcept { stop_src.request_stop(); }
 			void notify() noexcept
 			{
@@ -78,6 +90,7 @@ namespace rod
 					op->_notify(op);
 			}
 
+			ROD_NO_UNIQUE_ADDRESS alloc_t alloc;
 			data_t data = std::tuple<set_stopped_t>{};
 			in_place_stop_source stop_src = {};
 			std::atomic<void *> state1 = {};
@@ -93,7 +106,7 @@ namespace rod
 			using is_receiver = std::true_type;
 
 		public:
-			constexpr explicit type(_detail::shared_handle<shared_state<Snd, Env>> hnd) noexcept : _state(std::move(hnd)) {}
+			constexpr explicit type(shared_handle_t<Snd, Env> hnd) noexcept : _state(std::move(hnd)) {}
 
 			friend env_t tag_invoke(get_env_t, const type &r) noexcept { return env_t{r._state->stop_src.get_token(), &r._state->env()}; }
 			template<_detail::completion_channel C, typename... Args>
@@ -113,18 +126,19 @@ namespace rod
 				else
 					do_emplace();
 
+				/* Receiver is a member of the shared state, so the handle is moved out of it before the reference is released. */
+				const auto hnd = std::move(r._state);
 				state.notify();
-				r._state.reset();
 			}
 
 		private:
-			_detail::shared_handle<shared_state<Snd, Env>> _state;
+			shared_handle_t<Snd, Env> _state;
 		};
 
 		template<typename Snd, typename Env>
-		auto shared_state<Snd, Env>::connect(Snd &&snd) noexcept(_detail::nothrow_callable<connect_t, Snd, receiver_t>)
+		auto shared_state<Snd, Env>::connect_child(Snd &&snd) noexcept(_detail::nothrow_callable<connect_t, Snd, receiver_t>)
 		{
-			return connect(std::forward<Snd>(snd), receiver_t{static_cast<shared_state *>(this->acquire())});
+			return rod::connect(std::forward<Snd>(snd), receiver_t{static_cast<shared_state *>(this->acquire())});
 		}
 
 		template<typename Snd, typename Rcv, typename Env>
@@ -147,8 +161,8 @@ namespace rod
 			type(type &&) = delete;
 			type &operator=(type &&) = delete;
 
-			type(Rcv &&rcv, _detail::shared_handle<shared_state<Snd, Env>> handle) noexcept(std::is_nothrow_move_constructible_v<Rcv>)
-					: operation_base{notify_complete}, _state(std::move(handle)), empty_base<Rcv>(std::forward<Rcv>(rcv)) {}
+			type(Rcv &&rcv, shared_handle_t<Snd, Env> handle) noexcept(std::is_nothrow_move_constructible_v<Rcv>)
+					: operation_base{notify_complete}, empty_base<Rcv>(std::forward<Rcv>(rcv)), _state(std::move(handle)) {}
 			~type() { if (!_state->state1.load(std::memory_order_acquire)) _state->detach(); }
 
 			friend void tag_invoke(start_t, type &op) noexcept
@@ -158,16 +172,16 @@ namespace rod
 					op._notify(&op);
 				else
 				{
-					op._on_stop.emplace(get_stop_token(get_env(op._rcv)), stop_trigger{state.stop_src});
+					op._on_stop.emplace(get_stop_token(get_env(op.empty_base<Rcv>::value())), stop_trigger{state.stop_src});
 					if (state.stop_src.stop_requested())
-						set_stopped(std::move(op._rcv));
+						set_stopped(std::move(op.empty_base<Rcv>::value()));
 					else if (ptr = nullptr; !state.state1.compare_exchange_weak(ptr, &op, std::memory_order_release, std::memory_order_acquire))
 						op._notify(&op);
 				}
 			}
 
 		private:
-			_detail::shared_handle<shared_state<Snd, Env>> _state;
+			shared_handle_t<Snd, Env> _state;
 			stop_cb_t _on_stop = {};
 		};
 
@@ -190,9 +204,12 @@ namespace rod
 			using signs_t = make_completion_signatures<Snd, env_t, completion_signatures<set_error_t(std::exception_ptr &&)>, value_signs_t, error_signs_t>;
 
 		public:
-			constexpr explicit type(Snd snd) : _state(new shared_state<Snd, Env>{std::move(snd)}) {}
-			constexpr explicit type(_detail::shared_handle<shared_state<Snd, Env>> state) noexcept : _state(std::move(state)) {}
+			constexpr explicit type(Snd snd) : _state(make_state(std::move(snd))) {}
+			constexpr explicit type(shared_handle_t<Snd, Env> state) noexcept : _state(std::move(state)) {}
 
+			/* Sender is move-only, since destroying a copy would detach the operation shared with other copies. */
+			type(type &&) noexcept = default;
+			type &operator=(type &&) noexcept = default;
 			~type() { if (_state) _state->detach(); }
 
 			template<decays_to_same<type> T>
@@ -205,7 +222,10 @@ namespace rod
 			friend constexpr type tag_invoke(split_t, T &&s) noexcept { return type{std::forward(s)._state}; }
 
 		private:
-			_detail::shared_handle<shared_state<Snd, Env>> _state;
+			/* Shared state is allocated using the allocator of the adapted sender's environment, which is also used as the environment of the started operation. */
+			static shared_state<Snd, Env> *make_state(Snd &&snd) { return _detail::new_with_allocator<shared_state<Snd, Env>>(_detail::allocator_from(get_env(snd)), std::move(snd)); }
+
+			shared_handle_t<Snd, Env> _state;
 		};
 
 		class ensure_started_t
@@ -242,6 +262,7 @@ namespace rod
 
 	/** Eagerly starts execution of the passed sender and returns a sender for it's completion.
 	 * @param snd Sender to eagerly execute.
-	 * @return Sender that completes with the completion results of the eagerly-started operation. */
+	 * @return Sender that completes with the completion results of the eagerly-started operation.
+	 * @note Shared state of the started operation is allocated using the allocator obtained via `get_allocator` from the environment of \a snd, or `std::allocator` if none is provided. */
 	inline constexpr auto ensure_started = ensure_started_t{};
 }
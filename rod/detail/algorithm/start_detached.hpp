@@ -7,43 +7,67 @@
 #include <cassert>
 
 #include "../../stop_token.hpp"
-#include "../shared_ref.hpp"
+#include "../queries/allocator.hpp"
 #include "../async_base.hpp"
 
 namespace rod
 {
 	namespace _start_detached
 	{
-		template<typename Del, typename Snd>
+		template<typename Env>
+		struct state_base;
+		template<typename Env>
 		struct receiver { class type; };
-		template<typename Del, typename Snd>
-		class detached_state;
+		template<typename Alloc>
+		struct env { class type; };
 
-		template<typename Del, typename Snd>
-		class receiver<Del, Snd>::type
+		template<typename Alloc>
+		class env<Alloc>::type
 		{
-			using state_t = detached_state<Del, Snd>;
+		public:
+			constexpr explicit type(const Alloc &alloc) noexcept(std::is_nothrow_copy_constructible_v<Alloc>) : _alloc(alloc) {}
+
+			friend constexpr const Alloc &tag_invoke(get_allocator_t, const type &e) noexcept { return e._alloc; }
+
+		private:
+			ROD_NO_UNIQUE_ADDRESS Alloc _alloc;
+		};
+
+		template<typename Env>
+		struct state_base : empty_base<Env>
+		{
+			using notify_func = void(state_base *) noexcept;
+
+			template<typename... Args>
+			constexpr explicit state_base(notify_func *notify, Args &&...args) noexcept(std::is_nothrow_constructible_v<Env, Args...>) : empty_base<Env>(std::forward<Args>(args)...), notify(notify) {}
+
+			notify_func *notify;
+		};
+
+		template<typename Env>
+		class receiver<Env>::type
+		{
+			using state_t = state_base<Env>;
 
 		public:
 			using is_receiver = std::true_type;
 
 		public:
-			friend constexpr empty_env tag_invoke(get_env_t, const type &) noexcept { return {}; }
+			constexpr explicit type(state_t *state) noexcept : _state(state) {}
+
+			friend constexpr const Env &tag_invoke(get_env_t, const type &r) noexcept { return r._state->value(); }
 
 			[[noreturn]] friend void tag_invoke(set_error_t, type &&, auto...) noexcept { std::terminate(); }
 			template<typename Err> requires requires (const Err &err) { throw_exception(err); }
 			[[noreturn]] friend void tag_invoke(set_error_t, type &&, const Err &err) noexcept { throw_exception(err); }
 
-			template<_detail::completion_channel C, typename... Args>
-			friend void tag_invoke(C, type &&r, Args &&...) noexcept { Del{}(r._state); }
+			template<_detail::completion_channel C, typename... Args> requires(!std::same_as<C, set_error_t>)
+			friend void tag_invoke(C, type &&r, Args &&...) noexcept { r._state->notify(r._state); }
 
 		private:
 			state_t *_state = {};
 		};
 
-		struct alloc_deleter;
-		struct local_deleter;
-
 		enum flags_t : char
 		{
 			started = 1,
@@ -51,53 +75,61 @@ namespace rod
 			complete = 4,
 		};
 
-		template<typename Del, typename Snd>
-		class detached_state : connect_result_t<Snd, typename receiver<Del, Snd>::type>
+		template<typename Snd>
+		class inline_state : state_base<rod::empty_env>
 		{
-			friend struct alloc_deleter;
-			friend struct local_deleter;
+			using base_t = state_base<rod::empty_env>;
+			using receiver_t = typename receiver<rod::empty_env>::type;
+			using op_t = connect_result_t<Snd, receiver_t>;
 
-			using base_t = connect_result_t<Snd, typename receiver<Del, Snd>::type>;
-			using receiver_t = typename receiver<Del, Snd>::type;
+			static void notify_complete(base_t *ptr) noexcept
+			{
+				auto &flags = static_cast<inline_state *>(ptr)->_flags;
+				if (char old = started; !flags.compare_exchange_strong(old, complete, std::memory_order_acq_rel))
+				{
+					assert(old == (started | waiting));
+					flags.store(complete, std::memory_order_release);
+					flags.notify_one();
+				}
+			}
 
 		public:
-			explicit detached_state(Snd &&snd) noexcept(_detail::nothrow_callable<connect_t, Snd, receiver_t>) : base_t(connect(std::forward<Snd>(snd), receiver_t(this))) { start(static_cast<base_t &>(*this)); }
+			explicit inline_state(Snd &&snd) noexcept(_detail::nothrow_callable<connect_t, Snd, receiver_t>) : base_t(notify_complete), _op(connect(std::forward<Snd>(snd), receiver_t(this))) { start(_op); }
 
-			~detached_state()
+			~inline_state()
 			{
 				const auto old_flags = _flags.fetch_or(waiting, std::memory_order_acq_rel);
-				assert(old_flags & started);
-
 				if (!(old_flags & complete)) [[unlikely]]
-					_flags.wait(old_flags | waiting);
+				{
+					for (auto flags = old_flags | waiting; !(flags & complete); flags = _flags.load(std::memory_order_acquire))
+						_flags.wait(flags, std::memory_order_acquire);
+				}
 			}
 
 		private:
+			op_t _op;
 			std::atomic<char> _flags = started;
 		};
 
-		struct local_deleter
+		template<typename Snd, typename Alloc>
+		class detached_state : state_base<typename env<Alloc>::type>
 		{
-			template<typename Snd>
-			bool operator()(detached_state<alloc_deleter, Snd> *ptr) const noexcept
-			{
-				if (auto flags = started; !ptr->_flags.compare_exchange_strong(flags, complete))
-				{
-					assert(flags == (started | waiting));
-					ptr->_flags.notify_one();
-					return false;
-				}
-				return true;
-			}
-		};
-		struct alloc_deleter : local_deleter
-		{
-			template<typename Snd>
-			void operator()(detached_state<alloc_deleter, Snd> *ptr) const
-			{
-				if (local_deleter::operator()(ptr))
-					delete ptr;
-			}
+			using env_t = typename env<Alloc>::type;
+			using base_t = state_base<env_t>;
+			using receiver_t = typename receiver<env_t>::type;
+			using op_t = connect_result_t<Snd, receiver_t>;
+
+			/* The allocator is copied out of the environment before the state is destroyed. */
+			static void notify_complete(base_t *ptr) noexcept { _detail::delete_with_allocator(get_allocator(ptr->value()), static_cast<detached_state *>(ptr)); }
+
+		public:
+			explicit detached_state(Snd &&snd, const Alloc &alloc) noexcept(_detail::nothrow_callable<connect_t, Snd, receiver_t>) : base_t(notify_complete, alloc), _op(connect(std::forward<Snd>(snd), receiver_t(this))) {}
+
+			/* Started separately from construction, as the state may be destroyed by an inline completion. */
+			void start() noexcept { rod::start(_op); }
+
+		private:
+			op_t _op;
 		};
 
 		class start_inline_t
@@ -105,7 +137,7 @@ namespace rod
 			template<typename Snd>
 			using value_scheduler = decltype(get_completion_scheduler<set_value_t>(get_env(std::declval<Snd>())));
 			template<typename Snd>
-			using state_t = typename detached_state<local_deleter, std::decay_t<Snd>>::type;
+			using state_t = inline_state<std::decay_t<Snd>>;
 
 		public:
 			template<rod::sender Snd> requires _detail::tag_invocable_with_completion_scheduler<start_inline_t, set_value_t, Snd, Snd>
@@ -114,14 +146,16 @@ namespace rod
 			constexpr std::destructible auto operator()(Snd &&snd) const noexcept(nothrow_tag_invocable<start_inline_t, Snd>) { return tag_invoke(*this, std::forward<Snd>(snd)); }
 
 			template<rod::sender Snd> requires(!_detail::tag_invocable_with_completion_scheduler<start_inline_t, set_value_t, Snd> && !tag_invocable<start_inline_t, Snd>)
-			constexpr auto operator()(Snd &&snd) const noexcept(std::is_nothrow_constructible_v<state_t<Snd>, Snd>) { return state_t<Snd>{std::forward<Snd>(snd)}; }
+			constexpr state_t<Snd> operator()(Snd &&snd) const noexcept(std::is_nothrow_constructible_v<state_t<Snd>, Snd>) { return state_t<Snd>{std::forward<Snd>(snd)}; }
 		};
 		class start_detached_t
 		{
 			template<typename Snd>
 			using value_scheduler = decltype(get_completion_scheduler<set_value_t>(get_env(std::declval<Snd>())));
 			template<typename Snd>
-			using state_t = typename detached_state<alloc_deleter, std::decay_t<Snd>>::type;
+			using alloc_t = _detail::env_allocator_t<env_of_t<Snd>>;
+			template<typename Snd>
+			using state_t = detached_state<std::decay_t<Snd>, alloc_t<Snd>>;
 
 		public:
 			template<rod::sender Snd> requires _detail::tag_invocable_with_completion_scheduler<start_detached_t, set_value_t, Snd, Snd>
@@ -130,7 +164,11 @@ namespace rod
 			constexpr void operator()(Snd &&snd) const noexcept(nothrow_tag_invocable<start_detached_t, Snd>) { tag_invoke(*this, std::forward<Snd>(snd)); }
 
 			template<rod::sender Snd> requires(!_detail::tag_invocable_with_completion_scheduler<start_detached_t, set_value_t, Snd> && !tag_invocable<start_detached_t, Snd>)
-			constexpr void operator()(Snd &&snd) const { start(new state_t<Snd>{std::forward<Snd>(snd)}); }
+			void operator()(Snd &&snd) const
+			{
+				const auto alloc = _detail::allocator_from(get_env(snd));
+				_detail::new_with_allocator<state_t<Snd>>(alloc, std::forward<Snd>(snd), alloc)->start();
+			}
 		};
 	}
 
@@ -145,12 +183,13 @@ namespace rod
 
 	/** Type alias for a state object obtained from a call to `rod::start_inline(snd)`. */
 	template<sender Snd>
-	using detached_state_t = tag_invoke_result_t<start_inline_t, Snd>;
+	using detached_state_t = std::invoke_result_t<start_inline_t, Snd>;
 
 	using _start_detached::start_detached_t;
 
 	/** Synchronously starts the passed sender and detaches it's state. Detached state is destroyed upon completion.
 	 * @param snd Sender to start & detach.
-	 * @note If the operation completes via the error channel, `std::terminate` is called. */
+	 * @note If the operation completes via the error channel, `std::terminate` is called.
+	 * @note Detached state is allocated using the allocator obtained via `get_allocator` from the environment of \a snd (or `std::allocator` if none is provided), which is also available from the environment of the detached operation. */
 	inline constexpr auto start_detached = start_detached_t{};
 }
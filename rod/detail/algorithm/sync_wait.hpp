@@ -27,7 +27,7 @@ namespace rod
 		};
 
 		template<typename S, template<typename...> typename T = type_list_t>
-		using sync_wait_types = value_types_of_t<S, env, std::type_identity_t, T>;
+		using sync_wait_types = value_types_of_t<S, env, T, std::type_identity_t>;
 
 		template<typename... Ts>
 		using state_t = std::variant<std::monostate, std::tuple<Ts...>, std::exception_ptr, set_stopped_t>;
@@ -68,7 +68,7 @@ namespace rod
 			{
 				if constexpr (decays_to_same<Err, std::exception_ptr>)
 					state->template emplace<2>(std::forward<Err>(err));
-				if constexpr (decays_to_same<Err, std::error_code>)
+				else if constexpr (decays_to_same<Err, std::error_code>)
 					state->template emplace<2>(std::make_exception_ptr(std::system_error(std::forward<Err>(err))));
 				else
 					state->template emplace<2>(std::make_exception_ptr(std::forward<Err>(err)));
@@ -106,7 +106,8 @@ namespace rod
 				state_t<S> state = {};
 				run_loop loop = {};
 
-				/* Start the sender chain & wait for it to finish executing. */
+				/* Start the sender chain & wait for it to finish executing. The run loop doubles as the completion slot, since its consumer
+				 * spins on the producer queue before parking, and completion only wakes it up if it is parked. */
 				{
 					auto op = connect(std::forward<S>(snd), receiver_t<S>{&state, &loop});
 					start(op);
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <span>
+
 #include "../utility.hpp"
 #include "../result.hpp"
 
@@ -151,6 +153,27 @@ namespace rod
 	template<typename S>
 	concept operation_state = queryable<S> && std::is_object_v<S> && requires(S &s) { start(s); };
 
+	inline namespace _start
+	{
+		struct start_all_t
+		{
+			template<operation_state... Os> requires tag_invocable<start_all_t, Os &...>
+			constexpr void operator()(Os &...ops) const noexcept { tag_invoke(*this, ops...); }
+			template<operation_state... Os> requires(!tag_invocable<start_all_t, Os &...>)
+			constexpr void operator()(Os &...ops) const noexcept { (start(ops), ...); }
+
+			template<operation_state O> requires tag_invocable<start_all_t, std::span<O>>
+			constexpr void operator()(std::span<O> ops) const noexcept { tag_invoke(*this, ops); }
+			template<operation_state O> requires(!tag_invocable<start_all_t, std::span<O>>)
+			constexpr void operator()(std::span<O> ops) const noexcept { for (auto &op: ops) start(op); }
+		};
+	}
+
+	/** Customization point object used to start a group of operation states at once. Operation states may customize `start_all` to submit
+	 * the whole group of operations to their scheduler in bulk, otherwise every operation state is started individually via `start`.
+	 * @param ops Operation states to start, either as separate arguments or as a span. */
+	inline constexpr auto start_all = start_all_t{};
+
 	inline namespace _connect
 	{
 		struct connect_t
@@ -88,6 +88,15 @@ namespace rod
 		template<typename, typename>
 		struct receiver { class type; };
 
+		/* Operation being started by `await_suspend` on the current thread. Lives on the stack of `await_suspend`, so that the receiver
+		 * can report an inline completion without touching the coroutine frame, which may already be destroyed once `start` returns. */
+		struct start_frame
+		{
+			const void *key;
+			bool done = false;
+		};
+		inline thread_local start_frame *current_start = nullptr;
+
 		template<typename S, typename P>
 		class receiver<S, P>::type
 		{
@@ -98,6 +107,15 @@ namespace rod
 
 			constexpr type(result_t *result, handle_t handle) : _result_ptr(result), _cont_handle(handle) {}
 
+			/* Returns the handle to resume once the operation is complete. Stopped operations leave the result empty. */
+			static std::coroutine_handle<> continuation(const result_t &result, handle_t handle) noexcept
+			{
+				if (result.index() == 0)
+					return handle.promise().unhandled_stopped();
+				else
+					return handle;
+			}
+
 		public:
 			using is_receiver = std::true_type;
 
@@ -108,20 +126,27 @@ namespace rod
 			{
 				try { r._result_ptr->template emplace<1>(std::forward<Vs>(vs)...); }
 				catch (...) { r._result_ptr->template emplace<2>(std::current_exception()); }
-				r._cont_handle.resume();
+				r.complete();
 			}
 			template<typename Err>
 			friend void tag_invoke(set_error_t, type &&r, Err &&err) noexcept
 			{
 				r._result_ptr->template emplace<2>(_detail::to_except_ptr(std::forward<Err>(err)));
-				r._cont_handle.resume();
+				r.complete();
 			}
-			friend void tag_invoke(set_stopped_t, type &&r) noexcept
+			friend void tag_invoke(set_stopped_t, type &&r) noexcept { r.complete(); }
+
+		private:
+			/* Operations that complete inline from within `start` leave resumption of the coroutine to `await_suspend`. Completions
+			 * on other threads, or after `start` has returned, resume the coroutine directly on the completing thread. */
+			void complete() noexcept
 			{
-				static_cast<std::coroutine_handle<>>(r._cont_handle.promise().unhandled_stopped()).resume();
+				if (const auto frame = current_start; frame != nullptr && frame->key == _result_ptr)
+					frame->done = true;
+				else
+					continuation(*_result_ptr, _cont_handle).resume();
 			}
 
-		private:
 			result_t *_result_ptr;
 			handle_t _cont_handle;
 		};
@@ -136,7 +161,23 @@ namespace rod
 			constexpr type(S &&s, std::coroutine_handle<P> h) : _state(connect(std::forward<S>(s), receiver_t{&_result, h})) {}
 
 			[[nodiscard]] constexpr bool await_ready() const noexcept { return false; }
-			void await_suspend(std::coroutine_handle<P>) noexcept { start(_state); }
+			bool await_suspend(std::coroutine_handle<P> h) noexcept
+			{
+				auto frame = start_frame{&_result};
+				const auto prev = std::exchange(current_start, &frame);
+				start(_state);
+				current_start = prev;
+
+				/* If the operation has completed inline, the coroutine is resumed by returning `false` instead of from within the receiver,
+				 * so that awaiting senders in a loop does not grow the stack. Otherwise the receiver will resume the coroutine once complete. */
+				if (!frame.done)
+					return true;
+				if (_result.index() != 0)
+					return false;
+
+				receiver_t::continuation(_result, h).resume();
+				return true;
+			}
 
 			constexpr value_t<S, P> await_resume()
 			{
@@ -472,6 +513,12 @@ namespace rod
 		}
 
 	public:
+		/* Always-equal allocators are default-constructed when a coroutine is not passed an allocator explicitly. */
+		template<typename... Args> requires std::default_initializable<allocator_type>
+		constexpr void *operator new(std::size_t sz, Args &&...) { return allocate(sz, allocator_type{}); }
+		template<typename... Args> requires std::default_initializable<allocator_type>
+		constexpr void operator delete(void *, std::size_t, Args &&...) {}
+
 		template<typename Alloc2, typename... Args> requires std::constructible_from<allocator_type, Alloc2>
 		constexpr void *operator new(std::size_t sz, std::allocator_arg_t, Alloc2 &&alloc, Args &&...) { return allocate(sz, std::forward<Alloc2>(alloc)); }
 		template<typename Alloc2, typename... Args> requires std::constructible_from<allocator_type, Alloc2>
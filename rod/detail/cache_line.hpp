@@ -0,0 +1,16 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "config.hpp"
+
+namespace rod::_detail
+{
+	/* Size of a cache line used to pad shared atomic state. `std::hardware_destructive_interference_size` is not used
+	 * since its value may change between compiler flags, which would make it unsuitable for use in an ABI boundary. */
+	inline constexpr std::size_t cache_line_size = 64;
+}
@@ -463,7 +463,32 @@ namespace rod
 				return res;
 			}
 
-			/* TODO: Implement async overloads. */
+			template<typename Sch, typename Req, typename To>
+			auto do_async_read_some(Sch &&sch, Req &&req, const To &to) noexcept
+			{
+				auto snd = async_read_some_at(std::forward<Sch>(sch), adaptor::base(), {.buffs = std::forward<Req>(req).buffs, .off = _pos}, to);
+				return then(std::move(snd), [this](io_result_t<FileBase, read_some_t> res) noexcept
+				{
+					if (res.has_value()) [[likely]]
+						std::ranges::for_each(*res, [&](auto &buff) noexcept { _pos += buff.size(); });
+					else
+						_pos += res.error().partial_bytes();
+					return res;
+				});
+			}
+			template<typename Sch, typename Req, typename To>
+			auto do_async_write_some(Sch &&sch, Req &&req, const To &to) noexcept
+			{
+				auto snd = async_write_some_at(std::forward<Sch>(sch), adaptor::base(), {.buffs = std::forward<Req>(req).buffs, .off = _pos}, to);
+				return then(std::move(snd), [this](io_result_t<FileBase, write_some_t> res) noexcept
+				{
+					if (res.has_value()) [[likely]]
+						std::ranges::for_each(*res, [&](auto &buff) noexcept { _pos += buff.size(); });
+					else
+						_pos += res.error().partial_bytes();
+					return res;
+				});
+			}
 
 			typename adaptor::extent_type _pos = 0;
 		};
@@ -0,0 +1,187 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#include <utility>
+#include <atomic>
+#include <bit>
+
+#include "frame_allocator.hpp"
+
+namespace rod::_detail
+{
+	/* Blocks are sorted into power-of-two size classes from `min_block` up to `max_block` bytes (including the block header). */
+	constexpr std::size_t min_block_bits = 6;
+	constexpr std::size_t max_block_bits = 14;
+	constexpr std::size_t min_block = std::size_t(1) << min_block_bits;
+	constexpr std::size_t max_block = std::size_t(1) << max_block_bits;
+	constexpr std::size_t class_count = max_block_bits - min_block_bits + 1;
+	/* Maximum number of free blocks cached by a pool per size class. Blocks freed beyond the limit are returned to the global allocator. */
+	constexpr std::size_t max_cached = 32;
+
+	struct frame_pool;
+
+	/* Header preceding every block, used to find the owning pool and the size class of the block when it is freed.
+	 * Blocks allocated outside of a pool have no owner. */
+	struct alignas(frame_alignment) frame_header
+	{
+		frame_pool *owner;
+		std::size_t size_class;
+	};
+	/* Free blocks are linked through their storage. */
+	struct free_block { free_block *next; };
+
+	static frame_header *header_of(void *ptr) noexcept { return static_cast<frame_header *>(ptr) - 1; }
+	static void *block_of(frame_header *hdr) noexcept { return hdr + 1; }
+
+	static std::size_t size_class_of(std::size_t size) noexcept
+	{
+		return size <= min_block ? 0 : std::bit_width(size - 1) - min_block_bits;
+	}
+	static std::size_t class_size(std::size_t size_class) noexcept { return min_block << size_class; }
+
+	struct frame_pool
+	{
+		/* Returns a free block of the specified size class, or `nullptr` if there are none cached. */
+		[[nodiscard]] void *take(std::size_t size_class) noexcept
+		{
+			if (!cache[size_class])
+				reclaim();
+
+			const auto block = cache[size_class];
+			if (block != nullptr)
+			{
+				cache[size_class] = block->next;
+				--cached[size_class];
+			}
+			return block;
+		}
+		/* Caches a block owned by this pool, or returns it to the global allocator if the cache is full. */
+		void recycle(void *block, std::size_t size_class) noexcept
+		{
+			if (cached[size_class] < max_cached)
+			{
+				cache[size_class] = new (block) free_block{cache[size_class]};
+				++cached[size_class];
+			}
+			else
+				::operator delete(header_of(block));
+		}
+
+		/* Moves blocks freed by other threads into the cache. */
+		void reclaim() noexcept
+		{
+			if (remote.load(std::memory_order_relaxed) == nullptr)
+				return;
+
+			for (auto block = static_cast<free_block *>(remote.exchange(nullptr, std::memory_order_acquire)); block != nullptr;)
+			{
+				const auto next = block->next;
+				recycle(block, header_of(block)->size_class);
+				block = next;
+				--live;
+			}
+		}
+		/* Called by threads other than the owner to free a block of this pool. */
+		void push_remote(void *ptr) noexcept
+		{
+			auto head = remote.load(std::memory_order_acquire);
+			for (const auto block = static_cast<free_block *>(ptr);;)
+			{
+				if (head == closed())
+				{
+					/* Owning thread has exited, the last outstanding block deletes the pool. */
+					::operator delete(header_of(ptr));
+					if (orphaned.fetch_sub(1, std::memory_order_acq_rel) == 1)
+						delete this;
+					return;
+				}
+
+				block->next = static_cast<free_block *>(head);
+				if (remote.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_acquire))
+					return;
+			}
+		}
+
+		/* Called by the owning thread on exit. Releases all cached blocks, and leaves the pool alive until outstanding blocks are freed. */
+		void close() noexcept
+		{
+			for (auto &head : cache)
+				for (auto block = std::exchange(head, nullptr); block != nullptr;)
+					::operator delete(header_of(std::exchange(block, block->next)));
+
+			/* Blocks in the remote list are counted as outstanding, and are subtracted once the list is closed. The owner holds an extra
+			 * reference until then, since remote frees observing the closed list may otherwise release the last block and delete the pool. */
+			orphaned.store(live + 1, std::memory_order_relaxed);
+			auto block = static_cast<free_block *>(remote.exchange(closed(), std::memory_order_acq_rel));
+			std::size_t drained = 0;
+			for (; block != nullptr; ++drained)
+				::operator delete(header_of(std::exchange(block, block->next)));
+
+			if (orphaned.fetch_sub(drained + 1, std::memory_order_acq_rel) == drained + 1)
+				delete this;
+		}
+
+		[[nodiscard]] void *closed() const noexcept { return const_cast<frame_pool *>(this); }
+
+		free_block *cache[class_count] = {};
+		std::size_t cached[class_count] = {};
+		/* Number of blocks allocated from this pool that have not been returned to it yet. */
+		std::size_t live = 0;
+
+		std::atomic<void *> remote = {};
+		std::atomic<std::size_t> orphaned = {};
+	};
+
+	/* Pool of the current thread is created on first allocation and closed on thread exit. */
+	static thread_local frame_pool *local_pool = nullptr;
+	static thread_local bool local_exited = false;
+
+	struct pool_guard { ~pool_guard() { local_exited = true; if (local_pool) std::exchange(local_pool, nullptr)->close(); } };
+	static thread_local pool_guard local_guard;
+
+	static frame_pool *this_pool()
+	{
+		if (local_pool == nullptr && !local_exited)
+		{
+			local_pool = new frame_pool();
+			static_cast<void>(&local_guard);
+		}
+		return local_pool;
+	}
+
+	void *frame_allocate(std::size_t size)
+	{
+		const auto total = size + sizeof(frame_header);
+		const auto pool = total <= max_block ? this_pool() : nullptr;
+		if (pool == nullptr)
+		{
+			const auto hdr = new (::operator new(total)) frame_header{nullptr, 0};
+			return block_of(hdr);
+		}
+
+		const auto size_class = size_class_of(total);
+		auto block = pool->take(size_class);
+		if (block == nullptr)
+			block = block_of(new (::operator new(class_size(size_class))) frame_header{pool, size_class});
+
+		++pool->live;
+		return block;
+	}
+	void frame_deallocate(void *ptr) noexcept
+	{
+		if (ptr == nullptr)
+			return;
+
+		const auto hdr = header_of(ptr);
+		if (hdr->owner == nullptr)
+			::operator delete(hdr);
+		else if (hdr->owner == local_pool)
+		{
+			--local_pool->live;
+			local_pool->recycle(ptr, hdr->size_class);
+		}
+		else
+			hdr->owner->push_remote(ptr);
+	}
+}
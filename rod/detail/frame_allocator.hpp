@@ -0,0 +1,70 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "config.hpp"
+
+namespace rod
+{
+	namespace _detail
+	{
+		/* Alignment of blocks returned by the frame pool. Over-aligned types bypass the pool. */
+		inline constexpr std::size_t frame_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+		/* Allocates a block of at least `size` bytes from the frame pool of the calling thread. */
+		[[nodiscard]] ROD_API_PUBLIC void *frame_allocate(std::size_t size);
+		/* Returns a block allocated by `frame_allocate` to the pool of the thread that allocated it. May be called from any thread. */
+		ROD_API_PUBLIC void frame_deallocate(void *ptr) noexcept;
+	}
+
+	/** Allocator used by default to allocate frames of `task`, `shared_task` and `generator` coroutines.
+	 *
+	 * Every thread owns a pool of recently freed blocks sorted into power-of-two size classes, so that frames of short-lived coroutines
+	 * are recycled without calling the global allocator. A block freed on a thread other than the one that allocated it is pushed onto
+	 * a lock-free list of the owning pool, which is reclaimed in a single batch once the owner runs out of cached blocks of a size class.
+	 * Large and over-aligned blocks are allocated with the global `operator new`.
+	 *
+	 * @note Blocks are cached per-thread, and are released to the global allocator only when the owning thread exits. */
+	template<typename T>
+	class frame_allocator
+	{
+		template<typename>
+		friend class frame_allocator;
+
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using is_always_equal = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+
+	public:
+		constexpr frame_allocator() noexcept = default;
+		template<typename U>
+		constexpr frame_allocator(const frame_allocator<U> &) noexcept {}
+
+		[[nodiscard]] T *allocate(std::size_t n)
+		{
+			if constexpr (alignof(T) > _detail::frame_alignment)
+				return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+			else
+				return static_cast<T *>(_detail::frame_allocate(n * sizeof(T)));
+		}
+		void deallocate(T *ptr, [[maybe_unused]] std::size_t n) noexcept
+		{
+			if constexpr (alignof(T) > _detail::frame_alignment)
+				::operator delete(ptr, n * sizeof(T), std::align_val_t{alignof(T)});
+			else
+				_detail::frame_deallocate(ptr);
+		}
+
+		template<typename U>
+		[[nodiscard]] constexpr bool operator==(const frame_allocator<U> &) const noexcept { return true; }
+	};
+}
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "queries/scheduler.hpp"
+#include "adaptors/then.hpp"
 #include "io_status_code.hpp"
 #include "handle_base.hpp"
 
@@ -425,45 +426,90 @@ namespace rod
 	namespace _io_operation
 	{
 		template<typename Snd, typename Op, typename Hnd, typename Env = empty_env>
-		concept sender_of_io_result = sender_of<Snd, completion_signatures<set_value_t(io_result_t<std::decay_t<Hnd>, Op>)>, Env>;
+		concept sender_of_io_result = sender_of<Snd, set_value_t(io_result_t<std::decay_t<Hnd>, Op>), Env>;
 
-		template<typename Op>
+		/* Asynchronous IO operations use request & result types of their synchronous counterpart \a SyncOp. */
+		template<typename Op, typename SyncOp>
 		struct async_adaptor { class type; };
-		template<typename Op>
-		class async_adaptor<Op>::type
+		template<typename Op, typename SyncOp>
+		class async_adaptor<Op, SyncOp>::type
 		{
-			template<typename Hnd> requires has_io_request<std::decay_t<Hnd>, Op>
-			using request_t = io_request_t<std::decay_t<Hnd>, Op>;
+			template<typename Hnd> requires has_io_request<std::decay_t<Hnd>, SyncOp>
+			using request_t = io_request_t<std::decay_t<Hnd>, SyncOp>;
 			template<typename Hnd> requires has_timeout<std::decay_t<Hnd>>
 			using timeout_t = handle_timeout_t<std::decay_t<Hnd>>;
 
 		public:
-			template<decay_has_io_definitions<Op> Hnd, std::convertible_to<request_t<Hnd>> Req = request_t<Hnd>, std::convertible_to<timeout_t<Hnd>> To = timeout_t<Hnd>> requires tag_invocable<Op, Hnd, Req, To>
-			constexpr sender_of_io_result<Op, Hnd> auto operator()(Hnd &&hnd, Req &&req, To &&to) const noexcept { return tag_invoke(Op{}, std::forward<Hnd>(hnd), std::forward<Req>(req), std::forward<To>(to)); }
-			template<decay_has_io_definitions<Op> Hnd, std::convertible_to<request_t<Hnd>> Req = request_t<Hnd>> requires tag_invocable<Op, Hnd, Req, timeout_t<Hnd>>
-			constexpr sender_of_io_result<Op, Hnd> auto operator()(Hnd &&hnd, Req &&req) const noexcept { return tag_invoke(Op{}, std::forward<Hnd>(hnd), std::forward<Req>(req), timeout_t<Hnd>()); }
+			template<decay_has_io_definitions<SyncOp> Hnd, std::convertible_to<request_t<Hnd>> Req = request_t<Hnd>, std::convertible_to<timeout_t<Hnd>> To = timeout_t<Hnd>> requires tag_invocable<Op, Hnd, Req, To>
+			constexpr sender_of_io_result<SyncOp, Hnd> auto operator()(Hnd &&hnd, Req &&req, To &&to) const noexcept { return tag_invoke(Op{}, std::forward<Hnd>(hnd), std::forward<Req>(req), std::forward<To>(to)); }
+			template<decay_has_io_definitions<SyncOp> Hnd, std::convertible_to<request_t<Hnd>> Req = request_t<Hnd>> requires tag_invocable<Op, Hnd, Req, timeout_t<Hnd>>
+			constexpr sender_of_io_result<SyncOp, Hnd> auto operator()(Hnd &&hnd, Req &&req) const noexcept { return tag_invoke(Op{}, std::forward<Hnd>(hnd), std::forward<Req>(req), timeout_t<Hnd>()); }
+
+			template<rod::scheduler Sch, decay_has_io_definitions<SyncOp> Hnd, std::convertible_to<request_t<Hnd>> Req = request_t<Hnd>, std::convertible_to<timeout_t<Hnd>> To = timeout_t<Hnd>> requires tag_invocable<Op, Sch, Hnd, Req, To>
+			constexpr sender_of_io_result<SyncOp, Hnd> auto operator()(Sch &&sch, Hnd &&hnd, Req &&req, To &&to) const noexcept { return tag_invoke(Op{}, std::forward<Sch>(sch), std::forward<Hnd>(hnd), std::forward<Req>(req), std::forward<To>(to)); }
+			template<rod::scheduler Sch, decay_has_io_definitions<SyncOp> Hnd, std::convertible_to<request_t<Hnd>> Req = request_t<Hnd>, std::convertible_to<timeout_t<Hnd>> To = timeout_t<Hnd>> requires(!tag_invocable<Op, Sch, Hnd, Req, To> && _detail::callable<SyncOp, Hnd &, request_t<Hnd>, const timeout_t<Hnd> &>)
+			constexpr sender_of_io_result<SyncOp, Hnd> auto operator()(Sch &&sch, Hnd &&hnd, Req &&req, To &&to) const noexcept
+			{
+				/* Schedulers without native support for the operation execute it synchronously on one of their execution agents. */
+				auto func = [hnd = &hnd, req = request_t<Hnd>(std::forward<Req>(req)), to = timeout_t<Hnd>(std::forward<To>(to))]() mutable noexcept { return SyncOp{}(*hnd, std::move(req), to); };
+				return then(schedule(std::forward<Sch>(sch)), std::move(func));
+			}
+			template<rod::scheduler Sch, decay_has_io_definitions<SyncOp> Hnd, std::convertible_to<request_t<Hnd>> Req = request_t<Hnd>> requires _detail::callable<type, Sch, Hnd, Req, timeout_t<Hnd>>
+			constexpr sender_of_io_result<SyncOp, Hnd> auto operator()(Sch &&sch, Hnd &&hnd, Req &&req) const noexcept { return (*this)(std::forward<Sch>(sch), std::forward<Hnd>(hnd), std::forward<Req>(req), timeout_t<Hnd>::infinite); }
 		};
 	}
 
 	namespace _read_some
 	{
-		struct async_read_some_at_t : _io_operation::async_adaptor<async_read_some_at_t>::type {};
-		struct async_read_some_t : _io_operation::async_adaptor<async_read_some_t>::type {};
+		struct async_read_some_at_t : _io_operation::async_adaptor<async_read_some_at_t, read_some_at_t>::type {};
+		struct async_read_some_t : _io_operation::async_adaptor<async_read_some_t, read_some_t>::type {};
 	}
 
 	using _read_some::async_read_some_at_t;
 	using _read_some::async_read_some_t;
 
+	/** Customization point object used to preform an asynchronous sparse input using an IO handle.
+	 * @param sch Optional scheduler used to preform the IO operation. If the scheduler does not support native asynchronous IO, the operation is executed synchronously on the scheduler.
+	 * @param hnd Handle to preform the IO operation on.
+	 * @param req Value of type `io_request_t&lt;decltype(hnd), read_some_at_t&gt;` used to specify parameters of the IO operation.
+	 * @param to Optional value of type `handle_timeout_t&lt;decltype(hnd)&gt;` used to specify the timeout for the IO operation.
+	 * @return Sender completing with a value of type `io_result_t&lt;decltype(hnd), read_some_at_t&gt;`.
+	 * @note Lifetime of \a hnd and the buffers referenced by \a req must exceed the lifetime of the IO operation. */
+	inline constexpr auto async_read_some_at = async_read_some_at_t{};
+	/** Customization point object used to preform an asynchronous stream input using an IO handle.
+	 * @param sch Optional scheduler used to preform the IO operation. If the scheduler does not support native asynchronous IO, the operation is executed synchronously on the scheduler.
+	 * @param hnd Handle to preform the IO operation on.
+	 * @param req Value of type `io_request_t&lt;decltype(hnd), read_some_t&gt;` used to specify parameters of the IO operation.
+	 * @param to Optional value of type `handle_timeout_t&lt;decltype(hnd)&gt;` used to specify the timeout for the IO operation.
+	 * @return Sender completing with a value of type `io_result_t&lt;decltype(hnd), read_some_t&gt;`.
+	 * @note Lifetime of \a hnd and the buffers referenced by \a req must exceed the lifetime of the IO operation. */
+	inline constexpr auto async_read_some = async_read_some_t{};
+
 	namespace _write_some
 	{
-		struct async_write_some_at_t : _io_operation::async_adaptor<async_write_some_at_t>::type {};
-		struct async_write_some_t : _io_operation::async_adaptor<async_write_some_t>::type {};
+		struct async_write_some_at_t : _io_operation::async_adaptor<async_write_some_at_t, write_some_at_t>::type {};
+		struct async_write_some_t : _io_operation::async_adaptor<async_write_some_t, write_some_t>::type {};
 	}
 
 	using _write_some::async_write_some_at_t;
 	using _write_some::async_write_some_t;
 
-	/* TODO: Implement async IO operations. */
+	/** Customization point object used to preform an asynchronous sparse output using an IO handle.
+	 * @param sch Optional scheduler used to preform the IO operation. If the scheduler does not support native asynchronous IO, the operation is executed synchronously on the scheduler.
+	 * @param hnd Handle to preform the IO operation on.
+	 * @param req Value of type `io_request_t&lt;decltype(hnd), write_some_at_t&gt;` used to specify parameters of the IO operation.
+	 * @param to Optional value of type `handle_timeout_t&lt;decltype(hnd)&gt;` used to specify the timeout for the IO operation.
+	 * @return Sender completing with a value of type `io_result_t&lt;decltype(hnd), write_some_at_t&gt;`.
+	 * @note Lifetime of \a hnd and the buffers referenced by \a req must exceed the lifetime of the IO operation. */
+	inline constexpr auto async_write_some_at = async_write_some_at_t{};
+	/** Customization point object used to preform an asynchronous stream output using an IO handle.
+	 * @param sch Optional scheduler used to preform the IO operation. If the scheduler does not support native asynchronous IO, the operation is executed synchronously on the scheduler.
+	 * @param hnd Handle to preform the IO operation on.
+	 * @param req Value of type `io_request_t&lt;decltype(hnd), write_some_t&gt;` used to specify parameters of the IO operation.
+	 * @param to Optional value of type `handle_timeout_t&lt;decltype(hnd)&gt;` used to specify the timeout for the IO operation.
+	 * @return Sender completing with a value of type `io_result_t&lt;decltype(hnd), write_some_t&gt;`.
+	 * @note Lifetime of \a hnd and the buffers referenced by \a req must exceed the lifetime of the IO operation. */
+	inline constexpr auto async_write_some = async_write_some_t{};
 
 	namespace _handle
 	{
@@ -722,7 +768,89 @@ namespace rod
 				return Op{}(get_adaptor(std::forward<Hnd>(hnd)).base(), std::forward<Req>(req), to);
 			}
 
-			/* TODO: Implement async IO operations. */
+
+		private:
+			static constexpr int do_async_read_some = 1;
+			static constexpr int do_async_read_some_at = 1;
+			static constexpr int do_async_write_some = 1;
+			static constexpr int do_async_write_some_at = 1;
+
+			template<typename Hnd>
+			static constexpr bool has_async_read_some() noexcept { return !requires { requires bool(int(std::decay_t<Hnd>::do_async_read_some)); }; }
+			template<typename Hnd>
+			static constexpr bool has_async_read_some_at() noexcept { return !requires { requires bool(int(std::decay_t<Hnd>::do_async_read_some_at)); }; }
+			template<typename Hnd>
+			static constexpr bool has_async_write_some() noexcept { return !requires { requires bool(int(std::decay_t<Hnd>::do_async_write_some)); }; }
+			template<typename Hnd>
+			static constexpr bool has_async_write_some_at() noexcept { return !requires { requires bool(int(std::decay_t<Hnd>::do_async_write_some_at)); }; }
+
+			template<typename Hnd, typename Sch, typename Req, typename To>
+			constexpr static auto dispatch_async_read_some(Hnd &&hnd, Sch &&sch, Req &&req, const To &to) noexcept -> decltype(std::forward<Hnd>(hnd).do_async_read_some(std::forward<Sch>(sch), std::forward<Req>(req), to))
+			{
+				return std::forward<Hnd>(hnd).do_async_read_some(std::forward<Sch>(sch), std::forward<Req>(req), to);
+			}
+			template<typename Hnd, typename Sch, typename Req, typename To>
+			constexpr static auto dispatch_async_read_some_at(Hnd &&hnd, Sch &&sch, Req &&req, const To &to) noexcept -> decltype(std::forward<Hnd>(hnd).do_async_read_some_at(std::forward<Sch>(sch), std::forward<Req>(req), to))
+			{
+				return std::forward<Hnd>(hnd).do_async_read_some_at(std::forward<Sch>(sch), std::forward<Req>(req), to);
+			}
+			template<typename Hnd, typename Sch, typename Req, typename To>
+			constexpr static auto dispatch_async_write_some(Hnd &&hnd, Sch &&sch, Req &&req, const To &to) noexcept -> decltype(std::forward<Hnd>(hnd).do_async_write_some(std::forward<Sch>(sch), std::forward<Req>(req), to))
+			{
+				return std::forward<Hnd>(hnd).do_async_write_some(std::forward<Sch>(sch), std::forward<Req>(req), to);
+			}
+			template<typename Hnd, typename Sch, typename Req, typename To>
+			constexpr static auto dispatch_async_write_some_at(Hnd &&hnd, Sch &&sch, Req &&req, const To &to) noexcept -> decltype(std::forward<Hnd>(hnd).do_async_write_some_at(std::forward<Sch>(sch), std::forward<Req>(req), to))
+			{
+				return std::forward<Hnd>(hnd).do_async_write_some_at(std::forward<Sch>(sch), std::forward<Req>(req), to);
+			}
+
+		public:
+			/* Asynchronous operations are forwarded to the base handle only if the synchronous counterpart is not overloaded by the child,
+			 * otherwise the generic fallback will invoke the child's synchronous operation on the target scheduler. */
+			template<decays_to_same<async_read_some_t> Op, rod::scheduler Sch, decays_to_same<Child> Hnd, decays_to_same<io_request_t<std::decay_t<Hnd>, read_some_t>> Req, std::convertible_to<handle_timeout_t<std::decay_t<Hnd>>> To>
+			friend decltype(auto) tag_invoke(Op, Sch &&sch, Hnd &&hnd, Req &&req, const To &to) noexcept requires(has_async_read_some<Hnd>() && requires { dispatch_async_read_some(std::forward<Hnd>(hnd), std::forward<Sch>(sch), std::forward<Req>(req), to); })
+			{
+				return dispatch_async_read_some(std::forward<Hnd>(hnd), std::forward<Sch>(sch), std::forward<Req>(req), to);
+			}
+			template<decays_to_same<async_read_some_t> Op, rod::scheduler Sch, decays_to_same<Child> Hnd, decays_to_same<io_request_t<std::decay_t<Hnd>, read_some_t>> Req, std::convertible_to<handle_timeout_t<std::decay_t<Hnd>>> To>
+			friend decltype(auto) tag_invoke(Op, Sch &&sch, Hnd &&hnd, Req &&req, const To &to) noexcept requires(!has_async_read_some<Hnd>() && !has_read_some<Hnd>() && tag_invocable<Op, Sch, copy_cvref_t<Hnd, Base>, Req, const To &>)
+			{
+				return Op{}(std::forward<Sch>(sch), get_adaptor(std::forward<Hnd>(hnd)).base(), std::forward<Req>(req), to);
+			}
+
+			template<decays_to_same<async_read_some_at_t> Op, rod::scheduler Sch, decays_to_same<Child> Hnd, decays_to_same<io_request_t<std::decay_t<Hnd>, read_some_at_t>> Req, std::convertible_to<handle_timeout_t<std::decay_t<Hnd>>> To>
+			friend decltype(auto) tag_invoke(Op, Sch &&sch, Hnd &&hnd, Req &&req, const To &to) noexcept requires(has_async_read_some_at<Hnd>() && requires { dispatch_async_read_some_at(std::forward<Hnd>(hnd), std::forward<Sch>(sch), std::forward<Req>(req), to); })
+			{
+				return dispatch_async_read_some_at(std::forward<Hnd>(hnd), std::forward<Sch>(sch), std::forward<Req>(req), to);
+			}
+			template<decays_to_same<async_read_some_at_t> Op, rod::scheduler Sch, decays_to_same<Child> Hnd, decays_to_same<io_request_t<std::decay_t<Hnd>, read_some_at_t>> Req, std::convertible_to<handle_timeout_t<std::decay_t<Hnd>>> To>
+			friend decltype(auto) tag_invoke(Op, Sch &&sch, Hnd &&hnd, Req &&req, const To &to) noexcept requires(!has_async_read_some_at<Hnd>() && !has_read_some_at<Hnd>() && tag_invocable<Op, Sch, copy_cvref_t<Hnd, Base>, Req, const To &>)
+			{
+				return Op{}(std::forward<Sch>(sch), get_adaptor(std::forward<Hnd>(hnd)).base(), std::forward<Req>(req), to);
+			}
+
+			template<decays_to_same<async_write_some_t> Op, rod::scheduler Sch, decays_to_same<Child> Hnd, decays_to_same<io_request_t<std::decay_t<Hnd>, write_some_t>> Req, std::convertible_to<handle_timeout_t<std::decay_t<Hnd>>> To>
+			friend decltype(auto) tag_invoke(Op, Sch &&sch, Hnd &&hnd, Req &&req, const To &to) noexcept requires(has_async_write_some<Hnd>() && requires { dispatch_async_write_some(std::forward<Hnd>(hnd), std::forward<Sch>(sch), std::forward<Req>(req), to); })
+			{
+				return dispatch_async_write_some(std::forward<Hnd>(hnd), std::forward<Sch>(sch), std::forward<Req>(req), to);
+			}
+			template<decays_to_same<async_write_some_t> Op, rod::scheduler Sch, decays_to_same<Child> Hnd, decays_to_same<io_request_t<std::decay_t<Hnd>, write_some_t>> Req, std::convertible_to<handle_timeout_t<std::decay_t<Hnd>>> To>
+			friend decltype(auto) tag_invoke(Op, Sch &&sch, Hnd &&hnd, Req &&req, const To &to) noexcept requires(!has_async_write_some<Hnd>() && !has_write_some<Hnd>() && tag_invocable<Op, Sch, copy_cvref_t<Hnd, Base>, Req, const To &>)
+			{
+				return Op{}(std::forward<Sch>(sch), get_adaptor(std::forward<Hnd>(hnd)).base(), std::forward<Req>(req), to);
+			}
+
+			template<decays_to_same<async_write_some_at_t> Op, rod::scheduler Sch, decays_to_same<Child> Hnd, decays_to_same<io_request_t<std::decay_t<Hnd>, write_some_at_t>> Req, std::convertible_to<handle_timeout_t<std::decay_t<Hnd>>> To>
+			friend decltype(auto) tag_invoke(Op, Sch &&sch, Hnd &&hnd, Req &&req, const To &to) noexcept requires(has_async_write_some_at<Hnd>() && requires { dispatch_async_write_some_at(std::forward<Hnd>(hnd), std::forward<Sch>(sch), std::forward<Req>(req), to); })
+			{
+				return dispatch_async_write_some_at(std::forward<Hnd>(hnd), std::forward<Sch>(sch), std::forward<Req>(req), to);
+			}
+			template<decays_to_same<async_write_some_at_t> Op, rod::scheduler Sch, decays_to_same<Child> Hnd, decays_to_same<io_request_t<std::decay_t<Hnd>, write_some_at_t>> Req, std::convertible_to<handle_timeout_t<std::decay_t<Hnd>>> To>
+			friend decltype(auto) tag_invoke(Op, Sch &&sch, Hnd &&hnd, Req &&req, const To &to) noexcept requires(!has_async_write_some_at<Hnd>() && !has_write_some_at<Hnd>() && tag_invocable<Op, Sch, copy_cvref_t<Hnd, Base>, Req, const To &>)
+			{
+				return Op{}(std::forward<Sch>(sch), get_adaptor(std::forward<Hnd>(hnd)).base(), std::forward<Req>(req), to);
+			}
 		};
 	}
 
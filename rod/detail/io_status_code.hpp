@@ -7,6 +7,7 @@
 #include <string>
 
 #include "../result.hpp"
+#include "handle_base.hpp"
 
 namespace rod
 {
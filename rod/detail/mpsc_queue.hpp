@@ -0,0 +1,78 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "basic_queue.hpp"
+
+namespace rod::_detail
+{
+	/* Intrusive FIFO queue with multiple producers and a single consumer, implemented as an exchange-based stack. Producers push nodes
+	 * with a single exchange of the head pointer and then link the node to the previous head. The consumer takes the whole stack at once
+	 * and reverses it to restore the push order, yielding while it finds a node that has not been linked by its producer yet. As such,
+	 * nodes are ordered by the exchange of the head pointer, and a producer preempted between the exchange and the link blocks the consumer.
+	 *
+	 * The consumer may terminate an empty queue before going to sleep, in which case the head holds a sentinel value and the next call
+	 * to `push` reports that the consumer needs to be woken up. Pushing to a terminated queue re-activates it. */
+	template<typename Node, Node *Node::*Next>
+	struct mpsc_queue
+	{
+		void activate() noexcept { head.store(nullptr, std::memory_order_release); }
+		bool try_activate() noexcept
+		{
+			void *old = sentinel();
+			return head.compare_exchange_strong(old, nullptr, std::memory_order_acq_rel);
+		}
+
+		void terminate() noexcept { head.store(sentinel(), std::memory_order_release); }
+		bool try_terminate() noexcept
+		{
+			void *old = nullptr;
+			return head.compare_exchange_strong(old, sentinel(), std::memory_order_acq_rel);
+		}
+
+		[[nodiscard]] bool empty() const noexcept { return head.load(std::memory_order_acquire) == nullptr; }
+		[[nodiscard]] bool active() const noexcept { return head.load(std::memory_order_acquire) != sentinel(); }
+
+		/** Pushes \a node to the back of the queue. Returns `true` if the queue has been terminated. */
+		bool push(Node *node) noexcept
+		{
+			/* Mark the node as unlinked until the link to the previous head is published, since the consumer may take the node before then. */
+			std::atomic_ref(node->*Next).store(unlinked(), std::memory_order_relaxed);
+			const auto prev = head.exchange(node, std::memory_order_acq_rel);
+			std::atomic_ref(node->*Next).store(prev == sentinel() ? nullptr : static_cast<Node *>(prev), std::memory_order_release);
+			return prev == sentinel();
+		}
+
+		void notify_one() noexcept { head.notify_one(); }
+		void notify_all() noexcept { head.notify_all(); }
+		void wait(void *old = nullptr) noexcept { head.wait(old); }
+		[[nodiscard]] void *sentinel() const noexcept { return const_cast<mpsc_queue *>(this); }
+
+		/** Takes all nodes from an active queue, in the order they have been pushed. Must only be called from the consumer thread. */
+		[[nodiscard]] operator basic_queue<Node, Next>() && noexcept
+		{
+			auto queue = basic_queue<Node, Next>();
+			for (auto node = static_cast<Node *>(head.exchange(nullptr, std::memory_order_acq_rel)); node != nullptr;)
+			{
+				/* Nodes are linked from the newest to the oldest, wait for producers that have not linked their node yet. */
+				auto next = std::atomic_ref(node->*Next).load(std::memory_order_acquire);
+				for (; next == unlinked(); next = std::atomic_ref(node->*Next).load(std::memory_order_acquire))
+					std::this_thread::yield();
+
+				queue.push_front(std::exchange(node, next));
+			}
+			return queue;
+		}
+
+		std::atomic<void *> head = {};
+
+	private:
+		/* Address of the queue is never a valid node, and is used to mark nodes whose links have not been published yet. */
+		[[nodiscard]] Node *unlinked() const noexcept { return static_cast<Node *>(sentinel()); }
+	};
+}
@@ -4,72 +4,130 @@
 
 #pragma once
 
-#include <functional>
+#include <cstddef>
 #include <utility>
 
 #include "config.hpp"
 
 namespace rod::_detail
 {
-	/* Priority queue implemented as a sorted list. While a more complex data structure will give better
-	 * insert time complexity, it's also going to complicate implementation. Plus the queue is only used
-	 * for sorting timer nodes, and it is not likely that there will be a lot of them at any given time. */
-	template<typename Node, typename Cmp, Node *Node::*Prev, Node *Node::*Next>
+	/* Links of a node within an intrusive `priority_queue`. `prev` points to the left sibling of the node, or to its parent if the node is the leftmost child.
+	 * `seq` is the insertion order of the node, used to order nodes that compare equal. */
+	template<typename Node>
+	struct heap_hook
+	{
+		Node *child = {};
+		Node *next = {};
+		Node *prev = {};
+		std::size_t seq = {};
+	};
+
+	/* Priority queue implemented as an intrusive pairing heap. All links are stored within the nodes, so that the queue never
+	 * allocates, and nodes can be inserted in O(1) and erased from any position (i.e. cancelled timers) in amortized O(log n).
+	 * Nodes that compare equal are popped in the order they have been inserted (i.e. timers with the same timeout elapse in FIFO order). */
+	template<typename Node, typename Cmp, heap_hook<Node> Node::*Hook>
 	struct priority_queue
 	{
 		constexpr priority_queue() noexcept = default;
 		constexpr priority_queue(priority_queue &&other) noexcept { swap(other); }
 		constexpr priority_queue &operator=(priority_queue &&other) noexcept { return (swap(other), *this); }
 
-		[[nodiscard]] constexpr bool empty() const noexcept { return !head; }
-		[[nodiscard]] constexpr Node *front() const noexcept { return head; }
+		[[nodiscard]] constexpr bool empty() const noexcept { return !root; }
+		[[nodiscard]] constexpr Node *front() const noexcept { return root; }
 		[[nodiscard]] constexpr Node *pop_front() noexcept
 		{
-			const auto node = std::exchange(head, head->*Next);
-			if (head) head->*Prev = {};
-			node->*Next = {};
-			node->*Prev = {};
+			const auto node = std::exchange(root, merge_pairs(hook(root).child));
+			hook(node) = {};
 			return node;
 		}
 
+		/* Inserts the node into the queue and returns the new front node. */
 		constexpr Node *insert(Node *node) noexcept
 		{
-			if (!head)
-				head = node;
-			else if (Cmp{}(*node, *head))
+			hook(node) = {};
+			hook(node).seq = next_seq++;
+			return root = root ? meld(root, node) : node;
+		}
+		constexpr void erase(Node *node) noexcept
+		{
+			if (node == root)
 			{
-				node->*Next = head;
-				head->*Prev = node;
-				head = node;
+				static_cast<void>(pop_front());
+				return;
 			}
+
+			/* Unlink the node from its siblings, and meld its children back into the heap. */
+			const auto prev = hook(node).prev;
+			const auto next = hook(node).next;
+			if (hook(prev).child == node)
+				hook(prev).child = next;
 			else
-			{
-				auto prev = head;
-				while (prev->*Next && !Cmp{}(*node, *(prev->*Next)))
-					prev = prev->*Next;
-
-				const auto next = prev->*Next;
-				if (next) next->*Prev = node;
-				node->*Next = next;
-				prev->*Next = node;
-				node->*Prev = prev;
-			}
-			return node;
+				hook(prev).next = next;
+			if (next) hook(next).prev = prev;
+
+			if (const auto children = merge_pairs(hook(node).child); children)
+				root = meld(root, children);
+			hook(node) = {};
 		}
-		constexpr void erase(Node *node) noexcept
+
+		constexpr void swap(priority_queue &other) noexcept
 		{
-			const auto next = std::exchange(node->*Next, {});
-			const auto prev = std::exchange(node->*Prev, {});
-			if (next)
-				next->*Prev = prev;
-			if (prev)
-				prev->*Next = next;
-			else
-				head = next;
+			std::swap(root, other.root);
+			std::swap(next_seq, other.next_seq);
 		}
 
-		constexpr void swap(priority_queue &other) noexcept { std::swap(head, other.head); }
+	private:
+		static constexpr heap_hook<Node> &hook(Node *node) noexcept { return node->*Hook; }
+		static constexpr bool before(Node *a, Node *b) noexcept { return Cmp{}(*a, *b) || (!Cmp{}(*b, *a) && hook(a).seq < hook(b).seq); }
+
+		/* Links two root nodes without siblings, and returns the resulting root. */
+		static constexpr Node *meld(Node *a, Node *b) noexcept
+		{
+			if (before(b, a)) std::swap(a, b);
+			if (const auto child = hook(a).child; child)
+				hook(child).prev = b;
+
+			hook(b).next = hook(a).child;
+			hook(b).prev = a;
+			hook(a).child = b;
+			return a;
+		}
+		/* Melds a list of siblings into a single root using the two-pass pairing strategy. */
+		static constexpr Node *merge_pairs(Node *first) noexcept
+		{
+			if (!first) return nullptr;
+
+			/* First pass melds adjacent pairs from left to right, pushing the results onto a stack linked via `next`. */
+			Node *pairs = nullptr;
+			while (first)
+			{
+				const auto a = first;
+				const auto b = hook(a).next;
+				first = b ? hook(b).next : nullptr;
+
+				hook(a).next = hook(a).prev = nullptr;
+				auto pair = a;
+				if (b)
+				{
+					hook(b).next = hook(b).prev = nullptr;
+					pair = meld(a, b);
+				}
+				hook(pair).next = std::exchange(pairs, pair);
+			}
+
+			/* Second pass melds the pairs from right to left into a single root. */
+			auto result = std::exchange(pairs, hook(pairs).next);
+			hook(result).next = nullptr;
+			while (pairs)
+			{
+				const auto pair = std::exchange(pairs, hook(pairs).next);
+				hook(pair).next = nullptr;
+				result = meld(result, pair);
+			}
+			return result;
+		}
 
-		Node *head = {};
+		Node *root = {};
+		std::size_t next_seq = 0;
 	};
 }
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "../factories/read.hpp"
 
 namespace rod
@@ -25,4 +27,47 @@ namespace rod
 	/** Alias for `decltype(get_allocator(std::declval&lt;T&gt;()))` */
 	template<typename T>
 	using allocator_of_t = std::remove_cvref_t<decltype(get_allocator(std::declval<T>()))>;
+
+	namespace _detail
+	{
+		/* Returns allocator of the environment \a env, or `std::allocator` if the environment does not specify one. */
+		template<typename Env>
+		[[nodiscard]] constexpr auto allocator_from(const Env &env) noexcept
+		{
+			if constexpr (callable<get_allocator_t, const Env &>)
+				return get_allocator_t{}(env);
+			else
+				return std::allocator<std::byte>();
+		}
+		template<typename Env>
+		using env_allocator_t = std::decay_t<decltype(allocator_from(std::declval<const Env &>()))>;
+
+		/* Allocates and constructs an object of type \a T using \a alloc rebound to \a T. */
+		template<typename T, typename Alloc, typename... Args>
+		[[nodiscard]] constexpr T *new_with_allocator(const Alloc &alloc, Args &&...args)
+		{
+			using traits = typename std::allocator_traits<Alloc>::template rebind_traits<T>;
+			auto tmp = typename traits::allocator_type(alloc);
+
+			const auto ptr = traits::allocate(tmp, 1);
+			try { traits::construct(tmp, std::to_address(ptr), std::forward<Args>(args)...); }
+			catch (...)
+			{
+				traits::deallocate(tmp, ptr, 1);
+				throw;
+			}
+			return std::to_address(ptr);
+		}
+		/* Destroys and deallocates an object of type \a T allocated via `new_with_allocator`. \a alloc is taken by value, since it is often stored within the object itself. */
+		template<typename T, typename Alloc>
+		constexpr void delete_with_allocator(Alloc alloc, T *ptr) noexcept
+		{
+			using traits = typename std::allocator_traits<Alloc>::template rebind_traits<T>;
+			auto tmp = typename traits::allocator_type(std::move(alloc));
+
+			const auto mem = std::pointer_traits<typename traits::pointer>::pointer_to(*ptr);
+			traits::destroy(tmp, ptr);
+			traits::deallocate(tmp, mem, 1);
+		}
+	}
 }
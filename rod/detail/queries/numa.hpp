@@ -0,0 +1,33 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#pragma once
+
+#include "scheduler.hpp"
+
+namespace rod
+{
+	/** NUMA node id used to indicate that the NUMA node is not known. */
+	inline constexpr std::size_t unknown_numa_node = static_cast<std::size_t>(-1);
+
+	inline namespace _get_numa_node
+	{
+		struct get_numa_node_t
+		{
+			[[nodiscard]] constexpr friend bool tag_invoke(forwarding_query_t, get_numa_node_t) noexcept { return true; }
+
+			template<typename R> requires tag_invocable<get_numa_node_t, const std::remove_cvref_t<R> &>
+			[[nodiscard]] constexpr std::size_t operator()(R &&r) const noexcept { return tag_invoke(*this, std::as_const(r)); }
+			template<typename R> requires(!tag_invocable<get_numa_node_t, const std::remove_cvref_t<R> &> && _detail::callable<get_scheduler_t, const std::remove_cvref_t<R> &> &&
+			                              tag_invocable<get_numa_node_t, std::invoke_result_t<get_scheduler_t, const std::remove_cvref_t<R> &>>)
+			[[nodiscard]] constexpr std::size_t operator()(R &&r) const noexcept { return tag_invoke(*this, get_scheduler_t{}(std::as_const(r))); }
+			[[nodiscard]] constexpr rod::sender auto operator()() const noexcept { return read(*this); }
+		};
+	}
+
+	/** Customization point object used to obtain the system id of the NUMA node work associated with the passed object is executed on,
+	 * or `unknown_numa_node` if the NUMA node is not known. Environments that do not answer the query directly forward it to their scheduler
+	 * returned by `get_scheduler`, so that node-local allocators and algorithms can query the NUMA node from the environment of a receiver. */
+	inline constexpr auto get_numa_node = get_numa_node_t{};
+}
@@ -0,0 +1,47 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#pragma once
+
+#include "../factories/read.hpp"
+
+namespace rod
+{
+	/** Enum defining priority levels of scheduled work. Schedulers may use any value in between or beyond the named levels, higher values being more urgent. */
+	enum class priority : int
+	{
+		low = -1,
+		normal = 0,
+		high = 1,
+	};
+
+	inline namespace _get_priority
+	{
+		struct get_priority_t
+		{
+			[[nodiscard]] constexpr friend bool tag_invoke(forwarding_query_t, get_priority_t) noexcept { return true; }
+
+			template<typename R> requires tag_invocable<get_priority_t, const std::remove_cvref_t<R> &>
+			[[nodiscard]] constexpr rod::priority operator()(R &&r) const noexcept { return static_cast<rod::priority>(tag_invoke(*this, std::as_const(r))); }
+			[[nodiscard]] constexpr rod::sender auto operator()() const noexcept { return read(*this); }
+		};
+	}
+
+	namespace _detail
+	{
+		/* Returns priority of the environment \a env, or \a def if the environment does not specify one. */
+		template<typename Env>
+		[[nodiscard]] constexpr priority priority_of(const Env &env, priority def = priority::normal) noexcept
+		{
+			if constexpr (callable<get_priority_t, const Env &>)
+				return get_priority_t{}(env);
+			else
+				return def;
+		}
+	}
+
+	/** Customization point object used to obtain priority of work started with the passed environment.
+	 * Schedulers that support prioritization read the priority from the environment of the receiver connected to their schedule sender. */
+	inline constexpr auto get_priority = get_priority_t{};
+}
@@ -35,7 +35,7 @@ namespace rod
 			template<typename T>
 			static constexpr bool has_get_env() noexcept { return !requires { requires bool(int(std::decay_t<T>::do_get_env)); }; }
 			template<typename T>
-			constexpr static auto dispatch_get_env(T &&r) noexcept(noexcept(std::forward<T>(r).get_env())) -> decltype(std::forward<T>(r).do_get_env()) { return std::forward<T>(r).do_get_env(); }
+			constexpr static auto dispatch_get_env(T &&r) noexcept(noexcept(std::forward<T>(r).do_get_env())) -> decltype(std::forward<T>(r).do_get_env()) { return std::forward<T>(r).do_get_env(); }
 
 			static constexpr int do_set_value = 1;
 			static constexpr int do_set_error = 1;
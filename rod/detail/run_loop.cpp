@@ -2,34 +2,68 @@
  * Created by switchblade on 2023-09-29.
  */
 
+#include <algorithm>
 #include <mutex>
 
 #include "run_loop.hpp"
 
 namespace rod::_run_loop
 {
+	/* Bounds of the amount of attempts the consumer makes to find pending work before parking. */
+	constexpr std::uint32_t min_spin = 4;
+	constexpr std::uint32_t max_spin = 256;
+
 	void run_loop::acquire_elapsed_timers() noexcept
 	{
-		for (const auto now = clock::now();;)
+		for (const auto now = clock::now(); !_timer_queue.empty() && _timer_queue.front()->_tp <= now;)
+			_consumer_queue.push_back(_timer_queue.pop_front());
+	}
+	void run_loop::acquire_producer_queue() noexcept
+	{
+		if (_producer_queue.empty())
+			return;
+
+		for (auto queue = task_queue_t(std::move(_producer_queue)); !queue.empty();)
 		{
-			if (_timer_queue.empty())
-			{
-				_next_timeout = {};
-				break;
-			}
-			if (_timer_queue.front()->_tp > now)
+			if (const auto node = queue.pop_front(); node->_is_timer)
+				_timer_queue.insert(static_cast<timer_operation_base *>(node));
+			else
+				_consumer_queue.push_back(node);
+		}
+	}
+	bool run_loop::spin_pending() noexcept
+	{
+		/* Work (or completion of `sync_wait`) often arrives shortly after the consumer runs out of it, in which case spinning avoids the
+		 * round-trip through the semaphore. The limit grows while spinning pays off and decays when it does not, so an idle loop barely spins. */
+		for (std::uint32_t i = 0; i < _spin_limit; ++i)
+		{
+			if (!_producer_queue.empty())
 			{
-				_next_timeout = _timer_queue.front()->_tp;
-				break;
+				_spin_limit = std::min(_spin_limit * 2, max_spin);
+				return true;
 			}
-			_consumer_queue.push_back(_timer_queue.pop_front());
+			std::this_thread::yield();
 		}
+		_spin_limit = std::max(_spin_limit / 2, min_spin);
+		return false;
 	}
-	void run_loop::acquire_producer_queue() noexcept
+	void run_loop::wait_pending() noexcept
 	{
-		if (_producer_queue.empty())
+		/* Timers are not spun on, since they elapse at a known time point. */
+		if (_timer_queue.empty() && spin_pending())
+			return;
+
+		/* Producers only wake up the consumer if they find the producer queue terminated, which is only possible while it is empty. */
+		if (!_producer_queue.try_terminate())
 			return;
-		_consumer_queue.merge_back(std::move(_producer_queue));
+
+		if (const auto front = _timer_queue.front(); !front)
+			_wakeup.acquire();
+		else if (!_wakeup.try_acquire_until(front->_tp) && !_producer_queue.try_activate())
+		{
+			/* A producer has found the queue terminated after the timeout, consume its wakeup to keep the semaphore balanced. */
+			_wakeup.acquire();
+		}
 	}
 
 	std::size_t run_loop::run_once()
@@ -44,61 +78,38 @@ namespace rod::_run_loop
 	}
 	std::size_t run_loop::poll(bool block)
 	{
-		std::lock(_consumer_lock, _mtx);
-		auto g_tid = std::unique_lock(_consumer_lock, std::adopt_lock);
-		auto g_mtx = std::unique_lock(_mtx, std::adopt_lock);
-
-		if (!has_pending() && block) [[unlikely]]
-			for (;;)
-			{
-				const auto wait_condition = [&]() { return has_pending() || !active(); };
-				auto old_timeout = _next_timeout;
-				bool has_timeout = false;
-
-				if (!_timer_queue.empty())
-					 has_timeout = !_cnd.wait_until(g_mtx, old_timeout, wait_condition);
-				else
-					_cnd.wait(g_mtx, wait_condition);
-
-				if (has_timeout && _next_timeout < old_timeout)
-					old_timeout = _next_timeout;
-				else
-					break;
-			}
+		const auto g = std::unique_lock(_consumer_lock);
+		for (;;)
+		{
+			acquire_producer_queue();
+			acquire_elapsed_timers();
 
-		acquire_elapsed_timers();
-		acquire_producer_queue();
-		return _consumer_queue.size;
+			/* Termination of the run loop is handled by the operation scheduled by `finish`. Once it has been dispatched,
+			 * no more wakeups are guaranteed to arrive, so subsequent calls must not block. */
+			if (!block || _finished || !_consumer_queue.empty())
+				return _consumer_queue.size;
+			wait_pending();
+		}
 	}
 
 	void run_loop::schedule(operation_base *node)
 	{
 		if (is_consumer_thread())
-		{
 			_consumer_queue.push_back(node);
-			return;
-		}
-
-		{
-			const auto g = std::unique_lock(_mtx);
-			_producer_queue.push_back(node);
-		}
-		_cnd.notify_one();
+		else if (_producer_queue.push(node))
+			_wakeup.release();
 	}
 	void run_loop::schedule_timer(timer_operation_base *node)
 	{
-		if (is_consumer_thread() && node->_tp <= clock::now())
+		if (!is_consumer_thread())
 		{
-			_consumer_queue.push_back(node);
-			return;
+			/* Timers are inserted into the timer queue by the consumer once it acquires the producer queue. */
+			if (_producer_queue.push(node))
+				_wakeup.release();
 		}
-
-		{
-			const auto g = std::unique_lock(_mtx);
-			if (node->_tp <= _next_timeout)
-				_next_timeout = node->_tp;
+		else if (node->_tp <= clock::now())
+			_consumer_queue.push_back(node);
+		else
 			_timer_queue.insert(node);
-		}
-		_cnd.notify_one();
 	}
 }
\ No newline at end of file
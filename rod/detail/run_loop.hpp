@@ -4,7 +4,7 @@
 
 #pragma once
 
-#include <condition_variable>
+#include <semaphore>
 #include <chrono>
 
 #include "../stop_token.hpp"
@@ -13,7 +13,7 @@
 #include "queries/scheduler.hpp"
 #include "queries/progress.hpp"
 #include "priority_queue.hpp"
-#include "atomic_queue.hpp"
+#include "mpsc_queue.hpp"
 #include "tid_lock.hpp"
 
 namespace rod
@@ -39,7 +39,7 @@ namespace rod
 		protected:
 			using notify_func_t = void (*)(operation_base *) noexcept;
 
-			constexpr operation_base(run_loop *loop, notify_func_t notify) noexcept : _notify_func(notify), _loop(loop) {}
+			constexpr operation_base(run_loop *loop, notify_func_t notify, bool is_timer = false) noexcept : _notify_func(notify), _loop(loop), _is_timer(is_timer) {}
 
 			void notify() noexcept { std::exchange(_notify_func, nullptr)(this); }
 			inline void start() noexcept;
@@ -47,19 +47,20 @@ namespace rod
 			notify_func_t _notify_func;
 			operation_base *_next = {};
 			run_loop *_loop;
+			/* Timers scheduled from outside the consumer thread are passed through the producer queue together with other operations. */
+			bool _is_timer;
 		};
 		class timer_operation_base : public operation_base
 		{
 			friend class run_loop;
 
 		protected:
-			constexpr timer_operation_base(run_loop *loop, notify_func_t notify, time_point tp) noexcept : operation_base(loop, notify), _tp(tp) {}
+			constexpr timer_operation_base(run_loop *loop, notify_func_t notify, time_point tp) noexcept : operation_base(loop, notify, true), _tp(tp) {}
 
 			inline void start() noexcept;
 
 		private:
-			timer_operation_base *_timer_prev = {};
-			timer_operation_base *_timer_next = {};
+			_detail::heap_hook<timer_operation_base> _timer_hook;
 			time_point _tp;
 		};
 		template<typename F>
@@ -170,15 +171,18 @@ namespace rod
 			using clock = _run_loop::clock;
 
 		private:
-			struct timer_cmp { constexpr bool operator()(const timer_operation_base &a, const timer_operation_base &b) const noexcept { return a._tp <= b._tp; }};
-			using timer_queue_t = _detail::priority_queue<timer_operation_base, timer_cmp, &timer_operation_base::_timer_prev, &timer_operation_base::_timer_next>;
+			struct timer_cmp { constexpr bool operator()(const timer_operation_base &a, const timer_operation_base &b) const noexcept { return a._tp < b._tp; }};
+			using timer_queue_t = _detail::priority_queue<timer_operation_base, timer_cmp, &timer_operation_base::_timer_hook>;
 			using task_queue_t = _detail::basic_queue<operation_base, &operation_base::_next>;
+			using producer_queue_t = _detail::mpsc_queue<operation_base, &operation_base::_next>;
+
+			static void notify_finish(operation_base *ptr) noexcept { ptr->_loop->_finished = true; }
 
 		public:
 			run_loop(run_loop &&) = delete;
 			run_loop(const run_loop &) = delete;
 
-			run_loop() noexcept { _active.test_and_set(std::memory_order_relaxed); }
+			run_loop() noexcept : _finish_op(this, notify_finish) {}
 
 			/** Returns a scheduler used to schedule operations and timers to be executed by the run loop. */
 			[[nodiscard]] constexpr scheduler get_scheduler() noexcept { return {this}; }
@@ -189,7 +193,7 @@ namespace rod
 			[[nodiscard]] constexpr in_place_stop_token get_stop_token() const noexcept { return _stop_src.get_token(); }
 
 			/** Returns `true` if the run loop is active, and `false` if `finish` has been called. */
-			[[nodiscard]] bool active() const noexcept { return _active.test(std::memory_order_acquire); }
+			[[nodiscard]] bool active() const noexcept { return _active.load(std::memory_order_acquire); }
 
 			/** Dispatches scheduled operations from the consumer queue.
 			 * @return Amount of scheduled operations dispatched.
@@ -220,7 +224,7 @@ namespace rod
 						else
 							pending = 0;
 					}
-					if (!flag.test(std::memory_order_acquire) && active())
+					if (!flag.test(std::memory_order_acquire) && !_finished)
 						pending += poll(pending == 0);
 					else
 						break;
@@ -229,31 +233,41 @@ namespace rod
 			}
 
 			/** Changes the internal state to stopped and unblocks waiting threads. Any in-progress work will run to completion. */
-			void finish() { _active.clear(std::memory_order_release), _cnd.notify_all(); }
+			void finish()
+			{
+				/* The consumer is stopped by an operation passed through the producer queue rather than by `_active`, so that the
+				 * run loop (which is often owned by the consumer, as with `sync_wait`) cannot be destroyed while `finish` is still accessing it. */
+				if (_active.exchange(false, std::memory_order_acq_rel))
+					schedule(&_finish_op);
+			}
 			/** Sends a stop request to the stop source associated with the run loop. */
 			void request_stop() { _stop_src.request_stop(); }
 
 		private:
 			[[nodiscard]] bool is_consumer_thread() const noexcept { return _consumer_lock.tid.load(std::memory_order_acquire) == std::this_thread::get_id(); }
-			[[nodiscard]] bool has_pending() const noexcept { return !_consumer_queue.empty() || !_producer_queue.empty(); }
 
 			ROD_API_PUBLIC void schedule(operation_base *node);
 			ROD_API_PUBLIC void schedule_timer(timer_operation_base *node);
 
 			void acquire_producer_queue() noexcept;
 			void acquire_elapsed_timers() noexcept;
+			bool spin_pending() noexcept;
+			void wait_pending() noexcept;
 
-			mutable std::mutex _mtx;
-			std::condition_variable _cnd;
 			_detail::tid_lock _consumer_lock;
-
-			std::atomic_flag _active;
+			/* Released by the producer that finds the producer queue terminated by the waiting consumer. */
+			std::binary_semaphore _wakeup{0};
+
+			std::atomic<bool> _active = true;
+			bool _finished = false;
+			/* Adaptive amount of attempts to find pending work before parking, only accessed by the consumer. */
+			std::uint32_t _spin_limit = 16;
+			operation_base _finish_op;
 			in_place_stop_source _stop_src;
 
 			task_queue_t _consumer_queue;
-			task_queue_t _producer_queue;
+			producer_queue_t _producer_queue;
 			timer_queue_t _timer_queue;
-			time_point _next_timeout;
 		};
 
 		constexpr in_place_stop_token tag_invoke(get_stop_token_t, const env &s) noexcept { return s._loop->get_stop_token(); }
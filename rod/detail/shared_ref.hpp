@@ -6,6 +6,7 @@
 
 #include <concepts>
 #include <utility>
+#include <memory>
 #include <atomic>
 
 #include "config.hpp"
@@ -22,7 +23,7 @@ namespace rod::_detail
 		std::atomic<std::size_t> _refs = 1;
 	};
 
-	template<typename T>
+	template<typename T, typename Del = std::default_delete<T>>
 	class shared_handle
 	{
 	public:
@@ -58,7 +59,7 @@ namespace rod::_detail
 
 	private:
 		auto acquire() const noexcept { return _ptr ? static_cast<T *>(static_cast<shared_base *>(_ptr)->acquire()) : _ptr; }
-		void release() { if (_ptr && static_cast<shared_base *>(_ptr)->release()) delete _ptr; }
+		void release() { if (_ptr && static_cast<shared_base *>(_ptr)->release()) Del{}(_ptr); }
 
 		T *_ptr = {};
 	};
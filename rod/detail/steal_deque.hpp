@@ -0,0 +1,104 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <bit>
+
+#include "cache_line.hpp"
+
+namespace rod::_detail
+{
+	/* Bounded Chase-Lev work-stealing deque. The owning thread pushes and pops nodes from the bottom end (LIFO),
+	 * while any other thread may steal nodes from the top end (FIFO). The owning thread may also take nodes from the top end
+	 * in order to consume the deque as a FIFO queue. Memory ordering follows the C11 version from "Correct and Efficient
+	 * Work-Stealing for Weak Memory Models" (Lê et al., 2013). */
+	template<typename Node, std::size_t Size> requires(std::has_single_bit(Size))
+	struct steal_deque
+	{
+		using index_t = std::ptrdiff_t;
+
+		static constexpr std::size_t capacity = Size;
+		static constexpr std::size_t mask = Size - 1;
+
+		[[nodiscard]] bool empty() const noexcept { return size() == 0; }
+		[[nodiscard]] std::size_t size() const noexcept
+		{
+			const auto b = bottom.load(std::memory_order_acquire);
+			const auto t = top.load(std::memory_order_acquire);
+			return b > t ? static_cast<std::size_t>(b - t) : 0;
+		}
+
+		/** Pushes \a node to the bottom of the deque. Returns `false` if the deque is full. Must only be called from the owning thread. */
+		bool push(Node *node) noexcept
+		{
+			const auto b = bottom.load(std::memory_order_relaxed);
+			const auto t = top.load(std::memory_order_acquire);
+			if (b - t >= static_cast<index_t>(Size)) [[unlikely]]
+				return false;
+
+			/* Release store instead of a release fence, which is equivalent here and is understood by thread sanitizers. */
+			buffer[static_cast<std::size_t>(b) & mask].store(node, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_release);
+			return true;
+		}
+		/** Pops a node from the bottom of the deque. Returns `nullptr` if the deque is empty. Must only be called from the owning thread. */
+		[[nodiscard]] Node *pop() noexcept
+		{
+			const auto b = bottom.load(std::memory_order_relaxed) - 1;
+			bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			auto t = top.load(std::memory_order_relaxed);
+
+			if (t > b)
+			{
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			auto node = buffer[static_cast<std::size_t>(b) & mask].load(std::memory_order_relaxed);
+			if (t == b)
+			{
+				/* Last element, race against thieves. */
+				if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					node = nullptr;
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+			return node;
+		}
+		/** Takes the oldest node from the top of the deque, retrying if another thread has won the race for the top node.
+		 * Returns `nullptr` if the deque is empty. Must only be called from the owning thread. */
+		[[nodiscard]] Node *take() noexcept
+		{
+			/* Bottom can only be changed by the owning thread, so it does not need to be re-read between attempts. */
+			const auto b = bottom.load(std::memory_order_relaxed);
+			for (auto t = top.load(std::memory_order_acquire); t < b;)
+			{
+				const auto node = buffer[static_cast<std::size_t>(t) & mask].load(std::memory_order_relaxed);
+				if (top.compare_exchange_weak(t, t + 1, std::memory_order_seq_cst, std::memory_order_acquire))
+					return node;
+			}
+			return nullptr;
+		}
+		/** Steals a node from the top of the deque. Returns `nullptr` if the deque is empty or another thread has won the race for the top node. */
+		[[nodiscard]] Node *steal() noexcept
+		{
+			auto t = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const auto b = bottom.load(std::memory_order_acquire);
+			if (t >= b) return nullptr;
+
+			const auto node = buffer[static_cast<std::size_t>(t) & mask].load(std::memory_order_relaxed);
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return nullptr;
+			return node;
+		}
+
+		alignas(cache_line_size) std::atomic<index_t> top = 0;
+		alignas(cache_line_size) std::atomic<index_t> bottom = 0;
+		alignas(cache_line_size) std::array<std::atomic<Node *>, Size> buffer = {};
+	};
+}
\ No newline at end of file
@@ -2,16 +2,188 @@
  * Created by switchblade on 2023-06-10.
  */
 
+#include <system_error>
+#include <algorithm>
+#include <bit>
+
 #include "thread_pool.hpp"
 
+#if defined(__linux__)
+
+#include <pthread.h>
+#include <dirent.h>
+#include <sched.h>
+#include <cstdio>
+
+#endif
+
 namespace rod::_thread_pool
 {
+	/* Number of attempts an idle worker makes to find work before parking. */
+	constexpr std::size_t spin_count = 64;
+	constexpr std::size_t idle_word_bits = 64;
+	constexpr std::size_t no_worker = static_cast<std::size_t>(-1);
+	/* Every `starvation_quantum` attempts to acquire work, a worker visits priority lanes from the lowest one,
+	 * so that a steady stream of high-priority work cannot starve lower lanes indefinitely. */
+	constexpr std::size_t starvation_quantum = 32;
+
+	/* Statistics counters have a single writer, so a relaxed load and store is sufficient and avoids a locked instruction. */
+	static void bump(std::atomic<std::uint64_t> &counter, std::uint64_t n = 1) noexcept
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+	}
+	static std::int64_t now_ns() noexcept
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+	}
+
+	static std::size_t lane_of(priority prio) noexcept
+	{
+		if (prio > priority::normal)
+			return 0;
+		else if (prio == priority::normal)
+			return 1;
+		else
+			return 2;
+	}
+
+	struct worker_context
+	{
+		thread_pool *pool = {};
+		std::size_t id = {};
+	};
+	static thread_local worker_context this_worker = {};
+
+#if defined(__linux__)
+	/* Parses a sysfs CPU list of the form `0-3,8,10-11`. */
+	static std::vector<std::size_t> read_cpu_list(const char *path)
+	{
+		auto cpus = std::vector<std::size_t>{};
+		const auto file = std::fopen(path, "r");
+		if (file == nullptr) return cpus;
+
+		for (unsigned long first, last;;)
+		{
+			const auto n = std::fscanf(file, "%lu-%lu", &first, &last);
+			if (n < 1) break;
+			for (last = n == 2 ? last : first; first <= last; ++first)
+				cpus.push_back(first);
+			if (std::fgetc(file) != ',') break;
+		}
+		std::fclose(file);
+		return cpus;
+	}
+
+	std::vector<cpu_node> cpu_topology()
+	{
+		cpu_set_t allowed;
+		CPU_ZERO(&allowed);
+		if (::sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+			throw std::system_error(errno, std::system_category());
+
+		auto nodes = std::vector<cpu_node>{};
+		if (const auto dir = ::opendir("/sys/devices/system/node"); dir != nullptr)
+		{
+			while (const auto ent = ::readdir(dir))
+			{
+				std::size_t id;
+				if (char tail; std::sscanf(ent->d_name, "node%zu%c", &id, &tail) != 1)
+					continue;
+
+				char path[64];
+				std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%zu/cpulist", id);
+				auto cpus = read_cpu_list(path);
+				std::erase_if(cpus, [&](auto cpu) { return cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed); });
+				if (!cpus.empty()) nodes.push_back({id, std::move(cpus)});
+			}
+			::closedir(dir);
+		}
+
+		if (nodes.empty())
+		{
+			auto &node = nodes.emplace_back();
+			for (std::size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+				if (CPU_ISSET(cpu, &allowed)) node.cpus.push_back(cpu);
+		}
+		std::ranges::sort(nodes, {}, &cpu_node::id);
+		return nodes;
+	}
+	/* Pins the calling thread to \a cpu, and returns the error code on failure. */
+	static int pin_this_thread(std::size_t cpu) noexcept
+	{
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+	}
+	static std::size_t current_cpu() noexcept
+	{
+		const auto cpu = ::sched_getcpu();
+		return cpu >= 0 ? static_cast<std::size_t>(cpu) : static_cast<std::size_t>(-1);
+	}
+#else
+	std::vector<cpu_node> cpu_topology()
+	{
+		auto nodes = std::vector<cpu_node>(1);
+		for (std::size_t cpu = 0; cpu < std::thread::hardware_concurrency(); ++cpu)
+			nodes.front().cpus.push_back(cpu);
+		return nodes;
+	}
+	static int pin_this_thread(std::size_t) noexcept { return 0; }
+	static std::size_t current_cpu() noexcept { return static_cast<std::size_t>(-1); }
+#endif
+
 	thread_pool::thread_pool() : thread_pool(std::thread::hardware_concurrency()) {}
-	thread_pool::thread_pool(std::size_t size) : _workers(size)
+	thread_pool::thread_pool(std::size_t size) : _workers(size), _idle_mask((size + idle_word_bits - 1) / idle_word_bits), _nodes(1)
+	{
+		_nodes.front().last = size;
+		start_workers();
+	}
+	thread_pool::thread_pool(std::span<const cpu_node> nodes) : _nodes(nodes.size())
+	{
+		std::size_t size = 0;
+		for (std::size_t i = 0; i < nodes.size(); ++i)
+		{
+			_nodes[i].id = nodes[i].id;
+			_nodes[i].first = size;
+			_nodes[i].last = size += nodes[i].cpus.size();
+			for (const auto cpu: nodes[i].cpus)
+			{
+				if (cpu >= _cpu_nodes.size()) _cpu_nodes.resize(cpu + 1, any_node);
+				_cpu_nodes[cpu] = i;
+			}
+		}
+
+		_workers = std::vector<worker_t>(size);
+		_idle_mask = idle_mask_t((size + idle_word_bits - 1) / idle_word_bits);
+		for (std::size_t i = 0; i < nodes.size(); ++i)
+		{
+			for (auto id = _nodes[i].first; id < _nodes[i].last; ++id)
+			{
+				_workers[id].node = i;
+				_workers[id].cpu = nodes[i].cpus[id - _nodes[i].first];
+			}
+		}
+
+		/* Workers pin themselves before executing any work, so that node-local data is first touched from the worker's node. */
+		_pending_pins.store(size, std::memory_order_relaxed);
+		start_workers();
+		for (auto n = _pending_pins.load(std::memory_order_acquire); n != 0; n = _pending_pins.load(std::memory_order_acquire))
+			_pending_pins.wait(n, std::memory_order_acquire);
+
+		if (const auto err = _pin_error.load(std::memory_order_relaxed); err != 0)
+		{
+			stop_all();
+			throw std::system_error(err, std::system_category());
+		}
+	}
+	thread_pool::~thread_pool() { stop_all(); }
+
+	void thread_pool::start_workers()
 	{
 		try
 		{
-			for (std::size_t i = 0; i < size; ++i)
+			for (std::size_t i = 0; i < _workers.size(); ++i)
 				_workers[i].start(this, i);
 		}
 		catch (...)
@@ -20,62 +192,571 @@ namespace rod::_thread_pool
 			throw;
 		}
 	}
-	thread_pool::~thread_pool() { stop_all(); }
+
+	std::size_t thread_pool::this_node() const noexcept
+	{
+		if (this_worker.pool == this)
+			return _workers[this_worker.id].node;
+		else
+			return any_node;
+	}
+	std::size_t thread_pool::numa_node(std::size_t node) const noexcept
+	{
+		if (node == any_node)
+			node = this_node();
+		return node < _nodes.size() ? _nodes[node].id : unknown_numa_node;
+	}
+	std::vector<worker_stats> thread_pool::stats() const
+	{
+		const auto now = clock::now();
+		auto result = std::vector<worker_stats>(_workers.size());
+		for (std::size_t i = 0; i < _workers.size(); ++i)
+		{
+			const auto &counters = _workers[i].counters;
+			auto &stats = result[i];
+
+			stats.executed = counters.executed.load(std::memory_order_relaxed);
+			stats.stolen = counters.stolen.load(std::memory_order_relaxed);
+			stats.failed_steals = counters.failed_steals.load(std::memory_order_relaxed);
+			stats.injected = counters.injected.load(std::memory_order_relaxed);
+			stats.handoffs = counters.handoffs.load(std::memory_order_relaxed);
+			stats.parks = counters.parks.load(std::memory_order_relaxed);
+			for (auto &queue: _workers[i].queues)
+				stats.queue_depth += queue.size();
+
+			stats.idle_time = std::chrono::nanoseconds(counters.idle_ns.load(std::memory_order_relaxed));
+			stats.busy_time = std::max(std::chrono::duration_cast<std::chrono::nanoseconds>(now - _workers[i].started) - stats.idle_time, std::chrono::nanoseconds{});
+			for (std::size_t j = 0; j < worker_stats::latency_buckets; ++j)
+				stats.latency[j] = counters.latency[j].load(std::memory_order_relaxed);
+		}
+		return result;
+	}
+
+	std::size_t thread_pool::external_node() const noexcept
+	{
+		if (_nodes.size() == 1)
+			return 0;
+		if (const auto cpu = current_cpu(); cpu < _cpu_nodes.size() && _cpu_nodes[cpu] != any_node)
+			return _cpu_nodes[cpu];
+
+		/* Spread operations of threads running outside the pool's CPUs between the nodes. */
+		static thread_local std::size_t next_node = 0;
+		return next_node++ % _nodes.size();
+	}
 
 	void thread_pool::finish() noexcept
 	{
 		stop_all();
 		_workers.clear();
 	}
+	void thread_pool::stop_all() noexcept
+	{
+		_stopped.store(true, std::memory_order_seq_cst);
+		for (auto &worker: _workers)
+		{
+			worker.park_word.fetch_add(1, std::memory_order_acq_rel);
+			worker.park_word.notify_one();
+		}
+
+		/* Acquire the timer mutex to make sure the timer thread either observes `_stopped` or is waiting for the notification. */
+		{ const auto g = std::lock_guard(_timer_mtx); }
+		_timer_cnd.notify_all();
+		if (_timer_thread.joinable()) _timer_thread.join();
+
+		/* Join all workers before any of the queues are destroyed, since workers may be stealing from each other.
+		 * Spawned spare threads are detached and must be waited for separately. */
+		{ const auto g = std::lock_guard(_spare_mtx); }
+		_spare_cnd.notify_all();
+		for (auto &worker: _workers) worker.join();
+
+		auto g = std::unique_lock(_spare_mtx);
+		_spare_cnd.wait(g, [&]() { return _spawned_threads == 0; });
+	}
+
+	void thread_pool::push_injected(operation_base *op, node_t &node, std::size_t lane) noexcept
+	{
+		const auto g = std::lock_guard(node.injection_mtx);
+		auto &queue = node.injection_queues[lane];
+		queue.push_back(op);
+		node.injection_sizes[lane].store(queue.size, std::memory_order_relaxed);
+	}
+	operation_base *thread_pool::pop_injected(node_t &node, std::size_t lane) noexcept
+	{
+		/* Avoid taking the lock if the injection queue is known to be empty. */
+		if (node.injection_sizes[lane].load(std::memory_order_relaxed) == 0)
+			return nullptr;
+
+		const auto g = std::lock_guard(node.injection_mtx);
+		auto &queue = node.injection_queues[lane];
+		if (queue.empty())
+			return nullptr;
+
+		const auto op = queue.pop_front();
+		node.injection_sizes[lane].store(queue.size, std::memory_order_relaxed);
+		return op;
+	}
+
+	operation_base *thread_pool::steal_task(std::size_t id, const node_t &node, std::size_t lane) noexcept
+	{
+		/* Steal from the top of other workers' queues, starting at a random victim to spread contention. */
+		const auto n = node.last - node.first;
+		if (n == 0) return nullptr;
+
+		const auto start = _workers[id].next_victim(n);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			const auto victim = node.first + (start + i) % n;
+			if (victim == id) continue;
+
+			if (const auto op = _workers[victim].queues[lane].steal(); op)
+			{
+				bump(_workers[id].counters.stolen);
+				return op;
+			}
+			bump(_workers[id].counters.failed_steals);
+		}
+		return nullptr;
+	}
+	operation_base *thread_pool::acquire_task(std::size_t id) noexcept
+	{
+		auto &worker = _workers[id];
+
+		/* Operations handed off by a waker take priority, since nobody else can pick them up. */
+		if (worker.handoff.load(std::memory_order_relaxed) != nullptr)
+		{
+			bump(worker.counters.handoffs);
+			return worker.handoff.exchange(nullptr, std::memory_order_acq_rel);
+		}
+
+		/* Higher lanes are drained first, except for every `starvation_quantum`-th attempt which starts from the lowest lane. */
+		const auto reverse = ++worker.lane_tick % starvation_quantum == 0;
+		const auto lane_at = [&](std::size_t i) { return reverse ? lane_count - 1 - i : i; };
+
+		/* Local and injected work of the worker's node is cheap to check, and is acquired before stealing from other workers.
+		 * This makes priority ordering approximate, since a busy worker will not steal higher-priority work queued by another worker.
+		 * Local queues are consumed in FIFO order, so that operations scheduled by a busy worker cannot starve older ones. */
+		auto &local = _nodes[worker.node];
+		for (std::size_t i = 0; i < lane_count; ++i)
+		{
+			const auto lane = lane_at(i);
+			if (const auto op = worker.queues[lane].take(); op)
+				return op;
+			if (const auto op = pop_injected(local, lane); op)
+			{
+				bump(worker.counters.injected);
+				return op;
+			}
+		}
+		for (std::size_t i = 0; i < lane_count; ++i)
+		{
+			if (const auto op = steal_task(id, local, lane_at(i)); op)
+				return op;
+		}
+
+		/* Work of the worker's own node is preferred over work of remote nodes to keep memory accesses node-local. */
+		for (std::size_t i = 1; i < _nodes.size(); ++i)
+		{
+			auto &remote = _nodes[(worker.node + i) % _nodes.size()];
+			for (std::size_t j = 0; j < lane_count; ++j)
+			{
+				const auto lane = lane_at(j);
+				if (const auto op = pop_injected(remote, lane); op)
+				{
+					bump(worker.counters.injected);
+					return op;
+				}
+				if (const auto op = steal_task(id, remote, lane); op)
+					return op;
+			}
+		}
+		return nullptr;
+	}
+
+	void thread_pool::park(std::size_t id, operation_base *&node) noexcept
+	{
+		auto &worker = _workers[id];
+		auto &word = _idle_mask[id / idle_word_bits];
+		const auto bit = std::uint64_t{1} << (id % idle_word_bits);
+
+		/* The worker must be marked as idle before the last attempt to acquire work, so that a concurrent
+		 * call to `schedule` either observes the idle bit or the worker observes the newly scheduled operation. */
+		const auto old_park = worker.park_word.load(std::memory_order_acquire);
+		word.fetch_or(bit, std::memory_order_seq_cst);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (!(node = acquire_task(id)) && !_stopped.load(std::memory_order_acquire))
+		{
+			bump(worker.counters.parks);
+			worker.park_word.wait(old_park, std::memory_order_acquire);
+		}
 
+		/* If the bit has already been cleared, the worker was claimed by a waker, which will bump `park_word` after handing off an operation.
+		 * In that case the operation will be picked up from `handoff` by the next call to `acquire_task`. */
+		word.fetch_and(~bit, std::memory_order_acq_rel);
+	}
 	void thread_pool::worker_main(std::size_t id) noexcept
 	{
-		for (;;)
+		if (const auto cpu = _workers[id].cpu; cpu != static_cast<std::size_t>(-1))
+		{
+			if (const auto err = pin_this_thread(cpu); err != 0)
+				_pin_error.store(err, std::memory_order_relaxed);
+			if (_pending_pins.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				_pending_pins.notify_all();
+		}
+		this_worker = {this, id};
+		run_worker(id);
+
+		/* If the worker was taken over while its thread was blocked, the thread continues as a spare. */
+		if (!_stopped.load(std::memory_order_acquire))
+			spare_main();
+		this_worker = {};
+	}
+	void thread_pool::run_worker(std::size_t id) noexcept
+	{
+		/* Exit once the worker is vacated by a `blocking_region` and taken over by another thread. */
+		auto &counters = _workers[id].counters;
+		while (!_stopped.load(std::memory_order_acquire) && this_worker.pool == this)
+		{
+			auto node = acquire_task(id);
+			if (!node)
+			{
+				/* Only the idle path is timed, so that executing operations back-to-back does not require reading the clock. */
+				const auto idle_start = clock::now();
+				for (std::size_t i = 1; !node && i < spin_count; ++i)
+				{
+					std::this_thread::yield();
+					node = acquire_task(id);
+				}
+
+				if (!node) park(id, node);
+				bump(counters.idle_ns, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - idle_start).count()));
+			}
+			if (!node) continue;
+
+			/* The operation may be destroyed by `notify`, so the latency is recorded beforehand. */
+			if (const auto scheduled = node->schedule_time; scheduled != 0)
+			{
+				const auto latency = static_cast<std::uint64_t>(std::max<std::int64_t>(now_ns() - scheduled, 1));
+				bump(counters.latency[std::min<std::size_t>(std::bit_width(latency) - 1, worker_stats::latency_buckets - 1)]);
+			}
+			bump(counters.executed);
+			node->notify(id);
+		}
+	}
+	void thread_pool::spare_main() noexcept
+	{
+		for (auto id = acquire_vacant(); id != any_node; id = acquire_vacant())
+			run_worker(id);
+	}
+
+	std::size_t thread_pool::acquire_vacant() noexcept
+	{
+		auto g = std::unique_lock(_spare_mtx);
+		++_idle_spares;
+		const auto ready = _spare_cnd.wait_for(g, _spare_timeout, [&]() { return _stopped.load(std::memory_order_relaxed) || !_vacant.empty(); });
+		--_idle_spares;
+
+		if (!ready || _stopped.load(std::memory_order_relaxed))
+		{
+			--_extra_threads;
+			return any_node;
+		}
+
+		const auto id = _vacant.back();
+		_vacant.pop_back();
+		this_worker = {this, id};
+		return id;
+	}
+	bool thread_pool::vacate(std::size_t id) noexcept
+	{
+		auto g = std::unique_lock(_spare_mtx);
+		if (_stopped.load(std::memory_order_relaxed))
+			return false;
+
+		/* Prefer idle spare threads, only spawning a new thread if all of them are already taking over other workers. */
+		if (_idle_spares <= _vacant.size())
+		{
+			if (_extra_threads >= _max_spares)
+				return false;
+			try
+			{
+				std::thread{[](thread_pool *pool)
+				{
+					pool->spare_main();
+
+					/* Notify while holding the lock, so that `stop_all` cannot observe the thread as finished before it stops accessing the pool. */
+					const auto l = std::lock_guard(pool->_spare_mtx);
+					--pool->_spawned_threads;
+					pool->_spare_cnd.notify_all();
+				}, this}.detach();
+			}
+			catch (...) { return false; }
+
+			++_spawned_threads;
+			++_extra_threads;
+		}
+
+		_vacant.push_back(id);
+		this_worker = {};
+		g.unlock();
+		_spare_cnd.notify_one();
+		return true;
+	}
+	void thread_pool::reclaim(std::size_t id) noexcept
+	{
+		/* Take the worker back unless it has already been taken over by a spare thread. */
+		const auto g = std::lock_guard(_spare_mtx);
+		if (const auto pos = std::find(_vacant.begin(), _vacant.end(), id); pos != _vacant.end())
+		{
+			_vacant.erase(pos);
+			this_worker = {this, id};
+		}
+	}
+
+	void thread_pool::set_compensation(std::size_t max_threads, std::chrono::milliseconds idle_timeout)
+	{
+		const auto g = std::lock_guard(_spare_mtx);
+		_max_spares = max_threads;
+		_spare_timeout = idle_timeout;
+	}
+
+	blocking_region::blocking_region() noexcept
+	{
+		/* Regions entered by threads not owning a worker, including nested regions, have no effect. */
+		if (const auto ctx = this_worker; ctx.pool && ctx.pool->vacate(ctx.id))
+		{
+			_pool = ctx.pool;
+			_id = ctx.id;
+		}
+	}
+	blocking_region::~blocking_region()
+	{
+		if (_pool) _pool->reclaim(_id);
+	}
+
+	std::size_t thread_pool::claim_idle(std::size_t first, std::size_t last) noexcept
+	{
+		for (auto i = first / idle_word_bits; i * idle_word_bits < last; ++i)
 		{
-			operation_base *node = {};
-			std::size_t i = id;
+			/* Only consider bits of workers within `[first, last)`. */
+			auto range = ~std::uint64_t{};
+			if (i * idle_word_bits < first) range &= range << (first % idle_word_bits);
+			if ((i + 1) * idle_word_bits > last) range &= range >> (idle_word_bits - last % idle_word_bits);
 
-			/* Attempt to retrieve a task from other workers' queues to release any pressure on slow workers. */
-			for (; !node && (i = (i + 1) % size()) != id;)
+			auto &word = _idle_mask[i];
+			for (auto bits = word.load(std::memory_order_relaxed); (bits & range) != 0;)
 			{
-				node = _workers[i].queue.pop();
-				if (node != _workers[i].queue.sentinel())
-					_workers[i].queue.notify_one();
-				else if (node)
-					return;
+				const auto bit = (bits & range) & (~(bits & range) + 1);
+				if (word.compare_exchange_weak(bits, bits & ~bit, std::memory_order_acq_rel, std::memory_order_relaxed))
+					return i * idle_word_bits + static_cast<std::size_t>(std::countr_zero(bit));
 			}
-			/* If other workers do not have any work, wait on this worker's queue. */
-			for (; !node; _workers[id].queue.wait(node))
+		}
+		return no_worker;
+	}
+	std::size_t thread_pool::claim_idle(std::size_t node) noexcept
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		/* Prefer workers of the target node, falling back to any idle worker to avoid leaving the operation waiting while other workers are parked. */
+		if (_nodes.size() > 1)
+		{
+			const auto &target = _nodes[node];
+			if (const auto id = claim_idle(target.first, target.last); id != no_worker)
+				return id;
+		}
+		return claim_idle(0, size());
+	}
+	bool thread_pool::try_handoff(operation_base *op, std::size_t node, std::size_t lane) noexcept
+	{
+		const auto id = claim_idle(node);
+		if (id == no_worker)
+			return false;
+
+		/* The handoff slot may still be occupied if the worker has been claimed before it got to run the previous operation. */
+		auto &worker = _workers[id];
+		if (operation_base *old = nullptr; !worker.handoff.compare_exchange_strong(old, op, std::memory_order_acq_rel))
+			push_injected(op, _nodes[node], lane);
+
+		worker.park_word.fetch_add(1, std::memory_order_acq_rel);
+		worker.park_word.notify_one();
+		return true;
+	}
+	bool thread_pool::wake_one(std::size_t node) noexcept
+	{
+		const auto id = claim_idle(node);
+		if (id == no_worker)
+			return false;
+
+		auto &worker = _workers[id];
+		worker.park_word.fetch_add(1, std::memory_order_acq_rel);
+		worker.park_word.notify_one();
+		return true;
+	}
+
+	void thread_pool::schedule(operation_base *op, std::size_t hint, priority prio) noexcept
+	{
+		/* Operations scheduled from a worker thread go to that worker's local queue and are stolen by idle workers. */
+		auto *worker = this_worker.pool == this ? &_workers[this_worker.id] : nullptr;
+		const auto lane = lane_of(prio);
+		op->schedule_time = _track_latency.load(std::memory_order_relaxed) ? now_ns() : 0;
+		if (worker && (hint == any_node || hint == worker->node) && worker->queues[lane].push(op))
+			wake_one(worker->node);
+		else
+		{
+			const auto node = hint < _nodes.size() ? hint : worker ? worker->node : external_node();
+			if (!try_handoff(op, node, lane))
 			{
-				node = _workers[id].queue.pop();
-				if (node != _workers[id].queue.sentinel())
-					i = id;
-				else if (node)
-					return;
+				/* No parked workers, re-check after publishing the operation to avoid a lost wakeup. */
+				push_injected(op, _nodes[node], lane);
+				wake_one(node);
 			}
-			node->notify(i);
 		}
 	}
-	void thread_pool::schedule(operation_base *node) noexcept
+	void thread_pool::schedule_many(_detail::basic_queue<operation_base, &operation_base::next> batch, std::size_t hint, priority prio) noexcept
 	{
-		const auto next = _next.fetch_add(1, std::memory_order_acq_rel) % size();
+		auto *worker = this_worker.pool == this ? &_workers[this_worker.id] : nullptr;
+		const auto node = hint < _nodes.size() ? hint : worker ? worker->node : external_node();
+		const auto lane = lane_of(prio);
+		const auto pending = batch.size;
+
+		if (_track_latency.load(std::memory_order_relaxed))
+		{
+			const auto schedule_time = now_ns();
+			for (auto op = batch.front(); op; op = op->next)
+				op->schedule_time = schedule_time;
+		}
+
+		/* Fill the local queue of the calling worker first, and splice the rest of the batch into the injection queue under a single lock.
+		 * Operations must be unlinked before they are published, since they may be executed and destroyed immediately after. */
+		if (worker && worker->node == node)
+		{
+			while (!batch.empty())
+			{
+				const auto op = batch.pop_front();
+				if (worker->queues[lane].push(op))
+					continue;
 
-		/* Try to enqueue to an empty worker first to avoid stale threads. */
-		for (std::size_t i = 0; i < size(); ++i)
+				batch.push_front(op);
+				break;
+			}
+		}
+		if (!batch.empty())
 		{
-			const auto id = (next + i) - (next + i) < size() ? 0 : size();
-			if (_workers[id].try_push(node)) return;
+			auto &target = _nodes[node];
+			const auto g = std::lock_guard(target.injection_mtx);
+			auto &queue = target.injection_queues[lane];
+			queue.merge_back(std::move(batch));
+			target.injection_sizes[lane].store(queue.size, std::memory_order_relaxed);
 		}
-		_workers[next].push(node);
+
+		/* Wake up to one worker per queued operation, stopping as soon as there are no parked workers left. */
+		for (std::size_t i = 0; i < pending && wake_one(node); ++i) {}
 	}
-	void thread_pool::schedule_bulk(std::span<bulk_task_base> tasks) noexcept
+	void thread_pool::schedule_bulk(std::span<bulk_task_base> tasks, std::size_t hint, priority prio) noexcept
 	{
-		const auto next = _next.fetch_add(tasks.size(), std::memory_order_acq_rel) % size();
-		for (std::size_t i = 0; i < tasks.size(); ++i)
+		auto *worker = this_worker.pool == this ? &_workers[this_worker.id] : nullptr;
+		const auto node = hint < _nodes.size() ? hint : worker ? worker->node : external_node();
+		const auto is_local = worker && worker->node == node;
+		const auto lane = lane_of(prio);
+		const auto schedule_time = _track_latency.load(std::memory_order_relaxed) ? now_ns() : 0;
+
+		std::size_t pending = 0;
+		for (auto &task: tasks)
 		{
-			const auto pos = (next + i) % size();
-			const auto node = &tasks[i];
-			_workers[pos].push(node);
+			task.schedule_time = schedule_time;
+			if (is_local && worker->queues[lane].push(&task))
+				pending += 1;
+			else if (!try_handoff(&task, node, lane))
+			{
+				push_injected(&task, _nodes[node], lane);
+				pending += 1;
+			}
+		}
+
+		/* Wake up to one worker per queued task, stopping as soon as there are no parked workers left. */
+		while (pending-- != 0 && wake_one(node)) {}
+	}
+
+	void thread_pool::add_timer(timer_operation_base *node) noexcept
+	{
+		auto g = std::unique_lock(_timer_mtx);
+		if (node->state == timer_operation_base::cancelled)
+		{
+			/* Stop has been requested before the timer was queued, complete it immediately. */
+			g.unlock();
+			schedule(node, node->node, node->prio);
+			return;
+		}
+
+		/* The timer thread is started by the first queued timer, so that pools which never schedule timers do not own an extra thread.
+		 * `stop_all` sets `_stopped` before acquiring the timer mutex, so no thread is started once it has joined the timer thread.
+		 * Timers cannot elapse without the timer thread, so failure to start it terminates, as would any exception from `start`. */
+		if (!_timer_thread.joinable() && !_stopped.load(std::memory_order_acquire))
+			_timer_thread = std::jthread{[](auto *pool) { pool->timer_main(); }, this};
+
+		/* Only wake up the timer thread if the inserted timer is the new earliest timer. */
+		node->state = timer_operation_base::queued;
+		if (_timers.insert(node) != node)
+			return;
+
+		g.unlock();
+		_timer_cnd.notify_one();
+	}
+	void thread_pool::cancel_timer(timer_operation_base *node) noexcept
+	{
+		auto g = std::unique_lock(_timer_mtx);
+		switch (node->state)
+		{
+		case timer_operation_base::idle:
+			/* Timer has not been queued yet, `add_timer` will complete it. */
+			node->state = timer_operation_base::cancelled;
+			break;
+		case timer_operation_base::queued:
+			/* The timer thread does not need to be woken up if the earliest timer is erased, it will re-check the queue once the old timeout elapses. */
+			node->state = timer_operation_base::cancelled;
+			_timers.erase(node);
+			g.unlock();
+			schedule(node, node->node, node->prio);
+			break;
+		default:
+			/* Timer has already been scheduled for completion. */
+			break;
+		}
+	}
+	void thread_pool::timer_main() noexcept
+	{
+		const auto is_stopped = [&]() { return _stopped.load(std::memory_order_acquire); };
+		auto g = std::unique_lock(_timer_mtx);
+
+		while (!is_stopped())
+		{
+			if (_timers.empty())
+			{
+				_timer_cnd.wait(g, [&]() { return is_stopped() || !_timers.empty(); });
+				continue;
+			}
+
+			/* Wait until the earliest timer elapses, restarting the wait if an earlier timer is inserted. */
+			const auto timeout = _timers.front()->timeout;
+			if (_timer_cnd.wait_until(g, timeout, [&]() { return is_stopped() || _timers.empty() || _timers.front()->timeout < timeout; }))
+				continue;
+
+			auto elapsed = _detail::basic_queue<operation_base, &operation_base::next>{};
+			for (const auto now = clock::now(); !_timers.empty() && _timers.front()->timeout <= now;)
+			{
+				const auto node = _timers.pop_front();
+				node->state = timer_operation_base::dispatched;
+				elapsed.push_back(node);
+			}
+
+			/* Elapsed timers are scheduled outside of the lock, since scheduling may contend with workers. */
+			g.unlock();
+			while (!elapsed.empty())
+			{
+				const auto node = static_cast<timer_operation_base *>(elapsed.pop_front());
+				schedule(node, node->node, node->prio);
+			}
+			g.lock();
 		}
 	}
 }
\ No newline at end of file
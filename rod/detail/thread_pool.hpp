@@ -4,9 +4,16 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <algorithm>
+#include <chrono>
+#include <vector>
 #include <span>
+#include <mutex>
 
 #include "../scheduling.hpp"
+#include "priority_queue.hpp"
+#include "steal_deque.hpp"
 
 namespace rod
 {
@@ -15,6 +22,12 @@ namespace rod
 		class thread_pool;
 		class scheduler;
 		class sender;
+		class timer_sender;
+		class blocking_region;
+		class schedule_batch;
+
+		using clock = std::chrono::steady_clock;
+		using time_point = typename clock::time_point;
 
 		template<typename, typename, typename, typename>
 		struct bulk_operation { class type; };
@@ -25,9 +38,56 @@ namespace rod
 
 		template<typename>
 		struct operation { class type; };
+		template<typename>
+		struct timer_operation { class type; };
 		template<typename = void>
 		struct env { class type; };
 
+		/** Group of CPUs belonging to the same NUMA node, used to place worker threads of a `thread_pool`. */
+		struct cpu_node
+		{
+			/** System id of the NUMA node. */
+			std::size_t id = 0;
+			/** System ids of the CPUs of the NUMA node. */
+			std::vector<std::size_t> cpus;
+		};
+
+		/** Snapshot of statistics of a worker thread of a `thread_pool`. */
+		struct worker_stats
+		{
+			/** Number of buckets of the latency histogram. Bucket `i` counts operations that have been executed `[2^i, 2^(i+1))`
+			 * nanoseconds after being scheduled, with the last bucket also counting all longer latencies. */
+			static constexpr std::size_t latency_buckets = 32;
+
+			/** Number of operations executed by the worker. */
+			std::uint64_t executed = 0;
+			/** Number of operations the worker has stolen from queues of other workers. */
+			std::uint64_t stolen = 0;
+			/** Number of attempts to steal from another worker that have found its queue empty or lost the race for the operation. */
+			std::uint64_t failed_steals = 0;
+			/** Number of operations the worker has taken from node injection queues. */
+			std::uint64_t injected = 0;
+			/** Number of operations handed off directly to the worker by a waker. */
+			std::uint64_t handoffs = 0;
+			/** Number of times the worker has parked waiting for work. */
+			std::uint64_t parks = 0;
+			/** Number of operations queued in the local queues of the worker at the time of the snapshot. */
+			std::size_t queue_depth = 0;
+
+			/** Time the worker has spent looking for work or parked. */
+			std::chrono::nanoseconds idle_time = {};
+			/** Time the worker has spent not being idle since it has been started. */
+			std::chrono::nanoseconds busy_time = {};
+
+			/** Histogram of latencies between scheduling and execution of operations executed by the worker, see `latency_buckets`.
+			 * Latencies are only collected while latency tracking of the thread pool is enabled. */
+			std::array<std::uint64_t, latency_buckets> latency = {};
+		};
+
+		/** Returns NUMA nodes of the system, with only the CPUs the calling process is allowed to run on (as reported by `sched_getaffinity`).
+		 * Nodes without any allowed CPUs are omitted. If NUMA topology is not available, returns a single node containing all allowed CPUs. */
+		[[nodiscard]] ROD_API_PUBLIC std::vector<cpu_node> cpu_topology();
+
 		struct operation_base
 		{
 			using notify_func_t = void (*)(operation_base *, std::size_t) noexcept;
@@ -36,47 +96,82 @@ namespace rod
 
 			notify_func_t notify_func;
 			operation_base *next = {};
+			/* Time at which the operation has been scheduled in nanoseconds of `clock`, or `0` if latency tracking is disabled. */
+			std::int64_t schedule_time = 0;
 		};
 		struct bulk_task_base : operation_base
 		{
-			constexpr bulk_task_base(const bulk_task_base &) noexcept = default;
-			constexpr bulk_task_base(auto *notify, auto *state) noexcept : operation_base{notify}, state(state) {}
+			void *state = {};
+		};
+		struct schedule_operation_base : operation_base
+		{
+			constexpr schedule_operation_base(notify_func_t notify, thread_pool *pool, std::size_t node, priority prio, bool blocking) noexcept : operation_base{notify}, pool(pool), node(node), prio(prio), blocking(blocking) {}
+
+			thread_pool *pool;
+			std::size_t node;
+			priority prio;
+			bool blocking;
+		};
+		struct timer_operation_base : operation_base
+		{
+			/* State of the timer, guarded by the timer mutex of the thread pool. */
+			enum state_t : std::uint8_t { idle, queued, dispatched, cancelled };
+
+			constexpr timer_operation_base(notify_func_t notify, std::size_t node, priority prio, time_point tp) noexcept : operation_base{notify}, node(node), prio(prio), timeout(tp) {}
+
+			std::size_t node;
+			priority prio;
+			time_point timeout;
+			_detail::heap_hook<timer_operation_base> timer_hook;
+			state_t state = idle;
+		};
+
+		/** RAII guard marking a region of code executed by a worker thread of a `thread_pool` that may block the thread, such as synchronous file IO.
+		 * For the duration of the region the worker's place in the pool is handed over to a compensating thread, so that blocked tasks do not stall other work.
+		 * On exit from the region the worker takes its place back unless it has been taken over already, in which case the thread continues to execute
+		 * the current operation and becomes a compensating thread once it completes. Has no effect if the calling thread is not a worker of a thread pool. */
+		class blocking_region
+		{
+		public:
+			blocking_region(const blocking_region &) = delete;
+			blocking_region &operator=(const blocking_region &) = delete;
+
+			ROD_API_PUBLIC blocking_region() noexcept;
+			ROD_API_PUBLIC ~blocking_region();
 
-			void *state;
+		private:
+			thread_pool *_pool = {};
+			std::size_t _id = {};
 		};
 
+		/* Maximum number of tasks a single bulk operation is split into. Tasks are stored inline within the operation state,
+		 * and iterations are distributed between them dynamically, so this only limits the amount of workers participating in a single bulk operation. */
+		inline constexpr std::size_t max_bulk_tasks = 64;
+
 		template<typename Fn, typename Shape, typename... Args>
 		concept bulk_nothrow = _detail::nothrow_callable<Fn, Shape, Args &...> && std::is_nothrow_constructible_v<_detail::decayed_tuple<Args...>, Args...>;
 
 		template<typename Snd, typename Rcv, typename Shape, typename Fn, typename ThrowTag>
 		struct bulk_shared_state : empty_base<value_types_of_t<Snd, env_of_t<Rcv>, _detail::decayed_tuple, _detail::variant_or_empty>>, empty_base<Rcv>, empty_base<Fn>
 		{
-			static constexpr std::pair<Shape, Shape> split_tasks(Shape n, std::size_t pos, std::size_t size) noexcept
-			{
-				const auto div = n / size;
-				const auto rem = n % size;
-				const auto i = pos < rem ? (div + 1) * pos : (div + 1) * rem + (pos - rem) * div;
-				return std::make_pair(i, div + i + static_cast<Shape>(pos < rem));
-			}
-
 			using data_t = value_types_of_t<Snd, env_of_t<Rcv>, _detail::decayed_tuple, _detail::variant_or_empty>;
 			using data_base = empty_base<data_t>;
 			using func_base = empty_base<Fn>;
 			using rcv_base = empty_base<Rcv>;
 
-			static void notify_task(operation_base *ptr, std::size_t id) noexcept
+			static void notify_task(operation_base *ptr, std::size_t) noexcept
 			{
 				auto &state = *static_cast<bulk_shared_state *>(static_cast<bulk_task_base *>(ptr)->state);
 				if constexpr (ThrowTag::value)
-					try { state.invoke(id); } catch (...) { state.set_exception(); }
+					try { state.invoke(); } catch (...) { state.set_exception(); }
 				else
-					state.invoke(id);
+					state.invoke();
 				state.complete();
 			}
 
 			template<typename Fn2>
-			constexpr bulk_shared_state(thread_pool *pool, Rcv rcv, Shape shape, Fn2 &&fn) noexcept(std::is_nothrow_move_constructible_v<Rcv> && std::is_nothrow_constructible_v<Fn, Fn2>)
-					: rcv_base(std::move(rcv)), func_base(std::forward<Fn2>(fn)), pool(pool), shape(shape), tasks(required_threads(), bulk_task_base{notify_task, this}) {}
+			constexpr bulk_shared_state(thread_pool *pool, std::size_t node, priority prio, Rcv rcv, Shape shape, std::size_t grain, Fn2 &&fn) noexcept(std::is_nothrow_move_constructible_v<Rcv> && std::is_nothrow_constructible_v<Fn, Fn2>)
+					: rcv_base(std::move(rcv)), func_base(std::forward<Fn2>(fn)), pool(pool), node(node), prio(prio), shape(shape), grain(std::max<Shape>(static_cast<Shape>(grain), Shape{1})) {}
 
 			template<typename... Args> requires(!std::same_as<data_t, _detail::empty_variant<>>)
 			constexpr void start_bulk(Args &&...args) noexcept
@@ -106,13 +201,14 @@ namespace rod
 			}
 
 			template<typename F> requires(!std::same_as<data_t, _detail::empty_variant<>>)
-			constexpr void apply(F &&f) noexcept { std::visit([&](auto &tpl) { std::apply([&](auto &...args) { std::invoke(f, args...); }, tpl); }, data_base::value()); }
+			constexpr void apply(F &&f) { std::visit([&](auto &tpl) { std::apply([&](auto &...args) { std::invoke(f, args...); }, tpl); }, data_base::value()); }
 			template<typename F> requires std::same_as<data_t, _detail::empty_variant<>>
-			constexpr void apply(F &&f) noexcept { std::invoke(f); }
+			constexpr void apply(F &&f) { std::invoke(f); }
 
 			constexpr void complete() noexcept
 			{
-				if (done.fetch_add(1, std::memory_order_acq_rel) + 1 < required_threads())
+				/* The state may be destroyed by the last task as soon as `done` is incremented, so the task count must be read beforehand. */
+				if (const auto n = task_count; done.fetch_add(1, std::memory_order_acq_rel) + 1 < n)
 					return;
 
 				if (!has_error.test(std::memory_order_acquire))
@@ -125,25 +221,49 @@ namespace rod
 				if (!has_error.test_and_set(std::memory_order_acq_rel))
 					err = std::current_exception();
 			}
-			constexpr void invoke(std::size_t id) noexcept(ThrowTag::value)
-			{
-				if (has_error.test(std::memory_order_acquire))
-					return;
 
+			/* Claims the next chunk of iterations using guided self-scheduling. Chunks start large and shrink
+			 * as the remaining iterations run out, down to `grain`, so that skewed iterations balance between tasks. */
+			constexpr std::pair<Shape, Shape> claim_chunk() noexcept
+			{
+				for (auto first = cursor.load(std::memory_order_relaxed);;)
+				{
+					if (first >= shape)
+						return {shape, shape};
+
+					const auto remaining = static_cast<Shape>(shape - first);
+					const auto guided = static_cast<Shape>(static_cast<std::size_t>(remaining) / (task_count * 2));
+					const auto n = std::min(std::max(guided, grain), remaining);
+					if (cursor.compare_exchange_weak(first, static_cast<Shape>(first + n), std::memory_order_relaxed))
+						return {first, static_cast<Shape>(first + n)};
+				}
+			}
+			constexpr void invoke() noexcept(!ThrowTag::value)
+			{
 				apply([&](auto &...args)
 				{
-					auto [i, n] = split_tasks(shape, id, required_threads());
-					for (; i != n; ++i) std::invoke(func_base::value(), i, args...);
+					while (!has_error.test(std::memory_order_relaxed))
+					{
+						auto [i, n] = claim_chunk();
+						if (i == n) break;
+
+						for (; i != n; ++i) std::invoke(func_base::value(), i, args...);
+					}
 				});
 			}
 
-			constexpr std::size_t required_threads() const noexcept;
 			inline void start() noexcept;
 
 			thread_pool *pool;
+			std::size_t node;
+			priority prio;
 			Shape shape;
+			Shape grain;
+
+			std::size_t task_count = 0;
+			std::array<bulk_task_base, max_bulk_tasks> tasks = {};
 
-			std::vector<bulk_task_base> tasks;
+			std::atomic<Shape> cursor = {};
 			std::atomic<std::size_t> done = 0;
 
 			std::atomic_flag has_error = {};
@@ -172,29 +292,80 @@ namespace rod
 		};
 
 		template<typename Rcv>
-		class operation<Rcv>::type : operation_base, empty_base<Rcv>
+		class operation<Rcv>::type : public schedule_operation_base, empty_base<Rcv>
 		{
-			static void notify_complete(operation_base *p, std::size_t) noexcept
+			static void complete(Rcv &rcv) noexcept
 			{
-				auto &rcv = static_cast<type *>(p)->empty_base<Rcv>::value();
 				if (rod::get_stop_token(get_env(rcv)).stop_requested())
 					set_stopped(std::move(rcv));
 				else
 					set_value(std::move(rcv));
 			}
+			static void notify_complete(operation_base *p, std::size_t) noexcept
+			{
+				auto &op = *static_cast<type *>(p);
+				if (op.blocking)
+				{
+					/* The region outlives the operation state, which may be destroyed by the completion. */
+					const auto g = blocking_region();
+					complete(op.empty_base<Rcv>::value());
+				}
+				else
+					complete(op.empty_base<Rcv>::value());
+			}
+
+		public:
+			type() = delete;
+			type(const type &) = delete;
+
+			constexpr explicit type(thread_pool *pool, std::size_t node, priority prio, bool blocking, Rcv &&rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>) : schedule_operation_base(notify_complete, pool, node, prio, blocking), empty_base<Rcv>(std::forward<Rcv>(rcv)) {}
+
+			friend void tag_invoke(start_t, type &op) noexcept { op.start(); }
+
+			/* Resolves priority of the operation from the environment of the receiver before it is submitted as a part of a batch. */
+			schedule_operation_base *prepare() noexcept
+			{
+				prio = _detail::priority_of(get_env(empty_base<Rcv>::value()), prio);
+				return this;
+			}
+
+		private:
+			inline void start() noexcept;
+		};
+		template<typename Rcv>
+		class timer_operation<Rcv>::type : timer_operation_base, empty_base<Rcv>
+		{
+			using rcv_base = empty_base<Rcv>;
+
+			static void notify_complete(operation_base *p, std::size_t) noexcept { static_cast<type *>(p)->complete(); }
 
 		public:
 			type() = delete;
 			type(const type &) = delete;
 
-			constexpr explicit type(thread_pool *pool, Rcv &&rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>) : operation_base{notify_complete}, empty_base<Rcv>(std::forward<Rcv>(rcv)), _pool(pool) {}
+			constexpr explicit type(thread_pool *pool, std::size_t node, priority prio, time_point tp, Rcv &&rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>) : timer_operation_base(notify_complete, node, prio, tp), rcv_base(std::forward<Rcv>(rcv)), _pool(pool) {}
 
 			friend void tag_invoke(start_t, type &op) noexcept { op.start(); }
 
 		private:
 			inline void start() noexcept;
+			inline void request_stop();
+
+			void complete() noexcept
+			{
+				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
+					_stop_cb.reset();
+
+				/* Timers are only cancelled by a stop request, in which case the stop token of the receiver is always stopped. */
+				auto &rcv = rcv_base::value();
+				if (rod::get_stop_token(get_env(rcv)).stop_requested())
+					set_stopped(std::move(rcv));
+				else
+					set_value(std::move(rcv));
+			}
 
 			thread_pool *_pool;
+			_detail::stop_cb_adaptor<env_of_t<Rcv>, &type::request_stop> _stop_cb;
 		};
 		template<typename Snd, typename Rcv, typename Shape, typename Fn>
 		class bulk_operation<Snd, Rcv, Shape, Fn>::type
@@ -212,8 +383,8 @@ namespace rod
 			type &operator=(type &&) = delete;
 
 			template<typename Snd2, typename Fn2>
-			constexpr explicit type(thread_pool *pool, Snd2 &&snd, Rcv &&rcv, Shape shape, Fn2 &&fn) noexcept(std::is_nothrow_constructible_v<shared_state_t, thread_pool *, Rcv, Shape, Fn2> && _detail::nothrow_callable<connect_t, Snd, receiver_t>)
-					: _shared_state(pool, std::forward<Rcv>(rcv), shape, std::forward<Fn2>(fn)), _connect_state{connect(std::forward<Snd2>(snd), receiver_t{&_shared_state})} {}
+			constexpr explicit type(thread_pool *pool, std::size_t node, priority prio, Snd2 &&snd, Rcv &&rcv, Shape shape, std::size_t grain, Fn2 &&fn) noexcept(std::is_nothrow_constructible_v<shared_state_t, thread_pool *, std::size_t, priority, Rcv, Shape, std::size_t, Fn2> && _detail::nothrow_callable<connect_t, Snd, receiver_t>)
+					: _shared_state(pool, node, prio, std::forward<Rcv>(rcv), shape, grain, std::forward<Fn2>(fn)), _connect_state{connect(std::forward<Snd2>(snd), receiver_t{&_shared_state})} {}
 
 			friend constexpr void tag_invoke(start_t, type &op) noexcept { start(op._connect_state); }
 
@@ -229,52 +400,120 @@ namespace rod
 			friend struct bulk_shared_state;
 			template<typename>
 			friend struct operation;
+			template<typename>
+			friend struct timer_operation;
+			friend class blocking_region;
+			friend class schedule_batch;
+
+			/* Work is queued into one of the lanes of high, normal and low priority. */
+			static constexpr std::size_t lane_count = 3;
 
 			struct worker_t
 			{
-				using task_queue_t = _detail::atomic_queue<operation_base, &operation_base::next>;
+				using task_queue_t = _detail::steal_deque<operation_base, 1024>;
 
-				void stop() noexcept
-				{
-					if (thread.joinable())
-					{
-						queue.terminate();
-						queue.notify_all();
-					}
-				}
-				void start(thread_pool *pool, std::size_t id) noexcept
+				void start(thread_pool *pool, std::size_t id)
 				{
+					/* Seed the victim selection generator with a distinct odd value for every worker. */
+					rng_state = (id + 1) * 0x9e3779b97f4a7c15ull | 1;
+					started = clock::now();
 					thread = std::jthread{[](auto *pool, auto id) { pool->worker_main(id); }, pool, id};
 				}
+				void join() noexcept { if (thread.joinable()) thread.join(); }
 
-				void push(operation_base *node) noexcept
-				{
-					queue.push(node);
-					queue.notify_one();
-				}
-				bool try_push(operation_base *node) noexcept
+				/* xorshift64 generator used for randomized victim selection. Only accessed by the owning thread. */
+				std::size_t next_victim(std::size_t n) noexcept
 				{
-					if (queue.empty())
-					{
-						push(node);
-						return true;
-					}
-					return false;
+					rng_state ^= rng_state << 13;
+					rng_state ^= rng_state >> 7;
+					rng_state ^= rng_state << 17;
+					return static_cast<std::size_t>(rng_state % n);
 				}
 
+				/* Local queues of every priority lane, ordered from the highest to the lowest priority. */
+				std::array<task_queue_t, lane_count> queues;
+				/* Number of calls to `acquire_task`, used to periodically reverse the order in which lanes are visited. */
+				std::size_t lane_tick = 0;
+				std::uint64_t rng_state = 0;
 				std::jthread thread;
-				task_queue_t queue;
+				/* Index of the node the worker belongs to. */
+				std::size_t node = 0;
+				/* System id of the CPU the worker thread pins itself to before executing any work, or `-1` if the worker is not pinned. */
+				std::size_t cpu = static_cast<std::size_t>(-1);
+
+				/* Incremented by wakers and waited on by the worker while it is parked. */
+				alignas(_detail::cache_line_size) std::atomic<std::uint32_t> park_word = {};
+				/* Operation handed off directly to the worker by the waker that has claimed it. */
+				std::atomic<operation_base *> handoff = {};
+
+				/* Statistics counters are only written by the owning thread, and are incremented without read-modify-write operations. */
+				struct counters_t
+				{
+					std::atomic<std::uint64_t> executed = {};
+					std::atomic<std::uint64_t> stolen = {};
+					std::atomic<std::uint64_t> failed_steals = {};
+					std::atomic<std::uint64_t> injected = {};
+					std::atomic<std::uint64_t> handoffs = {};
+					std::atomic<std::uint64_t> parks = {};
+					std::atomic<std::uint64_t> idle_ns = {};
+					std::array<std::atomic<std::uint64_t>, worker_stats::latency_buckets> latency = {};
+				};
+
+				alignas(_detail::cache_line_size) counters_t counters;
+				time_point started = {};
+			};
+			using injection_queue_t = _detail::basic_queue<operation_base, &operation_base::next>;
+			struct node_t
+			{
+				/* Workers of a node occupy the contiguous range `[first, last)`. */
+				std::size_t first = 0;
+				std::size_t last = 0;
+				/* System id of the NUMA node, or `unknown_numa_node` if the pool has not been initialized from a CPU topology. */
+				std::size_t id = unknown_numa_node;
+
+				/* Operations scheduled from outside the node are pushed to the injection queue of their priority lane. */
+				alignas(_detail::cache_line_size) std::mutex injection_mtx;
+				std::array<injection_queue_t, lane_count> injection_queues;
+				std::array<std::atomic<std::size_t>, lane_count> injection_sizes = {};
 			};
+			using idle_mask_t = std::vector<std::atomic<std::uint64_t>>;
+
+			struct timer_cmp { constexpr bool operator()(const timer_operation_base &a, const timer_operation_base &b) const noexcept { return a.timeout < b.timeout; }};
+			using timer_queue_t = _detail::priority_queue<timer_operation_base, timer_cmp, &timer_operation_base::timer_hook>;
+
+		public:
+			using time_point = _thread_pool::time_point;
+			using clock = _thread_pool::clock;
+
+		public:
+			/** Node index used to indicate that an operation may be executed by a worker of any node. */
+			static constexpr std::size_t any_node = static_cast<std::size_t>(-1);
 
 		public:
 			/** Initializes thread pool with a default number of threads. */
 			ROD_API_PUBLIC thread_pool();
 			/** Initializes thread pool with `size` threads. */
 			ROD_API_PUBLIC thread_pool(std::size_t size);
+			/** Initializes thread pool with one thread per CPU of \a nodes, pinned to that CPU. Workers of the same node
+			 * share a node-local injection queue and prefer stealing work from each other before stealing from other nodes.
+			 * @throw std::system_error If a worker could not be pinned to its CPU.
+			 * @note Pinning of worker threads is currently only supported on Linux. On other platforms workers are grouped by node but are not pinned. */
+			ROD_API_PUBLIC explicit thread_pool(std::span<const cpu_node> nodes);
 			ROD_API_PUBLIC ~thread_pool();
 
-			/** Returns a scheduler used to schedule work to be executed on the thread pool. */
+			/** Returns a scheduler used to schedule work and timers to be executed on the thread pool.
+			 * Timers are serviced by a dedicated timer thread, which schedules elapsed timers to the workers as regular operations. */
 			[[nodiscard]] constexpr scheduler get_scheduler() noexcept;
+			/** Returns a scheduler used to schedule work to be executed by workers of the node at index \a node. */
+			[[nodiscard]] constexpr scheduler get_scheduler(std::size_t node) noexcept;
+			/** Returns a scheduler used to schedule work that may block the worker thread. Operations started via the returned scheduler
+			 * complete within a `blocking_region`, allowing the thread pool to compensate for workers blocked by the continuation. */
+			[[nodiscard]] constexpr scheduler get_blocking_scheduler() noexcept;
+
+			/** Limits the number of compensating threads spawned for workers blocked within a `blocking_region` to \a max_threads, and sets the time
+			 * an idle compensating thread waits for a blocked worker to take over before it exits to \a idle_timeout. Limit of `0` disables spawning of compensating threads.
+			 * By default, up to 512 compensating threads are spawned, which exit after 10 seconds of idling. */
+			ROD_API_PUBLIC void set_compensation(std::size_t max_threads, std::chrono::milliseconds idle_timeout);
 
 			/** Returns copy of the stop source associated with the thread pool. */
 			[[nodiscard]] constexpr in_place_stop_source &get_stop_source() noexcept { return _stop_src; }
@@ -283,6 +522,22 @@ namespace rod
 
 			/** Returns the number of worker threads managed by the thread pool. */
 			[[nodiscard]] std::size_t size() const noexcept { return _workers.size(); }
+			/** Returns the number of nodes worker threads of the thread pool are grouped into. */
+			[[nodiscard]] std::size_t node_count() const noexcept { return _nodes.size(); }
+			/** Returns index of the node of the calling worker thread, or `any_node` if the calling thread is not a worker of this thread pool. */
+			[[nodiscard]] ROD_API_PUBLIC std::size_t this_node() const noexcept;
+			/** Returns system id of the NUMA node of the node at index \a node, or of the node of the calling worker thread if \a node is `any_node`.
+			 * Returns `unknown_numa_node` if the thread pool has not been initialized from a CPU topology, or if the node is not known. */
+			[[nodiscard]] ROD_API_PUBLIC std::size_t numa_node(std::size_t node = any_node) const noexcept;
+
+			/** Returns a snapshot of statistics of every worker thread of the thread pool.
+			 * Statistics are collected by workers without synchronization, so counters of different workers may be captured at slightly different points in time. */
+			[[nodiscard]] ROD_API_PUBLIC std::vector<worker_stats> stats() const;
+			/** Enables or disables collection of the latency histogram of worker statistics.
+			 * Latency tracking requires reading the clock whenever an operation is scheduled and executed, and is disabled by default. */
+			void set_latency_tracking(bool enable) noexcept { _track_latency.store(enable, std::memory_order_relaxed); }
+			/** Returns `true` if collection of the latency histogram of worker statistics is enabled. */
+			[[nodiscard]] bool latency_tracking() const noexcept { return _track_latency.load(std::memory_order_relaxed); }
 
 			/** Changes the internal state to stopped and terminates worker threads.
 			 * @note After a call to `finish` the thread pool will no longer be dispatching scheduled operations. */
@@ -291,57 +546,174 @@ namespace rod
 			void request_stop() { _stop_src.request_stop(); }
 
 		protected:
-			void stop_all() noexcept { for (auto &worker: _workers) { worker.stop(); }}
+			ROD_API_PUBLIC void stop_all() noexcept;
 
 			ROD_API_PUBLIC void worker_main(std::size_t id) noexcept;
-			ROD_API_PUBLIC void schedule(operation_base *node) noexcept;
-			ROD_API_PUBLIC void schedule_bulk(std::span<bulk_task_base> tasks) noexcept;
+			ROD_API_PUBLIC void schedule(operation_base *node, std::size_t hint, priority prio) noexcept;
+			ROD_API_PUBLIC void schedule_many(_detail::basic_queue<operation_base, &operation_base::next> batch, std::size_t hint, priority prio) noexcept;
+			ROD_API_PUBLIC void schedule_bulk(std::span<bulk_task_base> tasks, std::size_t hint, priority prio) noexcept;
+
+			ROD_API_PUBLIC void add_timer(timer_operation_base *node) noexcept;
+			ROD_API_PUBLIC void cancel_timer(timer_operation_base *node) noexcept;
+			ROD_API_PUBLIC void timer_main() noexcept;
+
+			/* Returns the number of workers available to execute operations bound to \a node. */
+			[[nodiscard]] std::size_t node_size(std::size_t node) const noexcept
+			{
+				if (node < _nodes.size() && _nodes[node].last != _nodes[node].first)
+					return _nodes[node].last - _nodes[node].first;
+				else
+					return size();
+			}
+
+		private:
+			void start_workers();
+
+			[[nodiscard]] operation_base *acquire_task(std::size_t id) noexcept;
+			[[nodiscard]] operation_base *steal_task(std::size_t id, const node_t &node, std::size_t lane) noexcept;
+			[[nodiscard]] operation_base *pop_injected(node_t &node, std::size_t lane) noexcept;
+			void push_injected(operation_base *op, node_t &node, std::size_t lane) noexcept;
+			[[nodiscard]] std::size_t external_node() const noexcept;
+
+			void run_worker(std::size_t id) noexcept;
+			void spare_main() noexcept;
+			[[nodiscard]] std::size_t acquire_vacant() noexcept;
+			[[nodiscard]] bool vacate(std::size_t id) noexcept;
+			void reclaim(std::size_t id) noexcept;
+
+			void park(std::size_t id, operation_base *&node) noexcept;
+			[[nodiscard]] std::size_t claim_idle(std::size_t first, std::size_t last) noexcept;
+			[[nodiscard]] std::size_t claim_idle(std::size_t node) noexcept;
+			bool try_handoff(operation_base *op, std::size_t node, std::size_t lane) noexcept;
+			bool wake_one(std::size_t node) noexcept;
 
-			std::atomic<std::size_t> _next = {};
 			std::vector<worker_t> _workers;
+			/* Bitmap of parked workers. Wakers atomically clear a bit to claim the corresponding worker. */
+			idle_mask_t _idle_mask;
+
+			std::vector<node_t> _nodes;
+			/* Maps system CPU ids to node indices, used to select the node of operations scheduled from outside the pool. */
+			std::vector<std::size_t> _cpu_nodes;
+
+			std::atomic<bool> _stopped = {};
+			/* Number of workers that have yet to pin their thread, and the first error reported by a worker that has failed to do so. */
+			std::atomic<std::size_t> _pending_pins = {};
+			std::atomic<int> _pin_error = {};
+			std::atomic<bool> _track_latency = {};
+
+			/* Workers vacated by threads blocked within a `blocking_region` are taken over by spare threads. Spare threads are spawned on demand,
+			 * up to `_max_spares` threads in excess of the pool size, and exit after waiting for a vacant worker for `_spare_timeout`. */
+			std::mutex _spare_mtx;
+			std::condition_variable _spare_cnd;
+			std::vector<std::size_t> _vacant;
+			std::size_t _idle_spares = 0;
+			std::size_t _extra_threads = 0;
+			std::size_t _spawned_threads = 0;
+			std::size_t _max_spares = 512;
+			std::chrono::milliseconds _spare_timeout = std::chrono::seconds(10);
+
+			/* Pending timers are ordered by the timer thread, which waits for the earliest one to elapse. The timer thread is started on first use. */
+			std::mutex _timer_mtx;
+			std::condition_variable _timer_cnd;
+			timer_queue_t _timers;
+			std::jthread _timer_thread;
+
 			in_place_stop_source _stop_src;
 		};
 
 		class scheduler
 		{
+			friend class sender;
+			friend class timer_sender;
+			friend class env<>::type;
+			template<typename Env>
+			friend class env<Env>::type;
+			template<typename Snd, typename Shape, typename Fn>
+			friend class bulk_sender<Snd, Shape, Fn>::type;
+
 			template<typename Snd, typename Shape, typename Fn>
 			using bulk_sender_t = typename bulk_sender<std::decay_t<Snd>, Shape, std::decay_t<Fn>>::type;
 
 		public:
-			constexpr explicit scheduler(thread_pool *pool) noexcept : _pool(pool) {}
+			constexpr explicit scheduler(thread_pool *pool, std::size_t grain = 0, std::size_t node = thread_pool::any_node, rod::priority prio = rod::priority::normal, bool blocking = false) noexcept
+					: _pool(pool), _grain(grain), _node(node), _prio(prio), _blocking(blocking) {}
+
+			/** Returns a copy of this scheduler that splits `bulk` operations into chunks of at least \a grain iterations.
+			 * Chunks are sized dynamically, starting large and shrinking towards \a grain as iterations are consumed.
+			 * Grain of `0` (default) allows chunks of a single iteration, which is preferable for expensive or unevenly-sized iterations. */
+			[[nodiscard]] constexpr scheduler with_bulk_grain(std::size_t grain) const noexcept { return scheduler(_pool, grain, _node, _prio, _blocking); }
+			/** Returns the minimum amount of iterations a `bulk` operation scheduled via this scheduler is split into. */
+			[[nodiscard]] constexpr std::size_t bulk_grain() const noexcept { return _grain; }
+
+			/** Returns a copy of this scheduler that schedules work to workers of the node at index \a node.
+			 * Work bound to a node is queued to that node first, and may only be executed elsewhere if it is stolen by an idle worker of another node.
+			 * Node of `thread_pool::any_node` (default) schedules work to the node of the calling worker, or the node of the calling CPU if called from outside the pool. */
+			[[nodiscard]] constexpr scheduler on_node(std::size_t node) const noexcept { return scheduler(_pool, _grain, node, _prio, _blocking); }
+			/** Returns index of the node work is scheduled to via this scheduler, or `thread_pool::any_node` if the scheduler is not bound to a node. */
+			[[nodiscard]] constexpr std::size_t node() const noexcept { return _node; }
+			/** Returns system id of the NUMA node work is scheduled to via this scheduler. If the scheduler is not bound to a node,
+			 * returns the NUMA node of the calling worker thread, or `unknown_numa_node` if called from outside the thread pool. */
+			[[nodiscard]] std::size_t numa_node() const noexcept { return _pool->numa_node(_node); }
+
+			/** Returns a copy of this scheduler that schedules work with priority \a prio.
+			 * Work is queued into the high, normal or low priority lane depending on the sign of its priority, and workers drain higher lanes first.
+			 * Priority returned by `get_priority` for the environment of the connected receiver takes precedence over the priority of the scheduler. */
+			[[nodiscard]] constexpr scheduler with_priority(rod::priority prio) const noexcept { return scheduler(_pool, _grain, _node, prio, _blocking); }
+			/** Returns priority of work scheduled via this scheduler, unless overridden by the environment of the connected receiver. */
+			[[nodiscard]] constexpr rod::priority priority() const noexcept { return _prio; }
+			/** Returns `true` if operations started via this scheduler complete within a `blocking_region`. */
+			[[nodiscard]] constexpr bool is_blocking() const noexcept { return _blocking; }
+
+			/** Returns the current time point of the clock used by the thread pool. */
+			[[nodiscard]] time_point now() const noexcept { return clock::now(); }
 
 			[[nodiscard]] friend constexpr bool operator==(const scheduler &, const scheduler &) noexcept = default;
 
 			friend constexpr bool tag_invoke(execute_may_block_caller_t, const scheduler &) noexcept { return false; }
 			friend constexpr auto tag_invoke(get_forward_progress_guarantee_t, const scheduler &) noexcept { return forward_progress_guarantee::parallel; }
+			friend std::size_t tag_invoke(get_numa_node_t, const scheduler &s) noexcept { return s.numa_node(); }
 
 			template<decays_to_same<scheduler> T>
 			friend constexpr auto tag_invoke(schedule_t, T &&s) noexcept { return s.schedule(); }
+			template<decays_to_same<scheduler> T, typename Tp> requires std::constructible_from<time_point, Tp>
+			friend constexpr auto tag_invoke(schedule_at_t, T &&s, Tp &&tp) noexcept { return s.schedule_at(time_point(std::forward<Tp>(tp))); }
+			template<decays_to_same<scheduler> T, typename Dur>
+			friend constexpr auto tag_invoke(schedule_after_t, T &&s, Dur &&dur) noexcept { return s.schedule_at(s.now() + dur); }
 			template<decays_to_same<scheduler> T, typename Snd, typename Shape, typename Fn>
 			friend constexpr auto tag_invoke(bulk_t, T &&s, Snd &&snd, Shape shape, Fn &&fn) noexcept { return s.schedule_bulk(std::forward<Snd>(snd), shape, std::forward<Fn>(fn)); }
 
 		private:
-			inline auto schedule() noexcept;
+			inline auto schedule() const noexcept;
+			inline auto schedule_at(time_point tp) const noexcept;
 			template<typename Snd, typename Shape, typename Fn>
-			inline auto schedule_bulk(Snd &&snd, Shape shape, Fn &&fn) noexcept;
+			inline auto schedule_bulk(Snd &&snd, Shape shape, Fn &&fn) const noexcept;
 
 			thread_pool *_pool;
+			std::size_t _grain;
+			std::size_t _node;
+			rod::priority _prio;
+			bool _blocking;
 		};
 
 		constexpr scheduler thread_pool::get_scheduler() noexcept { return scheduler(this); }
+		constexpr scheduler thread_pool::get_scheduler(std::size_t node) noexcept { return scheduler(this, 0, node); }
+		constexpr scheduler thread_pool::get_blocking_scheduler() noexcept { return scheduler(this, 0, any_node, priority::normal, true); }
 
 		template<>
 		class env<>::type
 		{
 		public:
-			constexpr explicit type(thread_pool *pool) noexcept : _pool(pool) {}
+			constexpr explicit type(scheduler sch) noexcept : _sch(sch) {}
 
-			friend constexpr in_place_stop_token tag_invoke(get_stop_token_t, const type &e) noexcept { return e._pool->get_stop_token(); }
+			friend constexpr in_place_stop_token tag_invoke(get_stop_token_t, const type &e) noexcept { return e.get_stop_token(); }
+			friend std::size_t tag_invoke(get_numa_node_t, const type &e) noexcept { return e._sch.numa_node(); }
 			template<typename T>
-			friend constexpr scheduler tag_invoke(get_completion_scheduler_t<T>, const type &e) noexcept { return e._pool->get_scheduler(); }
+			friend constexpr scheduler tag_invoke(get_completion_scheduler_t<T>, const type &e) noexcept { return e._sch; }
 
 		private:
-			thread_pool *_pool;
+			constexpr in_place_stop_token get_stop_token() const noexcept { return _sch._pool->get_stop_token(); }
+
+			scheduler _sch;
 		};
 		template<typename Env>
 		class env<Env>::type : empty_base<Env>
@@ -350,17 +722,20 @@ namespace rod
 
 		public:
 			template<typename Env2>
-			constexpr explicit type(thread_pool *pool, Env2 &&env) noexcept(std::is_nothrow_constructible_v<Env, Env2>) : env_base(std::forward<Env2>(env)), _pool(pool) {}
+			constexpr explicit type(scheduler sch, Env2 &&env) noexcept(std::is_nothrow_constructible_v<Env, Env2>) : env_base(std::forward<Env2>(env)), _sch(sch) {}
 
 			template<is_forwarding_query Q, decays_to_same<type> E, typename... Args> requires _detail::callable<Q, Env, Args...>
 			friend constexpr decltype(auto) tag_invoke(Q, E &&e, Args &&...args) noexcept(_detail::nothrow_callable<Q, Env, Args...>) { return Q{}(std::forward<E>(e).env_base::value(), std::forward<Args>(args)...); }
 
-			friend constexpr in_place_stop_token tag_invoke(get_stop_token_t, const type &e) noexcept { return e._pool->get_stop_token(); }
+			friend constexpr in_place_stop_token tag_invoke(get_stop_token_t, const type &e) noexcept { return e.get_stop_token(); }
+			friend std::size_t tag_invoke(get_numa_node_t, const type &e) noexcept { return e._sch.numa_node(); }
 			template<typename T>
-			friend constexpr scheduler tag_invoke(get_completion_scheduler_t<T>, const type &e) noexcept { return e._pool->get_scheduler(); }
+			friend constexpr scheduler tag_invoke(get_completion_scheduler_t<T>, const type &e) noexcept { return e._sch; }
 
 		private:
-			thread_pool *_pool;
+			constexpr in_place_stop_token get_stop_token() const noexcept { return _sch._pool->get_stop_token(); }
+
+			scheduler _sch;
 		};
 
 		class sender
@@ -374,17 +749,47 @@ namespace rod
 			using operation_t = typename operation<Rcv>::type;
 
 		public:
-			constexpr explicit sender(thread_pool *pool) noexcept : _pool(pool) {}
+			constexpr explicit sender(scheduler sch) noexcept : _sch(sch) {}
 
-			friend constexpr typename env<>::type tag_invoke(get_env_t, const sender &s) noexcept { return typename env<>::type(s._pool); }
+			friend constexpr typename env<>::type tag_invoke(get_env_t, const sender &s) noexcept { return typename env<>::type(s._sch); }
 			template<decays_to_same<sender> T, typename E>
 			friend constexpr signs_t tag_invoke(get_completion_signatures_t, T &&, E) { return {}; }
 
 			template<decays_to_same<sender> T, receiver_of<signs_t> Rcv>
-			friend constexpr operation_t<Rcv> tag_invoke(connect_t, T &&s, Rcv rcv) noexcept(_detail::nothrow_decay_copyable<Rcv>::value) { return operation_t<Rcv>(s._pool, std::move(rcv)); }
+			friend constexpr operation_t<Rcv> tag_invoke(connect_t, T &&s, Rcv rcv) noexcept(_detail::nothrow_decay_copyable<Rcv>::value) { return s.connect(std::move(rcv)); }
 
 		private:
-			thread_pool *_pool;
+			template<typename Rcv>
+			constexpr operation_t<Rcv> connect(Rcv &&rcv) const noexcept(_detail::nothrow_decay_copyable<Rcv>::value) { return operation_t<Rcv>(_sch._pool, _sch._node, _sch._prio, _sch._blocking, std::forward<Rcv>(rcv)); }
+
+			scheduler _sch;
+		};
+		class timer_sender
+		{
+		public:
+			using is_sender = std::true_type;
+
+		private:
+			using signs_t = completion_signatures<set_value_t(), set_stopped_t()>;
+			template<typename Rcv>
+			using operation_t = typename timer_operation<Rcv>::type;
+
+		public:
+			constexpr explicit timer_sender(scheduler sch, time_point tp) noexcept : _sch(sch), _tp(tp) {}
+
+			friend constexpr typename env<>::type tag_invoke(get_env_t, const timer_sender &s) noexcept { return typename env<>::type(s._sch); }
+			template<decays_to_same<timer_sender> T, typename E>
+			friend constexpr signs_t tag_invoke(get_completion_signatures_t, T &&, E) { return {}; }
+
+			template<decays_to_same<timer_sender> T, receiver_of<signs_t> Rcv>
+			friend constexpr operation_t<Rcv> tag_invoke(connect_t, T &&s, Rcv rcv) noexcept(_detail::nothrow_decay_copyable<Rcv>::value) { return s.connect(std::move(rcv)); }
+
+		private:
+			template<typename Rcv>
+			constexpr operation_t<Rcv> connect(Rcv &&rcv) const noexcept(_detail::nothrow_decay_copyable<Rcv>::value) { return operation_t<Rcv>(_sch._pool, _sch._node, _sch._prio, _tp, std::forward<Rcv>(rcv)); }
+
+			scheduler _sch;
+			time_point _tp;
 		};
 		template<typename Snd, typename Shape, typename Fn>
 		class bulk_sender<Snd, Shape, Fn>::type : empty_base<Snd>, empty_base<Fn>
@@ -415,36 +820,112 @@ namespace rod
 
 		public:
 			template<typename Snd2, typename Fn2>
-			constexpr explicit type(thread_pool *pool, Snd2 &&snd, Shape shape, Fn2 &&fn) noexcept(std::is_nothrow_constructible_v<Snd, Snd2> && std::is_nothrow_constructible_v<Fn, Fn2>)
-					: snd_base(std::forward<Snd2>(snd)), func_base(std::forward<Fn2>(fn)), _pool(pool), _shape(shape) {}
+			constexpr explicit type(scheduler sch, Snd2 &&snd, Shape shape, Fn2 &&fn) noexcept(std::is_nothrow_constructible_v<Snd, Snd2> && std::is_nothrow_constructible_v<Fn, Fn2>)
+					: snd_base(std::forward<Snd2>(snd)), func_base(std::forward<Fn2>(fn)), _sch(sch), _shape(shape) {}
 
-			friend constexpr typename env<env_of_t<Snd>>::type tag_invoke(get_env_t, const type &s) noexcept { return typename env<env_of_t<Snd>>::type(s._pool, get_env(s.snd_base::value())); }
+			friend constexpr typename env<env_of_t<Snd>>::type tag_invoke(get_env_t, const type &s) noexcept { return typename env<env_of_t<Snd>>::type(s._sch, get_env(s.snd_base::value())); }
 			template<decays_to_same<type> T, typename Env>
 			friend constexpr signs_t<T, Env> tag_invoke(get_completion_signatures_t, T &&, Env &&) noexcept { return {}; }
 
 			template<decays_to_same<type> T, rod::receiver Rcv> requires receiver_of<Rcv, signs_t<T, env_of_t<Rcv>>>
-			friend constexpr operation_t<T, Rcv> tag_invoke(connect_t, T &&s, Rcv rcv) noexcept(std::is_nothrow_constructible_v<operation_t<T, Rcv>, thread_pool *, copy_cvref_t<T, Snd>, Rcv, Shape, copy_cvref_t<T, Fn>>)
+			friend constexpr operation_t<T, Rcv> tag_invoke(connect_t, T &&s, Rcv rcv) noexcept(std::is_nothrow_constructible_v<operation_t<T, Rcv>, thread_pool *, std::size_t, priority, copy_cvref_t<T, Snd>, Rcv, Shape, std::size_t, copy_cvref_t<T, Fn>>)
 			{
-				return operation_t<T, Rcv>(s._pool,  std::forward<T>(s).snd_base::value(), std::move(rcv), s._shape, std::forward<T>(s).func_base::value());
+				return connect(std::forward<T>(s), std::move(rcv));
 			}
 
 		private:
-			thread_pool *_pool;
+			template<typename T, typename Rcv>
+			static constexpr operation_t<T, Rcv> connect(T &&s, Rcv &&rcv)
+			{
+				return operation_t<T, Rcv>(s._sch._pool, s._sch._node, s._sch._prio, std::forward<T>(s).snd_base::value(), std::forward<Rcv>(rcv), s._shape, s._sch._grain, std::forward<T>(s).func_base::value());
+			}
+
+			scheduler _sch;
 			Shape _shape;
 		};
 
 		template<typename Rcv>
-		void operation<Rcv>::type::start() noexcept { _pool->schedule(this); }
+		void operation<Rcv>::type::start() noexcept { pool->schedule(this, node, _detail::priority_of(get_env(empty_base<Rcv>::value()), prio)); }
+
+		/* Groups consecutive operations sharing the same thread pool, node and priority into batches submitted via `schedule_many`. */
+		class schedule_batch
+		{
+		public:
+			void push(schedule_operation_base *op) noexcept
+			{
+				if (!_queue.empty() && (op->pool != _pool || op->node != _node || op->prio != _prio))
+					flush();
+
+				_pool = op->pool;
+				_node = op->node;
+				_prio = op->prio;
+				_queue.push_back(op);
+			}
+			void flush() noexcept
+			{
+				if (!_queue.empty())
+					_pool->schedule_many(std::exchange(_queue, {}), _node, _prio);
+			}
+
+		private:
+			_detail::basic_queue<operation_base, &operation_base::next> _queue;
+			thread_pool *_pool = {};
+			std::size_t _node = {};
+			priority _prio = {};
+		};
+
+		/* Operations of the thread pool scheduler started together by `start_all` are submitted in bulk. Operation states
+		 * must not be accessed after the last batch has been submitted, since every operation may complete by that point. */
+		template<typename... Ops> requires(std::derived_from<Ops, schedule_operation_base> && ...)
+		void tag_invoke(start_all_t, Ops &...ops) noexcept
+		{
+			auto batch = schedule_batch();
+			(batch.push(ops.prepare()), ...);
+			batch.flush();
+		}
+		template<std::derived_from<schedule_operation_base> Op>
+		void tag_invoke(start_all_t, std::span<Op> ops) noexcept
+		{
+			auto batch = schedule_batch();
+			for (auto &op: ops) batch.push(op.prepare());
+			batch.flush();
+		}
+
+		template<typename Rcv>
+		void timer_operation<Rcv>::type::start() noexcept
+		{
+			prio = _detail::priority_of(get_env(rcv_base::value()), prio);
+
+			/* Initialize the stop callback before the timer is queued, so that it cannot be reset by a concurrent completion of the timer.
+			 * Stop requested before the timer is queued only marks it as cancelled, and the timer is then completed by `add_timer`. */
+			if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
+				_stop_cb.init(get_env(rcv_base::value()), this);
+			_pool->add_timer(this);
+		}
+		template<typename Rcv>
+		void timer_operation<Rcv>::type::request_stop() { _pool->cancel_timer(this); }
 
 		template<typename Snd, typename Rcv, typename Shape, typename Fn, typename ThrowTag>
-		void bulk_shared_state<Snd, Rcv, Shape, Fn, ThrowTag>::start() noexcept { pool->schedule_bulk(tasks); }
-		template<typename Snd, typename Rcv, typename Shape, typename Fn, typename ThrowTag>
-		constexpr std::size_t bulk_shared_state<Snd, Rcv, Shape, Fn, ThrowTag>::required_threads() const noexcept { return std::min(shape, static_cast<Shape>(pool->size())); }
+		void bulk_shared_state<Snd, Rcv, Shape, Fn, ThrowTag>::start() noexcept
+		{
+			/* Do not spawn more tasks than there are grain-sized chunks or workers on the target node. */
+			const auto chunks = static_cast<std::size_t>(shape / grain + static_cast<Shape>(shape % grain != 0));
+			task_count = std::min({chunks, pool->node_size(node), max_bulk_tasks});
+
+			for (std::size_t i = 0; i < task_count; ++i)
+				tasks[i] = {{notify_task}, this};
+			pool->schedule_bulk(std::span(tasks.data(), task_count), node, _detail::priority_of(get_env(rcv_base::value()), prio));
+		}
 
-		auto scheduler::schedule() noexcept { return sender(_pool); }
+		auto scheduler::schedule() const noexcept { return sender(*this); }
+		auto scheduler::schedule_at(time_point tp) const noexcept { return timer_sender(*this, tp); }
 		template<typename Snd, typename Shape, typename Fn>
-		auto scheduler::schedule_bulk(Snd &&snd, Shape shape, Fn &&fn) noexcept { return bulk_sender_t<Snd, Shape, Fn>(_pool, std::forward<Snd>(snd), shape, std::forward<Fn>(fn)); }
+		auto scheduler::schedule_bulk(Snd &&snd, Shape shape, Fn &&fn) const noexcept { return bulk_sender_t<Snd, Shape, Fn>(*this, std::forward<Snd>(snd), shape, std::forward<Fn>(fn)); }
 	}
 
+	using _thread_pool::blocking_region;
+	using _thread_pool::worker_stats;
+	using _thread_pool::cpu_node;
+	using _thread_pool::cpu_topology;
 	using _thread_pool::thread_pool;
 }
\ No newline at end of file
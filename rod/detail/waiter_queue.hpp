@@ -0,0 +1,324 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#pragma once
+
+#include <optional>
+#include <cstdint>
+#include <atomic>
+
+#include "../stop_token.hpp"
+#include "async_base.hpp"
+
+namespace rod
+{
+	namespace _detail
+	{
+		/* Intrusive node of an operation waiting on an asynchronous synchronization primitive. `_notify` is invoked once the wait is over. */
+		struct async_waiter
+		{
+			using notify_func = void (*)(async_waiter *) noexcept;
+
+			notify_func _notify = {};
+			async_waiter *_next = {};
+		};
+
+		/* Notifications of the current thread go through a trampoline, so that a waiter releasing a primitive from within its own notification
+		 * does not notify the next waiter recursively. Instead, the next notification is deferred until the outermost one returns, keeping the stack flat. */
+		struct waiter_trampoline
+		{
+			void handoff(async_waiter *node) noexcept
+			{
+				if (_active)
+				{
+					node->_next = nullptr;
+					(_tail ? _tail->_next : _head) = node;
+					_tail = node;
+					return;
+				}
+
+				for (_active = true;;)
+				{
+					node->_notify(node);
+					if (!(node = _head))
+						break;
+					if (!(_head = node->_next))
+						_tail = nullptr;
+				}
+				_active = false;
+			}
+
+		private:
+			async_waiter *_head = {};
+			async_waiter *_tail = {};
+			bool _active = false;
+		};
+		inline thread_local waiter_trampoline local_trampoline = {};
+
+		/* Waiter of a `waiter_queue`, which may be cancelled while it is queued. `_request` is interpreted by the primitive owning the queue. */
+		struct queued_waiter : async_waiter
+		{
+			enum state_t : char { waiting, granted, cancelled };
+
+			[[nodiscard]] queued_waiter *next() const noexcept { return static_cast<queued_waiter *>(_next); }
+			[[nodiscard]] bool is_granted() const noexcept { return _state.load(std::memory_order_acquire) == granted; }
+
+			std::uint64_t _request = {};
+			std::atomic<state_t> _state = waiting;
+		};
+
+		/* Result of an attempt of a primitive to grant the request of a waiter. Blocked waiters prevent waiters queued after them from being granted. */
+		enum class grant_result { granted, blocked, skipped };
+
+		/* Queue of waiters of an asynchronous synchronization primitive `Derived`, which implements `grant_result try_grant(queued_waiter *)`,
+		 * `void revoke(queued_waiter *)` and optionally `void prepare_request(queued_waiter *)`. Waiters are pushed onto a lock-free stack, and are moved into a FIFO queue by whichever thread is processing
+		 * the queue. Instead of blocking, threads that find the queue being processed increment the pending counter, so that the processing thread
+		 * makes another pass over the queue on their behalf. Notifications are invoked after processing is complete. */
+		template<typename Derived>
+		class waiter_queue
+		{
+		public:
+			waiter_queue(const waiter_queue &) = delete;
+			waiter_queue &operator=(const waiter_queue &) = delete;
+
+			constexpr waiter_queue() noexcept = default;
+
+			/* Invokes the optional `prepare_request` hook of the primitive before the request of the waiter is attempted. */
+			void prepare(queued_waiter *node) noexcept
+			{
+				if constexpr (requires { derived().prepare_request(node); })
+					derived().prepare_request(node);
+			}
+			/* Attempts to grant the request of a waiter without queueing it. Waiters are not allowed to skip the queue. */
+			bool try_immediate(queued_waiter *node) noexcept
+			{
+				if (has_waiters() || derived().try_grant(node) != grant_result::granted)
+					return false;
+				return (node->_state.store(queued_waiter::granted, std::memory_order_relaxed), true);
+			}
+
+			/* Queues the waiter and processes the queue. The waiter will be notified once its request is granted or it is cancelled. */
+			void enqueue(queued_waiter *node) noexcept
+			{
+				_waiters.fetch_add(1);
+				for (auto head = _incoming.load(std::memory_order_relaxed);;)
+				{
+					node->_next = head;
+					if (_incoming.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed))
+						break;
+				}
+				process();
+			}
+			/* Cancels a waiting waiter. Cancelled waiters are removed from the queue and notified by the processing thread. */
+			void cancel(queued_waiter *node) noexcept
+			{
+				auto state = queued_waiter::waiting;
+				if (node->_state.compare_exchange_strong(state, queued_waiter::cancelled, std::memory_order_acq_rel))
+				{
+					_cancelled.fetch_add(1, std::memory_order_release);
+					process();
+				}
+			}
+
+			[[nodiscard]] bool has_waiters() const noexcept { return _waiters.load() != 0; }
+
+			/* Grants requests of queued waiters in FIFO order, until a waiter is blocked. Must be called after the state of the primitive changes
+			 * such that queued requests may be granted. */
+			void process() noexcept
+			{
+				if (_pending.fetch_add(1, std::memory_order_acq_rel) != 0)
+					return;
+
+				queued_waiter *done_head = {}, *done_tail = {};
+				std::size_t done_count = 0;
+
+				for (std::size_t n = 1; n != 0; n = _pending.fetch_sub(n, std::memory_order_acq_rel) - n)
+				{
+					/* Take all incoming waiters at once, and append them to the queue in FIFO order. */
+					if (auto node = _incoming.exchange(nullptr, std::memory_order_acquire); node != nullptr)
+					{
+						const auto last = node;
+						queued_waiter *first = nullptr;
+						while (node != nullptr)
+						{
+							const auto next = node->next();
+							node->_next = std::exchange(first, node);
+							node = next;
+						}
+						link_after(_head, _tail, first);
+						_tail = last;
+					}
+
+					/* Cancelled waiters may be anywhere in the queue, so the whole queue is visited if there are any. */
+					const bool remove_cancelled = _cancelled.load(std::memory_order_acquire) != 0;
+					std::size_t removed = 0;
+					bool blocked = false;
+
+					for (queued_waiter *prev = nullptr, *node = _head; node != nullptr;)
+					{
+						const auto next = node->next();
+						auto unlink = node->_state.load(std::memory_order_acquire) != queued_waiter::waiting;
+						if (unlink)
+							++removed;
+						else if (!blocked)
+						{
+							switch (derived().try_grant(node))
+							{
+							case grant_result::granted:
+							{
+								/* Waiter might have been cancelled concurrently, in which case the grant is returned to the primitive. */
+								auto state = queued_waiter::waiting;
+								if (!node->_state.compare_exchange_strong(state, queued_waiter::granted, std::memory_order_acq_rel))
+									(derived().revoke(node), ++removed);
+								unlink = true;
+								break;
+							}
+							case grant_result::blocked:
+								blocked = true;
+								break;
+							case grant_result::skipped:
+								break;
+							}
+						}
+						else if (!remove_cancelled)
+							break;
+
+						if (unlink)
+						{
+							if (prev != nullptr)
+								prev->_next = next;
+							else
+								_head = next;
+							if (_tail == node)
+								_tail = prev;
+
+							node->_next = nullptr;
+							link_after(done_head, done_tail, node);
+							done_tail = node;
+							++done_count;
+						}
+						else
+							prev = node;
+						node = next;
+					}
+					if (removed != 0)
+						_cancelled.fetch_sub(removed, std::memory_order_release);
+				}
+
+				if (done_count != 0)
+				{
+					_waiters.fetch_sub(done_count);
+					for (auto node = done_head; node != nullptr;)
+						local_trampoline.handoff(std::exchange(node, node->next()));
+				}
+			}
+
+		private:
+			static void link_after(queued_waiter *&head, queued_waiter *tail, queued_waiter *node) noexcept
+			{
+				if (tail != nullptr)
+					tail->_next = node;
+				else
+					head = node;
+			}
+
+			[[nodiscard]] Derived &derived() noexcept { return static_cast<Derived &>(*this); }
+
+			std::atomic<queued_waiter *> _incoming = {};
+			std::atomic<std::size_t> _pending = {};
+			std::atomic<std::size_t> _cancelled = {};
+			std::atomic<std::size_t> _waiters = {};
+
+			/* Accessed only by the processing thread. */
+			queued_waiter *_head = {};
+			queued_waiter *_tail = {};
+		};
+	}
+
+	namespace _waiter_queue
+	{
+		template<typename, typename>
+		struct operation { class type; };
+
+		template<typename Queue, typename Rcv>
+		class operation<Queue, Rcv>::type : _detail::queued_waiter, empty_base<Rcv>
+		{
+			using rcv_base = empty_base<Rcv>;
+
+			struct stop_trigger
+			{
+				void operator()() const noexcept { _op->_queue->cancel(_op); }
+				type *_op;
+			};
+			using stop_cb_t = std::optional<stop_callback_for_t<stop_token_of_t<env_of_t<Rcv> &>, stop_trigger>>;
+
+		public:
+			type(type &&) = delete;
+			type &operator=(type &&) = delete;
+
+			constexpr explicit type(_detail::waiter_queue<Queue> *queue, std::uint64_t request, Rcv &&rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>)
+					: rcv_base(std::forward<Rcv>(rcv)), _queue(queue)
+			{
+				_request = request;
+				_notify = [](async_waiter *ptr) noexcept { static_cast<type *>(ptr)->complete(); };
+			}
+
+			friend void tag_invoke(start_t, type &op) noexcept
+			{
+				auto tok = get_stop_token(get_env(op.rcv_base::value()));
+				if (tok.stop_requested())
+					return set_stopped(std::move(op.rcv_base::value()));
+
+				op._queue->prepare(&op);
+				if (op._queue->try_immediate(&op))
+					return set_value(std::move(op.rcv_base::value()));
+
+				/* The stop callback may cancel the waiter before it is queued, in which case it is notified once the queue is processed. */
+				if (tok.stop_possible())
+					op._stop_cb.emplace(std::move(tok), stop_trigger{&op});
+				op._queue->enqueue(&op);
+			}
+
+		private:
+			void complete() noexcept
+			{
+				_stop_cb.reset();
+				if (is_granted())
+					set_value(std::move(rcv_base::value()));
+				else
+					set_stopped(std::move(rcv_base::value()));
+			}
+
+			_detail::waiter_queue<Queue> *_queue;
+			stop_cb_t _stop_cb;
+		};
+
+		/* Sender that waits until the request of a waiter is granted by the primitive `Queue`. */
+		template<typename Queue>
+		class sender
+		{
+			template<typename Rcv>
+			using operation_t = typename operation<Queue, Rcv>::type;
+
+		public:
+			using is_sender = std::true_type;
+			using signs_t = completion_signatures<set_value_t(), set_stopped_t()>;
+
+		public:
+			constexpr explicit sender(_detail::waiter_queue<Queue> *queue, std::uint64_t request = {}) noexcept : _queue(queue), _request(request) {}
+
+			template<decays_to_same<sender> T, typename Env>
+			friend constexpr signs_t tag_invoke(get_completion_signatures_t, T &&, Env) noexcept { return {}; }
+			template<decays_to_same<sender> T, rod::receiver_of<signs_t> Rcv>
+			friend constexpr operation_t<Rcv> tag_invoke(connect_t, T &&s, Rcv rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>)
+			{
+				return operation_t<Rcv>{s._queue, s._request, std::move(rcv)};
+			}
+
+		private:
+			_detail::waiter_queue<Queue> *_queue;
+			std::uint64_t _request;
+		};
+	}
+}
@@ -8,6 +8,9 @@
 
 #ifdef ROD_HAS_COROUTINES
 
+#include <span>
+
+#include "detail/frame_allocator.hpp"
 #include "scheduling.hpp"
 
 namespace rod
@@ -106,7 +109,7 @@ namespace rod
 			static_assert(!std::is_void_v<T>, "Cannot generate `void`");
 
 		public:
-			using promise_type = promise<T, std::allocator<void>>;
+			using promise_type = promise<T, frame_allocator<void>>;
 			template<typename Alloc>
 			using allocator_promise_type = promise<T, Alloc>;
 
@@ -147,7 +150,8 @@ namespace rod
 
 	/** Generator range, whose iterator resumes the associated coroutine on increment and returns the yielded result on dereference.
 	 * @note Generators must yield a value repeatedly, and as such cannot `co_return` anything other than `void`.
-	 * @note Generators must yield synchronously, and as such cannot be suspended via `co_await`. */
+	 * @note Generators must yield synchronously, and as such cannot be suspended via `co_await`.
+	 * @note Coroutine frames are allocated using `frame_allocator`, unless an allocator is passed after `std::allocator_arg`. */
 	template<typename T>
 	using generator = _generator::generator<T>;
 
@@ -159,10 +163,24 @@ namespace rod
 		class yield_awaiter;
 		template<typename T>
 		class iterator;
+		template<typename T>
+		class batch_awaiter;
 
 		template<typename T>
 		class generator_task;
 
+#ifdef ROD_HAS_INLINE_RESUME
+		/* Producer being resumed by the consumer on the current thread. Lives on the stack of the consumer's `await_suspend`, so that a value
+		 * yielded from within the resumption returns control to the consumer, instead of resuming it from within the producer. Otherwise,
+		 * every value would nest a resumption on the stack unless the compiler turns the symmetric transfer into a tail call, which it does not at -O0. */
+		struct resume_frame
+		{
+			const void *promise;
+			bool yielded = false;
+		};
+		inline thread_local resume_frame *current_resume = nullptr;
+#endif
+
 		template<typename T>
 		class promise_base
 		{
@@ -170,6 +188,8 @@ namespace rod
 			friend class yield_awaiter;
 			template<typename>
 			friend class next_awaiter;
+			template<typename>
+			friend class iterator;
 
 			using stop_func = std::coroutine_handle<> (*)(void *) noexcept;
 
@@ -224,16 +244,25 @@ namespace rod
 				return _stop_func(_consumer.address());
 			}
 
-			yield_awaiter<T> yield_value(value_type &&value) noexcept { return (_result = std::addressof(value), await_yield()); }
-			yield_awaiter<T> yield_value(value_type &value) noexcept requires(!std::is_rvalue_reference_v<T>) { return (_result = std::addressof(value), await_yield()); }
+			yield_awaiter<T> yield_value(value_type &&value) noexcept { return yield_batch(std::addressof(value), 1); }
+			yield_awaiter<T> yield_value(value_type &value) noexcept requires(!std::is_rvalue_reference_v<T>) { return yield_batch(std::addressof(value), 1); }
+			/* Batch of values is iterated by the consumer without resuming the producer. Empty batches are skipped without suspending. */
+			yield_awaiter<T> yield_value(std::span<value_type> batch) noexcept { return batch.empty() ? yield_awaiter<T>{} : yield_batch(batch.data(), batch.size()); }
 
-			reference value() const noexcept { return static_cast<reference>(*static_cast<T *>(_result)); }
+			reference value() const noexcept { return static_cast<reference>(*_result); }
+			std::span<value_type> values() const noexcept { return {_result, _result_end}; }
 
 #ifndef ROD_HAS_INLINE_RESUME
 			bool cancel() noexcept { return _state.exchange(cancelled, std::memory_order_acq_rel) == (value_ready | producer_suspended); }
 #endif
 
 		protected:
+			yield_awaiter<T> yield_batch(value_type *data, std::size_t size) noexcept
+			{
+				_result = data;
+				_result_end = data + size;
+				return await_yield();
+			}
 			inline yield_awaiter<T> await_yield() noexcept;
 
 			template<typename Other>
@@ -259,7 +288,8 @@ namespace rod
 			std::coroutine_handle<> _consumer = {};
 			std::exception_ptr _err = {};
 			stop_func _stop_func = {};
-			void *_result = {};
+			value_type *_result = {};
+			value_type *_result_end = {};
 		};
 
 		template<typename T>
@@ -286,11 +316,19 @@ namespace rod
 #ifdef ROD_HAS_INLINE_RESUME
 			constexpr bool await_ready() const noexcept { return false; }
 			template<typename P>
-			std::coroutine_handle<> await_suspend(std::coroutine_handle<P> consumer) noexcept
+			bool await_suspend(std::coroutine_handle<P> consumer) noexcept
 			{
 				_promise->_consumer = consumer;
 				_promise->bind(consumer);
-				return _producer;
+
+				auto frame = resume_frame{_promise};
+				const auto prev = std::exchange(current_resume, &frame);
+				_producer.resume();
+				current_resume = prev;
+
+				/* If the producer has yielded inline, the consumer continues by returning `false`. Otherwise the producer has suspended
+				 * and will resume the consumer once it yields, in which case the awaiter may already be destroyed and must not be accessed. */
+				return !frame.yielded;
 			}
 #else
 			constexpr bool await_ready() const noexcept { return _state == (state_t::value_ready | state_t::producer_suspended); }
@@ -344,11 +382,23 @@ namespace rod
 #endif
 
 		public:
+			/* Default-constructed awaiter does not suspend the producer. */
+			constexpr yield_awaiter() noexcept = default;
+
 #ifdef ROD_HAS_INLINE_RESUME
-			yield_awaiter(std::coroutine_handle<> consumer) noexcept : _consumer(consumer) {}
+			yield_awaiter(promise_base<T> &promise) noexcept : _promise(&promise) {}
 
-			constexpr bool await_ready() const noexcept { return false; }
-			std::coroutine_handle<> await_suspend(std::coroutine_handle<>) noexcept { return _consumer; }
+			constexpr bool await_ready() const noexcept { return !_promise; }
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<>) noexcept
+			{
+				/* Return to the consumer driving this producer, or transfer to the consumer if the producer has been resumed elsewhere (i.e. by an awaited sender). */
+				if (const auto frame = current_resume; frame != nullptr && frame->promise == _promise)
+				{
+					frame->yielded = true;
+					return std::noop_coroutine();
+				}
+				return _promise->_consumer;
+			}
 #else
 			yield_awaiter(promise_base<T> &promise, std::size_t state) noexcept : _promise(&promise), _state(state) {}
 
@@ -392,11 +442,9 @@ namespace rod
 			constexpr void await_resume() noexcept {}
 
 		private:
-#ifdef ROD_HAS_INLINE_RESUME
-			std::coroutine_handle<> _consumer;
-#else
-			promise_base<T> *_promise;
-			std::size_t _state;
+			promise_base<T> *_promise = {};
+#ifndef ROD_HAS_INLINE_RESUME
+			std::size_t _state = {};
 #endif
 		};
 
@@ -415,8 +463,12 @@ namespace rod
 		class iterator_awaiter : public next_awaiter<T>
 		{
 		public:
+			/* Awaiter of an iterator advanced within the current batch does not resume the producer. */
+			explicit iterator_awaiter(iterator<T> &iter, std::false_type) noexcept : _iter(iter) {}
 			explicit iterator_awaiter(iterator<T> &iter) noexcept : next_awaiter<T>(iter._handle.promise(), iter._handle), _iter(iter) {}
 
+			bool await_ready() const noexcept { return !next_awaiter<T>::_producer || next_awaiter<T>::await_ready(); }
+
 			inline iterator<T> &await_resume();
 
 		private:
@@ -438,20 +490,41 @@ namespace rod
 			using difference_type = std::ptrdiff_t;
 
 		private:
-			iterator(std::coroutine_handle<promise_base<T>> h) noexcept : _handle(h) {}
+			iterator(std::coroutine_handle<promise_base<T>> h) noexcept : _handle(h), _pos(h.promise()._result), _end(h.promise()._result_end) {}
 
 		public:
 			constexpr iterator() noexcept = default;
 
-			iterator_awaiter<T> operator++() noexcept { return iterator_awaiter<T>{*this}; }
+			/** Returns an awaiter that advances the iterator to the next value of the current batch, or resumes the generator to obtain the next batch. */
+			iterator_awaiter<T> operator++() noexcept
+			{
+				if (++_pos != _end)
+					return iterator_awaiter<T>{*this, std::false_type{}};
+				else
+					return iterator_awaiter<T>{*this};
+			}
 
-			[[nodiscard]] reference operator*() const noexcept { return _handle.promise().value(); }
-			[[nodiscard]] pointer operator->() const noexcept { return std::addressof(operator*()); }
+			[[nodiscard]] reference operator*() const noexcept { return static_cast<reference>(*_pos); }
+			[[nodiscard]] pointer operator->() const noexcept { return _pos; }
 
 			[[nodiscard]] friend constexpr bool operator==(const iterator &, const iterator &) noexcept = default;
 
 		private:
 			std::coroutine_handle<promise_base<T>> _handle = {};
+			value_type *_pos = {};
+			value_type *_end = {};
+		};
+
+		template<typename T>
+		class batch_awaiter : public next_awaiter<T>
+		{
+		public:
+			constexpr batch_awaiter() noexcept = default;
+			explicit batch_awaiter(std::coroutine_handle<promise_base<T>> h) noexcept : next_awaiter<T>(h.promise(), h) {}
+
+			bool await_ready() const noexcept { return !next_awaiter<T>::_producer || next_awaiter<T>::await_ready(); }
+
+			inline std::span<typename promise_base<T>::value_type> await_resume();
 		};
 
 		template<typename T, typename Alloc>
@@ -469,7 +542,7 @@ namespace rod
 			static_assert(!std::is_void_v<T>, "Cannot generate `void`");
 
 		public:
-			using promise_type = promise<T, std::allocator<void>>;
+			using promise_type = promise<T, frame_allocator<void>>;
 			template<typename Alloc>
 			using allocator_promise_type = promise<T, Alloc>;
 
@@ -498,6 +571,11 @@ namespace rod
 			/** Returns sentinel for the iterator produced by the `begin` awaiter. */
 			[[nodiscard]] iterator end() noexcept { return iterator{}; }
 
+			/** Returns awaiter object that resumes the generator, then returns the next batch of values yielded by it, or an empty span once the generator is complete.
+			 * Values yielded individually are returned as a batch of one value. Returned values are valid until the generator is resumed again.
+			 * @note Generator should be consumed either via `next_batch` or via iterators, but not both. */
+			[[nodiscard]] batch_awaiter<T> next_batch() noexcept { return _handle && !_handle.done() ? batch_awaiter<T>{_handle} : batch_awaiter<T>{}; }
+
 			/** Releases the underlying coroutine handle. */
 			std::coroutine_handle<> release() { return std::exchange(_handle, std::coroutine_handle<promise_base<T>>{}); }
 
@@ -512,7 +590,7 @@ namespace rod
 		yield_awaiter<T> promise_base<T>::await_yield() noexcept
 		{
 #ifdef ROD_HAS_INLINE_RESUME
-			return yield_awaiter<T>{_consumer};
+			return yield_awaiter<T>{*this};
 #else
 			auto state = _state.load(std::memory_order_acquire);
 			if (state == state_t{}) state = resume_consumer();
@@ -541,13 +619,29 @@ namespace rod
 		template<typename T>
 		iterator<T> &iterator_awaiter<T>::await_resume()
 		{
-			if (next_awaiter<T>::_promise->done())
+			if (!next_awaiter<T>::_promise)
+				return _iter;
+			else if (next_awaiter<T>::_promise->done())
 			{
 				_iter = iterator<T>{};
 				next_awaiter<T>::_promise->rethrow_exception();
 			}
+			else
+				_iter = iterator<T>{_iter._handle};
 			return _iter;
 		}
+		template<typename T>
+		std::span<typename promise_base<T>::value_type> batch_awaiter<T>::await_resume()
+		{
+			if (!next_awaiter<T>::_promise)
+				return {};
+			else if (next_awaiter<T>::_promise->done())
+			{
+				next_awaiter<T>::_promise->rethrow_exception();
+				return {};
+			}
+			return next_awaiter<T>::_promise->values();
+		}
 
 		template<typename T, typename Alloc>
 		generator_task<T> promise<T, Alloc>::get_return_object() noexcept { return generator_task<T>{std::coroutine_handle<promise>::from_promise(*this)}; }
@@ -555,7 +649,8 @@ namespace rod
 
 	/** Generator task coroutine, whose iterator returns an awaitable on increment and returns the yielded result on dereference.
 	 * @note Generator tasks must yield a value repeatedly, and as such cannot `co_return` anything other than `void`.
-	 * @note Generator tasks return awaitable iterators, and as such can be suspended via `co_await`. */
+	 * @note Generator tasks return awaitable iterators, and as such can be suspended via `co_await`.
+	 * @note Generator tasks may yield a `std::span` of values, which are then iterated without resuming the coroutine for every value. */
 	template<typename T>
 	using generator_task = _generator_task::generator_task<T>;
 }
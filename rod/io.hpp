@@ -12,8 +12,7 @@
 #if defined(ROD_WIN32)
 #include "win32/iocp_context.hpp"
 #endif
-#if defined(__linux__) && 0
-#include "linux/epoll_context.hpp"
+#if defined(__linux__)
 #include "linux/io_uring_context.hpp"
 #endif
 
@@ -21,7 +20,7 @@ namespace rod
 {
 #if defined(ROD_WIN32)
 	using system_context = iocp_context;
-#elif defined(ROD_HAS_LIBURING) && 0
+#elif defined(ROD_HAS_LIBURING)
 	using system_context = io_uring_context;
 #elif defined(ROD_HAS_EPOLL) && 0
 	using system_context = epoll_context;
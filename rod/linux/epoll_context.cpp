@@ -120,8 +120,6 @@ namespace rod::_epoll
 
 	void context::add_timer(timer_operation_base *node) noexcept
 	{
-		assert(!node->timer_next);
-		assert(!node->timer_prev);
 		/* Process pending timers if the inserted timer is the new front. */
 		_timer_pending |= _timers.insert(node) == node;
 	}
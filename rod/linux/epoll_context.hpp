@@ -86,8 +86,7 @@ namespace rod
 
 			[[nodiscard]] bool stop_possible() const noexcept { return flags.load(std::memory_order_relaxed) & flags_t::stop_possible; }
 
-			timer_operation_base *timer_prev = {};
-			timer_operation_base *timer_next = {};
+			_detail::heap_hook<timer_operation_base> timer_hook;
 			std::atomic<int> flags = {};
 			time_point timeout = {};
 			context *ctx;
@@ -123,8 +122,8 @@ namespace rod
 			using clock = _epoll::clock;
 
 		private:
-			struct timer_cmp { constexpr bool operator()(const timer_operation_base &a, const timer_operation_base &b) const noexcept { return a.timeout <= b.timeout; }};
-			using timer_queue_t = _detail::priority_queue<timer_operation_base, timer_cmp, &timer_operation_base::timer_prev, &timer_operation_base::timer_next>;
+			struct timer_cmp { constexpr bool operator()(const timer_operation_base &a, const timer_operation_base &b) const noexcept { return a.timeout < b.timeout; }};
+			using timer_queue_t = _detail::priority_queue<timer_operation_base, timer_cmp, &timer_operation_base::timer_hook>;
 			using producer_queue_t = _detail::atomic_queue<operation_base, &operation_base::next>;
 			using consumer_queue_t = _detail::basic_queue<operation_base, &operation_base::next>;
 
@@ -6,18 +6,15 @@
 
 #ifdef ROD_HAS_LIBURING
 
+#include <algorithm>
 #include <cassert>
 
 #include <sys/eventfd.h>
 #include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
 #include <liburing.h>
-
-/* TODO: Figure out why Valgrind causes a deadlock.
- * Valdrind invoked with callgrind also deadlocks, even though it should only track function calls.
- * Simulating slowdown via sleep(1) does not deadlock, nor does deadlock happen under normal operation.
- *
- * Neither CLang's -fsanitize=address nor -fsanitize=memory cause this deadlock, and neither does it
- * happen under normal operation. I have no clue what the hell is happening when running through Valgrind. */
+#include <poll.h>
 
 namespace rod::_io_uring
 {
@@ -27,64 +24,138 @@ namespace rod::_io_uring
 	constexpr std::size_t default_entries = 128;
 #endif
 
-	enum event_id : std::uint64_t { timer_timeout = 1, queue_dispatch, timer_cancel };
+#ifndef IORING_SQ_TASKRUN
+	constexpr unsigned IORING_SQ_TASKRUN = 0;
+#endif
+#ifndef IORING_CQE_F_MORE
+	constexpr unsigned IORING_CQE_F_MORE = 0;
+#endif
+
+	enum event_id : std::uint64_t { timer_timeout = 1, queue_dispatch, queue_message, timer_cancel, io_cancel, io_timeout };
+	/* Results of messages sent to other rings use the destination context pointer tagged with the lowest bit. */
+	constexpr std::uint64_t message_tag = 1;
+
+	/* Context whose consumer thread is the current thread, used to notify other contexts via messages instead of their eventfd. */
+	static thread_local context *local_context = nullptr;
+
+	static_assert(sizeof(kernel_timespec_t) == sizeof(__kernel_timespec) && alignof(kernel_timespec_t) == alignof(__kernel_timespec));
+
+	[[noreturn]] inline static void throw_error_code(int err, const char *msg) { ROD_THROW(std::system_error(std::error_code(err, std::system_category()), msg)); }
+
+	inline static mmap_handle map_queue(int fd, std::size_t size, off_t off)
+	{
+		const auto data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, off);
+		if (data == MAP_FAILED) [[unlikely]]
+			throw_error_code(errno, "mmap");
+		return mmap_handle(static_cast<std::byte *>(data), 0, size, get_page_sizes().front(), size, mmap_flags::readwrite);
+	}
 
-	[[noreturn]] inline void throw_errno(const char *msg) { ROD_THROW(std::system_error{errno, std::system_category(), msg}); }
+	inline static auto make_timer_sqe(const kernel_timespec_t *ts) noexcept
+	{
+		return [ts](io_uring_sqe &sqe) noexcept
+		{
+			sqe.opcode = IORING_OP_TIMEOUT;
+			sqe.user_data = event_id::timer_timeout;
+			sqe.addr = std::bit_cast<std::uintptr_t>(ts);
+			sqe.len = 1;
+		};
+	}
+	inline static auto make_timer_cancel_sqe() noexcept
+	{
+		return [](io_uring_sqe &sqe) noexcept
+		{
+			sqe.opcode = IORING_OP_TIMEOUT_REMOVE;
+			sqe.user_data = event_id::timer_cancel;
+			sqe.addr = event_id::timer_timeout;
+		};
+	}
+	inline static auto make_link_timeout_sqe(const kernel_timespec_t *ts, std::uint8_t flags) noexcept
+	{
+		return [ts, flags](io_uring_sqe &sqe) noexcept
+		{
+			sqe.opcode = IORING_OP_LINK_TIMEOUT;
+			sqe.user_data = event_id::io_timeout;
+			sqe.addr = std::bit_cast<std::uintptr_t>(ts);
+			sqe.flags = flags;
+			sqe.len = 1;
+		};
+	}
+
+	static std::uint32_t setup_flags(context_flags flags)
+	{
+		std::uint32_t result = 0;
+		if (bool(flags & context_flags::sqpoll))
+			result |= IORING_SETUP_SQPOLL;
+#ifdef IORING_SETUP_TASKRUN_FLAG
+		/* Task run flag is used to detect when the consumer thread needs to enter the kernel to receive completion events. */
+		if (bool(flags & context_flags::coop_taskrun))
+			result |= IORING_SETUP_COOP_TASKRUN | IORING_SETUP_TASKRUN_FLAG;
+#else
+		if (bool(flags & context_flags::coop_taskrun))
+			throw_error_code(ENOTSUP, "IORING_SETUP_COOP_TASKRUN");
+#endif
+#ifdef IORING_SETUP_DEFER_TASKRUN
+		/* Ring is bound to the first thread that enables it, so start disabled and enable from the consumer thread. */
+		if (bool(flags & context_flags::single_issuer))
+			result |= IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_R_DISABLED;
+		if ((flags & context_flags::defer_taskrun) == context_flags::defer_taskrun)
+			result |= IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_TASKRUN_FLAG;
+#else
+		if (bool(flags & context_flags::single_issuer))
+			throw_error_code(ENOTSUP, "IORING_SETUP_SINGLE_ISSUER");
+#endif
+		return result;
+	}
 
 	context::context() : context(default_entries) {}
-	context::context(std::size_t entries)
+	context::context(std::size_t entries, context_flags flags, std::size_t submit_threshold) : _flags(flags)
 	{
-		constexpr auto mmap_mode = MAP_SHARED | MAP_POPULATE;
-		constexpr auto mmap_prot = PROT_READ | PROT_WRITE;
+		_submit_threshold = static_cast<std::uint32_t>(std::clamp<std::size_t>(submit_threshold, 1, std::numeric_limits<std::uint32_t>::max()));
+
 		io_uring_params params = {};
+		params.flags = setup_flags(flags);
+		_ring_disabled = params.flags & IORING_SETUP_R_DISABLED;
 		{
 			entries = std::min<std::size_t>(entries, std::numeric_limits<unsigned int>::max());
-			if (auto fd = io_uring_setup(entries, &params); fd < 0)
-				throw_errno("io_uring_setup");
+			if (const auto fd = ::io_uring_setup(static_cast<unsigned int>(entries), &params); fd < 0)
+				throw_error_code(-fd, "io_uring_setup");
 			else
 				_uring_fd.release(fd);
 		}
 		{
-			if (const auto fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC); fd < 0)
-				throw_errno("eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)");
+			if (const auto fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC); fd < 0)
+				throw_error_code(errno, "eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)");
 			else
 				_event_fd.release(fd);
 		}
+
+		const auto uring_fd = _uring_fd.native_handle().value;
 		{
-			const auto size = params.cq_entries * sizeof(io_uring_cqe) + params.cq_off.cqes;
-			const auto data = ::mmap(nullptr, size, mmap_prot, mmap_mode, _uring_fd.native_handle(), IORING_OFF_CQ_RING);
-			if (!data) throw_errno("mmap");
+			_cq_mmap = map_queue(uring_fd, params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe), IORING_OFF_CQ_RING);
 
-			const auto bytes = static_cast<std::byte *>(data);
+			const auto bytes = _cq_mmap.data();
 			_cq.entries = reinterpret_cast<io_uring_cqe *>(bytes + params.cq_off.cqes);
 			_cq.overflow = reinterpret_cast<unsigned *>(bytes + params.cq_off.overflow);
 			_cq.mask = *reinterpret_cast<unsigned *>(bytes + params.cq_off.ring_mask);
 			_cq.tail = reinterpret_cast<unsigned *>(bytes + params.cq_off.tail);
 			_cq.head = reinterpret_cast<unsigned *>(bytes + params.cq_off.head);
 			_cq.size = params.cq_entries;
-			_cq_mmap.release(data, size);
 		}
 		{
-			const auto size = params.sq_entries * sizeof(std::uint32_t) + params.sq_off.array;
-			const auto data = ::mmap(nullptr, size, mmap_prot, mmap_mode, _uring_fd.native_handle(), IORING_OFF_SQ_RING);
-			if (!data) throw_errno("mmap");
+			_sq_mmap = map_queue(uring_fd, params.sq_off.array + params.sq_entries * sizeof(std::uint32_t), IORING_OFF_SQ_RING);
 
-			const auto bytes = static_cast<std::byte *>(data);
+			const auto bytes = _sq_mmap.data();
 			_sq.idx_data = reinterpret_cast<unsigned *>(bytes + params.sq_off.array);
 			_sq.dropped = reinterpret_cast<unsigned *>(bytes + params.sq_off.dropped);
+			_sq.flags = reinterpret_cast<unsigned *>(bytes + params.sq_off.flags);
 			_sq.mask = *reinterpret_cast<unsigned *>(bytes + params.sq_off.ring_mask);
 			_sq.tail = reinterpret_cast<unsigned *>(bytes + params.sq_off.tail);
 			_sq.head = reinterpret_cast<unsigned *>(bytes + params.sq_off.head);
 			_sq.size = params.sq_entries;
-			_sq_mmap.release(data, size);
 		}
 		{
-			const auto size = params.sq_entries * sizeof(io_uring_sqe);
-			const auto data = ::mmap(nullptr, size, mmap_prot, mmap_mode, _uring_fd.native_handle(), IORING_OFF_SQES);
-			if (!data) throw_errno("mmap");
-
-			_sq.entries = static_cast<io_uring_sqe *>(data);
-			_sqe_mmap.release(data, size);
+			_sqe_mmap = map_queue(uring_fd, params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES);
+			_sq.entries = reinterpret_cast<io_uring_sqe *>(_sqe_mmap.data());
 		}
 	}
 	context::~context() { assert(!is_consumer_thread()); }
@@ -92,122 +163,315 @@ namespace rod::_io_uring
 	void context::request_stop() { _stop_src.request_stop(); }
 	bool context::is_consumer_thread() const noexcept { return _consumer_tid.load(std::memory_order_acquire) == std::this_thread::get_id(); }
 
-	void context::schedule_producer(operation_base *node)
+	result<void> context::register_buffers(std::span<const byte_buffer> buffs) noexcept
 	{
-		assert(!node->next);
-		if (_producer_queue.push(node))
+		try
 		{
-			const std::uint64_t token = 1;
-			if (const auto err = _event_fd.write(&token, sizeof(token)).error_or({}); err)
-				ROD_THROW(std::system_error{err, "write(event_fd)"});
+			if (!_fixed_buffers.empty()) [[unlikely]]
+			{
+				if (auto res = unregister_buffers(); res.has_error())
+					return res;
+			}
+			if (buffs.empty())
+				return {};
+
+			static_assert(sizeof(byte_buffer) == sizeof(::iovec));
+			if (const auto res = ::io_uring_register(_uring_fd.native_handle().value, IORING_REGISTER_BUFFERS, buffs.data(), static_cast<unsigned int>(buffs.size())); res < 0)
+				return std::error_code(-res, std::system_category());
+
+			_fixed_buffers.reserve(buffs.size());
+			for (std::size_t i = 0; i < buffs.size(); ++i)
+				_fixed_buffers.push_back({buffs[i].data(), buffs[i].size(), int(i)});
+			std::ranges::sort(_fixed_buffers, {}, &fixed_buffer::data);
+			return {};
 		}
+		catch (...) { return _detail::current_error(); }
+	}
+	result<void> context::unregister_buffers() noexcept
+	{
+		if (_fixed_buffers.empty())
+			return {};
+		if (const auto res = ::io_uring_register(_uring_fd.native_handle().value, IORING_UNREGISTER_BUFFERS, nullptr, 0); res < 0)
+			return std::error_code(-res, std::system_category());
+
+		_fixed_buffers.clear();
+		return {};
 	}
-	void context::schedule_consumer(operation_base *node)
+	result<void> context::register_files(std::span<const native_handle_type> hnds) noexcept
+	{
+		try
+		{
+			if (!_fixed_files.empty()) [[unlikely]]
+			{
+				if (auto res = unregister_files(); res.has_error())
+					return res;
+			}
+			if (hnds.empty())
+				return {};
+
+			auto fds = std::vector<int>(hnds.size());
+			std::ranges::transform(hnds, fds.begin(), &native_handle_type::value);
+			if (const auto res = ::io_uring_register(_uring_fd.native_handle().value, IORING_REGISTER_FILES, fds.data(), static_cast<unsigned int>(fds.size())); res < 0)
+				return std::error_code(-res, std::system_category());
+
+			_fixed_files.reserve(fds.size());
+			for (std::size_t i = 0; i < fds.size(); ++i)
+				_fixed_files.push_back({fds[i], int(i)});
+			std::ranges::sort(_fixed_files, {}, &fixed_file::fd);
+			return {};
+		}
+		catch (...) { return _detail::current_error(); }
+	}
+	result<void> context::unregister_files() noexcept
+	{
+		if (_fixed_files.empty())
+			return {};
+		if (const auto res = ::io_uring_register(_uring_fd.native_handle().value, IORING_UNREGISTER_FILES, nullptr, 0); res < 0)
+			return std::error_code(-res, std::system_category());
+
+		_fixed_files.clear();
+		return {};
+	}
+
+	inline int context::find_fixed_file(int fd) const noexcept
+	{
+		if (_fixed_files.empty()) [[likely]]
+			return -1;
+
+		const auto iter = std::ranges::lower_bound(_fixed_files, fd, {}, &fixed_file::fd);
+		return iter != _fixed_files.end() && iter->fd == fd ? iter->idx : -1;
+	}
+	inline int context::find_fixed_buffer(const void *data, std::size_t size) const noexcept
+	{
+		if (_fixed_buffers.empty()) [[likely]]
+			return -1;
+
+		/* Find the last buffer starting at or before `data` and make sure it contains the entire range. */
+		const auto bytes = static_cast<const std::byte *>(data);
+		const auto iter = std::ranges::upper_bound(_fixed_buffers, bytes, std::less<>{}, &fixed_buffer::data);
+		if (iter == _fixed_buffers.begin())
+			return -1;
+		if (const auto &buff = *std::prev(iter); bytes + size <= buff.data + buff.size)
+			return buff.idx;
+		return -1;
+	}
+
+	void context::schedule_producer(operation_base *node) noexcept
 	{
 		assert(!node->next);
-		_consumer_queue.push_back(node);
+		if (!_producer_queue.push(node))
+			return;
+
+		/* Consumer is asleep. If the current thread runs another io_uring context, post a completion event directly to our ring. */
+		if (const auto src = local_context; src == nullptr || src == this || !src->submit_message_event(this))
+			notify_event_fd();
 	}
-	void context::schedule_waitlist(operation_base *node)
+	void context::notify_event_fd() noexcept
+	{
+		/* Consumer is waiting for the eventfd poll event. Failure to write means the counter is saturated and it is already signalled. */
+		const std::uint64_t token = 1;
+		[[maybe_unused]] const auto res = ::write(_event_fd.native_handle().value, &token, sizeof(token));
+	}
+	void context::schedule_consumer(operation_base *node) noexcept
 	{
 		assert(!node->next);
+		_consumer_queue.push_back(node);
+	}
+	void context::schedule_waitlist(operation_base *node) noexcept
+	{
+		assert(!node->next && !node->prev);
 		_waitlist_queue.push_back(node);
 	}
+	void context::erase_waitlist(operation_base *node) noexcept
+	{
+		_waitlist_queue.erase(node);
+	}
 
-	inline bool context::submit_io_event(int op, void *data, int fd, void *addr, std::size_t n, std::size_t off) noexcept
+	inline bool context::has_free_sqes(std::uint32_t n) const noexcept
+	{
+		/* Every submitted entry produces a completion event, so make sure the completion queue cannot overflow. One entry is reserved for messages from other rings,
+		 * which is enough since only the producer that finds the queue asleep sends a message, and the queue is not put to sleep again until it has been received.
+		 * Should the completion queue still fill up, the kernel keeps the overflowing events until the next call to `io_uring_enter`. */
+		return _sq.pending + n <= _sq.size && _cq.pending + _sq.pending + n < _cq.size;
+	}
+	template<typename... Fs>
+	inline bool context::submit_sqe(Fs &&...init) noexcept
 	{
-		return submit_sqe([&](io_uring_sqe *sq, std::uint32_t idx) noexcept
+		constexpr auto n = std::uint32_t(sizeof...(Fs));
+		if (!has_free_sqes(n)) [[unlikely]]
+			return false;
+
+		const auto tail = std::atomic_ref{*_sq.tail}.load(std::memory_order_relaxed);
+		auto i = std::uint32_t(0);
+		const auto push = [&](auto &func)
 		{
-			sq[idx] = {};
-			sq[idx].opcode = op;
-			sq[idx].user_data = std::bit_cast<std::uintptr_t>(data);
-			sq[idx].addr = std::bit_cast<std::uintptr_t>(addr);
-			sq[idx].off = static_cast<std::uint64_t>(off);
-			sq[idx].len = n;
-			sq[idx].fd = fd;
-		});
+			const auto idx = (tail + i++) & _sq.mask;
+			auto &sqe = (_sq.entries[idx] = {});
+			_sq.idx_data[idx] = idx;
+			func(sqe);
+		};
+		(push(init), ...);
+
+		std::atomic_ref{*_sq.tail}.store(tail + n, std::memory_order_release);
+		_sq.pending += n;
+		return true;
 	}
-	inline bool context::submit_timer_event(time_point timeout) noexcept
+
+	inline void context::init_io_sqe(io_uring_sqe &sqe, const io_event &event) const noexcept
 	{
-		const auto res = submit_sqe([&](io_uring_sqe *sq, std::uint32_t idx) noexcept
+		sqe.opcode = event.op;
+		sqe.user_data = std::bit_cast<std::uintptr_t>(event.node);
+		sqe.addr = std::bit_cast<std::uintptr_t>(event.addr);
+		sqe.len = static_cast<std::uint32_t>(event.n);
+		sqe.off = static_cast<std::uint64_t>(event.off);
+		sqe.fd = event.fd;
+
+		if (const auto file_idx = find_fixed_file(event.fd); file_idx >= 0)
 		{
-			sq[idx] = {};
-			sq[idx].opcode = IORING_OP_TIMEOUT;
-			sq[idx].addr = std::bit_cast<std::uintptr_t>(&_ktime);
-			sq[idx].user_data = event_id::timer_timeout;
-#ifdef IORING_TIMEOUT_ABS
-		    sq[idx].timeout_flags = IORING_TIMEOUT_ABS;
-#else
-			sq[idx].rw_flags = 1;
-#endif
-			_ktime.tv_sec = timeout.seconds();
-			_ktime.tv_nsec = timeout.nanoseconds();
-		});
-		return (_active_timers += res, res);
+			sqe.flags |= IOSQE_FIXED_FILE;
+			sqe.fd = file_idx;
+		}
+		if (event.buff_idx >= 0)
+			sqe.buf_index = static_cast<std::uint16_t>(event.buff_idx);
+		if (event.to != nullptr)
+			sqe.flags |= IOSQE_IO_LINK;
+	}
+	inline bool context::submit_timer_event(time_point timeout) noexcept
+	{
+		/* File clock is not guaranteed to match the monotonic kernel clock, so use a relative timeout. */
+		const auto dur = std::chrono::duration_cast<std::chrono::nanoseconds>(std::max(timeout - clock::now(), time_point::duration(0)));
+		_ktime.tv_sec = dur.count() / 1'000'000'000;
+		_ktime.tv_nsec = dur.count() % 1'000'000'000;
+
+		/* Cancel the active timer in the same batch to avoid leaving the context without a timer on failure. */
+		if (!(_timer_started ? submit_sqe(make_timer_cancel_sqe(), make_timer_sqe(&_ktime)) : submit_sqe(make_timer_sqe(&_ktime))))
+			return false;
+
+		++_active_timers;
+		return true;
 	}
 	inline bool context::cancel_timer_event() noexcept
 	{
-		return submit_sqe([&](io_uring_sqe *sq, std::uint32_t idx) noexcept
+		return submit_sqe(make_timer_cancel_sqe());
+	}
+	inline bool context::submit_queue_event() noexcept
+	{
+		if (!_queue_armed && !has_free_sqes(1))
+			return false;
+
+		/* Producer queue can only be put to sleep if it is empty. */
+		if (!_producer_queue.try_terminate())
+		{
+			_consumer_queue.merge_back(std::move(_producer_queue));
+			return false;
+		}
+		if (_queue_armed)
+			return true;
+
+		return submit_sqe([&](io_uring_sqe &sqe) noexcept
 		{
-			sq[idx] = {};
-			sq[idx].opcode = IORING_OP_TIMEOUT_REMOVE;
-			sq[idx].user_data = event_id::timer_cancel;
-			sq[idx].addr = event_id::timer_timeout;
+			sqe.opcode = IORING_OP_POLL_ADD;
+			sqe.fd = _event_fd.native_handle().value;
+			sqe.user_data = event_id::queue_dispatch;
+			sqe.poll_events = POLLIN;
+#ifdef IORING_POLL_ADD_MULTI
+			/* Multishot poll stays armed between notifications, which avoids re-submitting it every time the consumer goes to sleep. */
+			sqe.len = IORING_POLL_ADD_MULTI;
+#endif
+			_queue_armed = true;
 		});
 	}
-	inline bool context::submit_queue_event() noexcept
+	inline bool context::submit_message_event(context *dst) noexcept
 	{
-		return submit_sqe([&](io_uring_sqe *sq, std::uint32_t idx) noexcept
+#ifdef IORING_MSG_RING_CQE_SKIP
+		/* Messages avoid the read-back of the eventfd by the destination. The message is submitted right away rather than with the next batch,
+		 * since the current thread may not enter its ring again for a while (i.e. if the calling operation blocks), leaving the destination asleep.
+		 * Entries are submitted in order, so this also flushes any entries batched before the message regardless of the submit threshold. */
+		const auto init_msg = [&](io_uring_sqe &sqe) noexcept
 		{
-			if (!_producer_queue.try_terminate())
-			{
-				_consumer_queue.merge_back(std::move(_producer_queue));
-				return false;
-			}
+			sqe.opcode = IORING_OP_MSG_RING;
+			sqe.fd = dst->_uring_fd.native_handle().value;
+			sqe.user_data = std::bit_cast<std::uintptr_t>(dst) | message_tag;
+			sqe.off = event_id::queue_message;
+		};
+		if (_no_msg_ring || !submit_sqe(init_msg))
+			return false;
+		if (submit_pending())
+			return true;
 
-			sq[idx] = {};
-			sq[idx].opcode = IORING_OP_POLL_ADD;
-			sq[idx].fd = _event_fd.native_handle();
-			sq[idx].user_data = event_id::queue_dispatch;
-			sq[idx].poll_events = POLL_IN;
+		/* Kernel thread may have already consumed the message, otherwise it is submitted once the thread is woken up again. */
+		if (bool(_flags & context_flags::sqpoll))
 			return true;
-		});
+
+		/* Failed submission did not consume any entries, so take the message back to not notify the destination twice once the eventfd is used instead. */
+		const auto tail = std::atomic_ref{*_sq.tail}.load(std::memory_order_relaxed);
+		std::atomic_ref{*_sq.tail}.store(tail - 1, std::memory_order_release);
+		_sq.pending -= 1;
+		return false;
+#else
+		return false;
+#endif
 	}
 
-	bool context::submit_io_event(operation_base *node, io_cmd_t<schedule_read_some_t, std::span<std::byte>> cmd) noexcept
+	auto context::make_io_event(io_operation_base *node, read_some_at_t, int fd, std::span<byte_buffer> buffs, extent_type off, const kernel_timespec_t *to) const noexcept -> io_event
 	{
-		return submit_io_event(IORING_OP_READ, node, cmd.fd.native_handle(), cmd.buff.data(), cmd.buff.size(), -1);
+		if (buffs.size() == 1) if (const auto idx = find_fixed_buffer(buffs.front().data(), buffs.front().size()); idx >= 0)
+			return {node, buffs.front().data(), buffs.front().size(), off, to, idx, fd, IORING_OP_READ_FIXED};
+		return {node, buffs.data(), buffs.size(), off, to, -1, fd, IORING_OP_READV};
 	}
-	bool context::submit_io_event(operation_base *node, io_cmd_t<schedule_write_some_t, std::span<std::byte>> cmd) noexcept
+	auto context::make_io_event(io_operation_base *node, write_some_at_t, int fd, std::span<const_byte_buffer> buffs, extent_type off, const kernel_timespec_t *to) const noexcept -> io_event
 	{
-		return submit_io_event(IORING_OP_WRITE, node, cmd.fd.native_handle(), cmd.buff.data(), cmd.buff.size(), -1);
+		if (buffs.size() == 1) if (const auto idx = find_fixed_buffer(buffs.front().data(), buffs.front().size()); idx >= 0)
+			return {node, buffs.front().data(), buffs.front().size(), off, to, idx, fd, IORING_OP_WRITE_FIXED};
+		return {node, buffs.data(), buffs.size(), off, to, -1, fd, IORING_OP_WRITEV};
 	}
-	bool context::submit_io_event(operation_base *node, io_cmd_t<schedule_read_some_at_t, std::span<std::byte>> cmd) noexcept
+
+	bool context::submit_io_event(const io_event &event) noexcept
 	{
-		return submit_io_event(IORING_OP_READ, node, cmd.fd.native_handle(), cmd.buff.data(), cmd.buff.size(), cmd.off);
+		const auto init_io = [&](io_uring_sqe &sqe) noexcept { init_io_sqe(sqe, event); };
+		if (event.to == nullptr)
+			return submit_sqe(init_io);
+
+		/* Timeout is implemented via a linked timeout event, which cancels the IO operation once elapsed. */
+		return submit_sqe(init_io, make_link_timeout_sqe(event.to, 0));
 	}
-	bool context::submit_io_event(operation_base *node, io_cmd_t<schedule_write_some_at_t, std::span<std::byte>> cmd) noexcept
+	bool context::submit_io_chain(const io_event &first, const io_event &second, bool hard) noexcept
 	{
-		return submit_io_event(IORING_OP_WRITE, node, cmd.fd.native_handle(), cmd.buff.data(), cmd.buff.size(), cmd.off);
+		/* Link flag of the first request (or its linked timeout) continues the chain to the second request. */
+		const std::uint8_t link_flags = hard ? IOSQE_IO_HARDLINK : IOSQE_IO_LINK;
+		const auto init_first = [&](io_uring_sqe &sqe) noexcept
+		{
+			init_io_sqe(sqe, first);
+			sqe.flags |= link_flags;
+		};
+		const auto init_second = [&](io_uring_sqe &sqe) noexcept { init_io_sqe(sqe, second); };
+
+		if (first.to != nullptr && second.to != nullptr)
+			return submit_sqe(init_first, make_link_timeout_sqe(first.to, link_flags), init_second, make_link_timeout_sqe(second.to, 0));
+		else if (first.to != nullptr)
+			return submit_sqe(init_first, make_link_timeout_sqe(first.to, link_flags), init_second);
+		else if (second.to != nullptr)
+			return submit_sqe(init_first, init_second, make_link_timeout_sqe(second.to, 0));
+		else
+			return submit_sqe(init_first, init_second);
 	}
-	bool context::cancel_io_event(operation_base *node) noexcept
+	bool context::cancel_io_event(io_operation_base *node, io_operation_base *result_node) noexcept
 	{
-		return submit_sqe([&](io_uring_sqe *sq, std::uint32_t idx) noexcept
+		return submit_sqe([&](io_uring_sqe &sqe) noexcept
 		{
-			sq[idx] = {};
-			sq[idx].user_data = sq[idx].addr = std::bit_cast<std::uintptr_t>(node);
-#ifdef IORING_ASYNC_CANCEL_ALL
-			sq[idx].cancel_flags = IORING_ASYNC_CANCEL_ALL;
-#else
-			sq[idx].rw_flags = 1;
-#endif
-			sq[idx].opcode = IORING_OP_ASYNC_CANCEL;
+			sqe.opcode = IORING_OP_ASYNC_CANCEL;
+			sqe.addr = std::bit_cast<std::uintptr_t>(static_cast<operation_base *>(node));
+
+			/* Result of the cancellation is only dispatched if requested. */
+			if (result_node != nullptr)
+				sqe.user_data = std::bit_cast<std::uintptr_t>(static_cast<operation_base *>(result_node));
+			else
+				sqe.user_data = event_id::io_cancel;
 		});
 	}
 
 	void context::add_timer(timer_operation_base *node) noexcept
 	{
-		assert(!node->timer_next);
-		assert(!node->timer_prev);
 		/* Process pending timers if the inserted timer is the new front. */
 		_timer_pending |= _timers.insert(node) == node;
 	}
@@ -221,61 +485,84 @@ namespace rod::_io_uring
 	inline void context::acquire_consumer_queue()
 	{
 		const auto tail = std::atomic_ref{*_cq.tail}.load(std::memory_order_acquire);
-		const auto head = std::atomic_ref{*_cq.head}.load(std::memory_order_acquire);
+		const auto head = std::atomic_ref{*_cq.head}.load(std::memory_order_relaxed);
 		const auto num = tail - head;
 		if (!num) return;
 
 		/* Temporary queue is used to allow for errors during dispatch. */
 		consumer_queue_t tmp_queue;
+		/* Multishot events keep occupying a completion queue entry until their final event. */
+		std::uint32_t done = num;
 
 		for (std::uint32_t i = 0; i < num; ++i)
 			switch (auto &event = _cq.entries[(head + i) & _cq.mask]; event.user_data)
 			{
 			case event_id::timer_timeout: /* Timer elapsed notification event. */
-				_timer_pending |= (event.res != ECANCELED);
+				_timer_pending |= (event.res != -ECANCELED);
 				_timer_started = --_active_timers;
 				[[fallthrough]];
 			case event_id::timer_cancel:
+			case event_id::io_cancel:
+			case event_id::io_timeout:
 				break;
 			case event_id::queue_dispatch: /* Producer queue notification event. */
 			{
+				if (event.flags & IORING_CQE_F_MORE)
+					--done;
+				else
+					_queue_armed = false;
+
 				if (std::uint64_t token; event.res < 0)
-					ROD_THROW(std::system_error(std::error_code{-event.res, std::system_category()}, "read(event_fd)"));
-				else if (auto res = _event_fd.read(&token, sizeof(token)); res.has_error())
-					ROD_THROW(std::system_error(res.error(), "read(event_fd)"));
+					throw_error_code(-event.res, "poll(event_fd)");
+				else if (::read(_event_fd.native_handle().value, &token, sizeof(token)) < 0 && errno != EAGAIN)
+					throw_error_code(errno, "read(event_fd)");
 				else
 					_queue_active = false;
 				break;
 			}
+			case event_id::queue_message: /* Producer queue notification from another ring. */
+				_queue_active = false;
+				--done;
+				break;
 			default: /* IO operation event. */
+				if (event.user_data & message_tag) [[unlikely]]
+				{
+					/* Fall back to the eventfd if the message could not be delivered. */
+					if (event.res < 0)
+					{
+						_no_msg_ring |= event.res == -EINVAL;
+						std::bit_cast<context *>(static_cast<std::uintptr_t>(event.user_data & ~message_tag))->notify_event_fd();
+					}
+					break;
+				}
+
 				auto *node = std::bit_cast<operation_base *>(static_cast<std::uintptr_t>(event.user_data));
-				node->result = static_cast<std::ptrdiff_t>(event.res);
+				static_cast<io_operation_base *>(node)->result = event.res;
 				tmp_queue.push_back(node);
 			}
 
 		_consumer_queue.merge_back(std::move(tmp_queue));
 		std::atomic_ref{*_cq.head}.store(tail, std::memory_order_release);
-		_cq.pending -= num;
+		_cq.pending -= done;
 	}
 	inline void context::acquire_elapsed_timers()
 	{
 		if (!_timer_pending)
 			return;
 
-		if (!_timers.empty())
-			for (const auto now = clock::now(); !_timers.empty() && _timers.front()->timeout <= now;)
-			{
-				const auto node = _timers.pop_front();
+		for (const auto now = clock::now(); !_timers.empty() && _timers.front()->timeout <= now;)
+		{
+			const auto node = _timers.pop_front();
 
-				/* Handle timer cancellation. */
-				if (!node->stop_possible() || !(node->flags.fetch_or(flags_t::dispatched, std::memory_order_acq_rel) & flags_t::stop_requested))
-					schedule_consumer(node);
-			}
+			/* Stop requests will take care of timers cancelled before being dispatched. */
+			if (!(node->flags.fetch_or(flags_t::dispatched, std::memory_order_acq_rel) & flags_t::stop_requested))
+				schedule_consumer(node);
+		}
 
 		/* Disarm or start a timeout event. */
 		if (_timers.empty())
 		{
-			if (_timer_started && cancel_timer_event())
+			if (!_timer_started || cancel_timer_event())
 			{
 				_timer_started = false;
 				_timer_pending = false;
@@ -283,76 +570,169 @@ namespace rod::_io_uring
 			return;
 		}
 
-		if (const auto next_timeout = _timers.front()->timeout; _timer_started)
-		{
-			if (_next_timeout >= next_timeout)
-				_timer_pending = false;
-			else if (cancel_timer_event() && (_timer_started = submit_timer_event(next_timeout)))
-			{
-				_next_timeout = next_timeout;
-				_timer_pending = false;
-			}
-		}
-		else if ((_timer_started = submit_timer_event(next_timeout)))
+		/* Re-arm the kernel timer only if the next timeout is earlier than the active one. */
+		if (const auto next_timeout = _timers.front()->timeout; _timer_started && _next_timeout <= next_timeout)
+			_timer_pending = false;
+		else if (submit_timer_event(next_timeout))
 		{
 			_next_timeout = next_timeout;
+			_timer_started = true;
 			_timer_pending = false;
 		}
 	}
+	inline void context::acquire_waitlist() noexcept
+	{
+		/* Dispatch waiting operations while there is enough space for a chain of 2 IO events and their linked timeouts. */
+		while (!_waitlist_queue.empty() && has_free_sqes(4))
+			_waitlist_queue.pop_front()->notify();
+	}
+	inline void context::acquire_sq_state() noexcept
+	{
+		if (!bool(_flags & context_flags::sqpoll))
+			return;
+
+		/* Submission queue is consumed by the kernel thread, entries that are no longer pending are now in-flight. */
+		const auto tail = std::atomic_ref{*_sq.tail}.load(std::memory_order_relaxed);
+		const auto head = std::atomic_ref{*_sq.head}.load(std::memory_order_acquire);
+		_cq.pending += _sq.pending - (tail - head);
+		_sq.pending = tail - head;
+	}
+	inline bool context::submit_pending() noexcept
+	{
+		auto to_submit = _sq.pending, flags = 0u;
+		const auto sqpoll = bool(_flags & context_flags::sqpoll);
+		if (sqpoll)
+		{
+			/* Submission queue thread only needs to be notified if it went to sleep. */
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!(std::atomic_ref{*_sq.flags}.load(std::memory_order_relaxed) & IORING_SQ_NEED_WAKEUP))
+				return true;
+
+			to_submit = 0;
+			flags = IORING_ENTER_SQ_WAKEUP;
+		}
+
+		for (;;)
+		{
+			if (const auto res = ::io_uring_enter(_uring_fd.native_handle().value, to_submit, 0, flags, nullptr); res >= 0)
+			{
+				if (!sqpoll)
+				{
+					_sq.pending -= res;
+					_cq.pending += res;
+				}
+				return true;
+			}
+			else if (res != -EINTR)
+				return false;
+		}
+	}
 	inline void context::uring_enter()
 	{
+		const auto busy_poll = bool(_flags & context_flags::busy_poll);
+		const auto sqpoll = bool(_flags & context_flags::sqpoll);
+
+		acquire_sq_state();
 		const auto has_pending = _sq.pending || !_consumer_queue.empty();
-		if (!has_pending && !_queue_active) _queue_active = submit_queue_event();
+		if (!busy_poll && !has_pending && !_queue_active) _queue_active = submit_queue_event();
 
-		std::uint32_t count = 0, flags = 0;
-		if (!has_pending && (_queue_active || _cq.pending + _sq.pending == _cq.size))
+		/* Only block if there is no work left after submitting the queue event. */
+		std::uint32_t to_submit = _sq.pending, count = 0, flags = 0;
+		if (!busy_poll && !has_pending && _consumer_queue.empty() && (_queue_active || _cq.pending + _sq.pending + 1 >= _cq.size))
 		{
 			flags = IORING_ENTER_GETEVENTS;
 			count = 1;
 		}
 
+		/* Make sure the tail store is visible to the submission queue thread before reading its flags. */
+		if (sqpoll) std::atomic_thread_fence(std::memory_order_seq_cst);
+		const auto sq_flags = std::atomic_ref{*_sq.flags}.load(std::memory_order_relaxed);
+
+		/* Deferred or cooperative task work is only ran when entering the kernel. */
+		if (sq_flags & (IORING_SQ_TASKRUN | IORING_SQ_CQ_OVERFLOW))
+			flags |= IORING_ENTER_GETEVENTS;
+		if (sqpoll)
+		{
+			/* Submission queue thread only needs to be notified if it went to sleep. */
+			if (to_submit != 0 && (sq_flags & IORING_SQ_NEED_WAKEUP))
+				flags |= IORING_ENTER_SQ_WAKEUP;
+			to_submit = 0;
+		}
+		if (to_submit == 0 && flags == 0)
+			return;
+
 		for (;;)
 		{
-			if (const auto res = ::io_uring_enter(_uring_fd.native_handle(), _sq.pending, count, flags, nullptr); res >= 0)
+			if (const auto res = ::io_uring_enter(_uring_fd.native_handle().value, to_submit, count, flags, nullptr); res >= 0)
 			{
-				_sq.pending -= res;
-				_cq.pending += res;
+				if (!sqpoll)
+				{
+					_sq.pending -= res;
+					_cq.pending += res;
+				}
 				break;
 			}
-			else if (const auto err = std::error_code{-res, std::system_category()}; err.value() != EINTR)
-				ROD_THROW(std::system_error(err, "io_uring_enter"));
+			else if (res == -EBUSY)
+			{
+				/* Completion queue overflowed and cannot be flushed until its events are consumed, so leave the entries pending until then. */
+				return;
+			}
+			else if (res != -EINTR)
+				throw_error_code(-res, "io_uring_enter");
 		}
+
+		/* Consumer is awake again, producers do not need to notify it unless one has already done so. */
+		if (count != 0 && _queue_active && _producer_queue.try_activate())
+			_queue_active = false;
 	}
 
 	void context::run()
 	{
 		/* Make sure only one thread is allowed to run at a given time. */
 		if (std::thread::id id = {}; !_consumer_tid.compare_exchange_strong(id, std::this_thread::get_id(), std::memory_order_acq_rel))
-			ROD_THROW(std::system_error(std::make_error_code(std::errc::device_or_resource_busy), "Only one thread may invoke `epoll_context::run` at a given time"));
+			ROD_THROW(std::system_error(std::make_error_code(std::errc::device_or_resource_busy), "Only one thread may invoke `io_uring_context::run` at a given time"));
 
 		struct thread_guard
 		{
-			~thread_guard() { tid.store(std::thread::id{}, std::memory_order_release); }
+			~thread_guard()
+			{
+				tid.store(std::thread::id{}, std::memory_order_release);
+				local_context = prev;
+			}
+
 			std::atomic<std::thread::id> &tid;
-		} g = {_consumer_tid};
+			context *prev;
+		} g = {_consumer_tid, std::exchange(local_context, this)};
+
+		/* Enable the ring from the consumer thread to make it the single issuer. */
+		if (std::exchange(_ring_disabled, false))
+		{
+			if (const auto res = ::io_uring_register(_uring_fd.native_handle().value, IORING_REGISTER_ENABLE_RINGS, nullptr, 0); res < 0)
+				throw_error_code(-res, "io_uring_register(IORING_REGISTER_ENABLE_RINGS)");
+		}
 
 		for (;;)
 		{
 			for (auto queue = std::move(_consumer_queue); !queue.empty();)
 				queue.pop_front()->notify();
 			if (std::exchange(_stop_pending, false)) [[unlikely]]
+			{
+				/* Make sure messages to other rings are not left in the submission queue. */
+				if (_sq.pending != 0)
+					uring_enter();
 				return;
+			}
 
 			/* Handle producer & waitlist queue items. */
 			if (!_queue_active && !_producer_queue.empty())
 				_consumer_queue.merge_back(std::move(_producer_queue));
-			while (!_waitlist_queue.empty() && _sq.pending < _sq.size && _cq.pending + _sq.pending < _cq.size)
-				_waitlist_queue.pop_front()->notify();
+			acquire_sq_state();
+			acquire_waitlist();
 
 			acquire_consumer_queue();
 			acquire_elapsed_timers();
 
-			if (_consumer_queue.empty() || _sq.pending)
+			if (_consumer_queue.empty() || _sq.pending >= _submit_threshold)
 				uring_enter();
 		}
 	}
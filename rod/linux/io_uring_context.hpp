@@ -4,22 +4,25 @@
 
 #pragma once
 
-#include "../detail/adaptors/read_some.hpp"
-#include "../detail/adaptors/write_some.hpp"
+#include "../detail/config.hpp"
 
 #ifdef ROD_HAS_LIBURING
 
 #include <utility>
+#include <vector>
+#include <cerrno>
 #include <thread>
-#include <chrono>
 
+#include "../detail/file_handle.hpp"
+#include "../detail/mmap_handle.hpp"
 #include "../detail/priority_queue.hpp"
-#include "../detail/atomic_queue.hpp"
+#include "../detail/mpsc_queue.hpp"
 #include "../detail/basic_queue.hpp"
 
-#include "../posix/monotonic_clock.hpp"
-#include "../posix/detail/file.hpp"
-#include "../posix/detail/mmap.hpp"
+#include "../stop_token.hpp"
+#include "../detail/queries/may_block.hpp"
+#include "../detail/queries/scheduler.hpp"
+#include "../detail/queries/progress.hpp"
 
 /* Forward declare these to avoid including liburing.h */
 extern "C"
@@ -32,17 +35,59 @@ namespace rod
 {
 	namespace _io_uring
 	{
-		enum flags_t { stop_possible = 1, stop_requested = 4, dispatched = 8 };
+		using extent_type = _handle::extent_type;
 
-		using clock = monotonic_clock;
-		using time_point = typename clock::time_point;
+		enum flags_t { stop_requested = 1, dispatched = 2 };
+
+		/** Flags used to configure the io_uring execution context. */
+		enum class context_flags : std::uint16_t
+		{
+			/** Default configuration. */
+			none = 0,
+			/** Use a kernel thread to poll the submission queue (`IORING_SETUP_SQPOLL`). Submission of IO operations will not require a system call unless the thread went to sleep.
+			 * @note Requires elevated privileges on kernels prior to 5.11. */
+			sqpoll = 0x1,
+			/** Run completion task work cooperatively on transitions to the kernel instead of interrupting the consumer thread (`IORING_SETUP_COOP_TASKRUN`). */
+			coop_taskrun = 0x2,
+			/** Only the consumer thread will submit IO operations (`IORING_SETUP_SINGLE_ISSUER`).
+			 * @note Buffers and files must be registered either before the first call to `run` or from within the consumer thread, and all calls to `run` must be made from the same thread. */
+			single_issuer = 0x4,
+			/** Defer completion task work until the consumer thread waits for completion events (`IORING_SETUP_DEFER_TASKRUN`). Implies `single_issuer`, incompatible with `sqpoll`. */
+			defer_taskrun = 0x8 | single_issuer,
+			/** Busy-poll the completion & producer queues instead of blocking the consumer thread in the kernel.
+			 * @note When combined with `sqpoll`, the consumer thread will not make any system calls while the submission queue thread is awake. */
+			busy_poll = 0x10,
+		};
+
+		[[nodiscard]] constexpr context_flags operator~(context_flags h) noexcept { return context_flags(~std::uint16_t(h)); }
+		[[nodiscard]] constexpr context_flags operator&(context_flags a, context_flags b) noexcept { return context_flags(std::uint16_t(a) & std::uint16_t(b)); }
+		[[nodiscard]] constexpr context_flags operator|(context_flags a, context_flags b) noexcept { return context_flags(std::uint16_t(a) | std::uint16_t(b)); }
+		[[nodiscard]] constexpr context_flags operator^(context_flags a, context_flags b) noexcept { return context_flags(std::uint16_t(a) ^ std::uint16_t(b)); }
+		constexpr context_flags &operator&=(context_flags &a, context_flags b) noexcept { return a = a & b; }
+		constexpr context_flags &operator|=(context_flags &a, context_flags b) noexcept { return a = a | b; }
+		constexpr context_flags &operator^=(context_flags &a, context_flags b) noexcept { return a = a ^ b; }
+
+		using clock = fs::file_clock;
+		using time_point = fs::file_time_point;
 
 		struct kernel_timespec_t
 		{
-			int64_t tv_sec;
+			std::int64_t tv_sec;
 			long long tv_nsec;
 		};
 
+		/* Converts a file timeout to a relative kernel timespec, returns `false` if the timeout is infinite. */
+		inline bool to_kernel_timespec(const fs::file_timeout &to, kernel_timespec_t &ts) noexcept
+		{
+			if (to.is_infinite())
+				return false;
+
+			const auto dur = std::chrono::duration_cast<std::chrono::nanoseconds>(std::max(to.relative(), fs::file_timeout::relative_type(0)));
+			ts.tv_sec = dur.count() / 1'000'000'000;
+			ts.tv_nsec = dur.count() % 1'000'000'000;
+			return true;
+		}
+
 		struct queue_state_t
 		{
 			std::uint32_t size;
@@ -71,101 +116,126 @@ namespace rod
 
 		struct env { context *_ctx; };
 
+		template<typename... Signs>
+		class sender_base
+		{
+		public:
+			using is_sender = std::true_type;
+
+		private:
+			template<typename Env>
+			using stop_signs_t = std::conditional_t<_detail::stoppable_env<Env>, completion_signatures<set_stopped_t()>, completion_signatures<>>;
+			template<typename Env>
+			using signs_t = _detail::concat_tuples_t<completion_signatures<Signs...>, stop_signs_t<Env>>;
+
+		public:
+			constexpr explicit sender_base(context *ctx) noexcept : _ctx(ctx) {}
+
+			friend constexpr env tag_invoke(get_env_t, const sender_base &s) noexcept { return {s._ctx}; }
+			template<decays_to_derived<sender_base> T, typename Env>
+			friend constexpr signs_t<Env> tag_invoke(get_completion_signatures_t, T &&, Env) noexcept { return {}; }
+
+		protected:
+			context *_ctx;
+		};
+
 		template<typename Env, auto StopFunc>
 		using stop_cb = _detail::stop_cb_adaptor<Env, StopFunc>;
 
-		template<typename, typename>
-		struct io_cmd;
-		template<typename Buff>
-		struct io_cmd<async_read_some_t, Buff>
-		{
-			_detail::basic_descriptor fd;
-			Buff buff;
-		};
-		template<typename Buff>
-		struct io_cmd<async_write_some_t, Buff>
-		{
-			_detail::basic_descriptor fd;
-			Buff buff;
-		};
-		template<typename Buff>
-		struct io_cmd<async_read_some_at_t, Buff>
-		{
-			_detail::basic_descriptor fd;
-			std::size_t pos;
-			Buff buff;
-		};
-		template<typename Buff>
-		struct io_cmd<async_write_some_at_t, Buff>
-		{
-			_detail::basic_descriptor fd;
-			std::size_t pos;
-			Buff buff;
-		};
+		class basic_sender;
+		class timer_sender;
+		template<typename Op>
+		struct io_sender { class type; };
+		template<typename Op0, typename Op1>
+		struct linked_sender { class type; };
+
+		template<typename Rcv>
+		struct basic_operation { class type; };
+		template<typename Rcv>
+		struct timer_operation { class type; };
+		template<typename Op, typename Rcv>
+		struct io_operation { class type; };
+		template<typename Op0, typename Op1, typename Rcv>
+		struct linked_operation { class type; };
 
 		struct operation_base
 		{
-			using notify_func_t = void (*)(operation_base *);
+			using notify_func_t = void (*)(operation_base *) noexcept;
 
 			operation_base(operation_base &&) = delete;
 			operation_base &operator=(operation_base &&) = delete;
 
 			constexpr operation_base() noexcept = default;
 
-			void notify() { std::exchange(notify_func, {})(this); }
+			void notify() noexcept { std::exchange(notify_func, {})(this); }
 
 			notify_func_t notify_func = {};
 			operation_base *next = {};
-			std::intmax_t result = {};
+			operation_base *prev = {};
 		};
 		struct timer_operation_base : operation_base
 		{
-			constexpr timer_operation_base(context *ctx, time_point tp, bool can_stop) noexcept : flags(can_stop ? flags_t::stop_possible : 0), timeout(tp), ctx(ctx) {}
+			constexpr explicit timer_operation_base(time_point tp) noexcept : timeout(tp) {}
 
-			[[nodiscard]] bool stop_possible() const noexcept { return flags.load(std::memory_order_relaxed) & flags_t::stop_possible; }
-
-			timer_operation_base *timer_prev = {};
-			timer_operation_base *timer_next = {};
+			_detail::heap_hook<timer_operation_base> timer_hook;
 			std::atomic<int> flags = {};
-			time_point timeout = {};
-			context *ctx;
+			time_point timeout;
 		};
 
-		struct complete_base : operation_base {};
-		struct stop_base : operation_base {};
-
-		class sender;
-		template<typename Rcv>
-		struct operation { class type; };
-
-		class timer_sender;
-		template<typename Rcv>
-		struct timer_operation { class type; };
-
-		template<typename Op, typename Buff>
-		struct io_sender { class type; };
-		template<typename Op, typename Buff, typename Rcv>
-		struct io_operation { class type; };
+		/* Use 2 operation headers, one to receive completion of the IO request, another to receive stop requests. */
+		struct io_stop_operation : operation_base {};
+		struct io_operation_base : operation_base
+		{
+			std::atomic<int> flags = {};
+			std::int32_t result = 0;
+			bool waiting = false;
+			bool completed = false;
+			bool stopped = false;
+		};
+		/* Linked operations use an operation header per IO request of the chain. */
+		template<std::size_t I>
+		struct io_link_operation : io_operation_base {};
 
 		class context : operation_base
 		{
 			template<typename>
-			friend struct operation;
+			friend struct basic_operation;
 			template<typename>
 			friend struct timer_operation;
 			template<typename, typename>
 			friend struct io_operation;
+			template<typename, typename, typename>
+			friend struct linked_operation;
 
 		public:
 			using time_point = _io_uring::time_point;
 			using clock = _io_uring::clock;
+			using native_handle_type = basic_handle::native_handle_type;
 
 		private:
-			struct timer_cmp { constexpr bool operator()(const timer_operation_base &a, const timer_operation_base &b) const noexcept { return a.timeout <= b.timeout; }};
-			using timer_queue_t = _detail::priority_queue<timer_operation_base, timer_cmp, &timer_operation_base::timer_prev, &timer_operation_base::timer_next>;
-			using producer_queue_t = _detail::atomic_queue<operation_base, &operation_base::next>;
+			struct timer_cmp { constexpr bool operator()(const timer_operation_base &a, const timer_operation_base &b) const noexcept { return a.timeout < b.timeout; }};
+			using timer_queue_t = _detail::priority_queue<timer_operation_base, timer_cmp, &timer_operation_base::timer_hook>;
+
+			using waitlist_queue_t = _detail::basic_queue<operation_base, &operation_base::next, &operation_base::prev>;
+			using producer_queue_t = _detail::mpsc_queue<operation_base, &operation_base::next>;
 			using consumer_queue_t = _detail::basic_queue<operation_base, &operation_base::next>;
 
+			struct fixed_buffer { const std::byte *data; std::size_t size; int idx; };
+			struct fixed_file { int fd; int idx; };
+
+			/* Parameters of an IO request used to initialize its submission queue entry. */
+			struct io_event
+			{
+				operation_base *node;
+				const void *addr;
+				std::size_t n;
+				extent_type off;
+				const kernel_timespec_t *to;
+				int buff_idx;
+				int fd;
+				std::uint8_t op;
+			};
+
 		public:
 			context(context &&) = delete;
 			context &operator=(context &&) = delete;
@@ -173,10 +243,12 @@ namespace rod
 			/** Initializes the io_uring execution context with a default queue size.
 			 * @throw std::system_error On failure to initialize descriptors or memory mappings. */
 			ROD_API_PUBLIC context();
-			/** Initializes the EPOLL execution context with the specified queue size.
+			/** Initializes the io_uring execution context with the specified queue size and configuration.
 			 * @param entries Number of entries in the io_uring queues.
-			 * @throw std::system_error On failure to initialize descriptors or memory mappings. */
-			ROD_API_PUBLIC explicit context(std::size_t entries);
+			 * @param flags Flags used to configure the io_uring queues and the consumer thread.
+			 * @param submit_threshold Number of pending submission queue entries after which they are submitted even if the consumer thread has scheduled work left. Pending entries are always submitted once the consumer thread runs out of work, or when it wakes up another `io_uring_context` via a message to its ring. `1` by default.
+			 * @throw std::system_error On failure to initialize descriptors or memory mappings, or if \a flags are not supported by the kernel. */
+			ROD_API_PUBLIC explicit context(std::size_t entries, context_flags flags = context_flags::none, std::size_t submit_threshold = 1);
 			ROD_API_PUBLIC ~context();
 
 			/** Blocks the current thread until `finish` is called and executes scheduled operations.
@@ -208,95 +280,100 @@ namespace rod
 			/** Sends a stop request to the stop source associated with the context. */
 			ROD_API_PUBLIC void request_stop();
 
-		private:
-			template<typename F>
-			bool submit_sqe(F &&init) noexcept
-			{
-				if (_cq.pending + _sq.pending >= _cq.size)
-					return false;
-
-				const auto tail = std::atomic_ref{*_sq.tail}.load(std::memory_order_acquire);
-				const auto head = std::atomic_ref{*_sq.head}.load(std::memory_order_acquire);
-				if (_cq.size <= tail - head)
-					return false;
-
-				const auto idx = tail & _sq.mask;
-				if constexpr (std::is_void_v<std::invoke_result_t<F, io_uring_sqe *, decltype(idx)>>)
-					init(_sq.entries, idx);
-				else if (!init(_sq.entries, idx))
-					return false;
-
-				_sq.pending++;
-				_sq.idx_data[idx] = idx;
-				std::atomic_ref{*_sq.tail}.store(tail + 1, std::memory_order_release);
-				return true;
-			}
+			/** Registers \a buffs with the kernel, allowing IO operations on these buffers to avoid re-mapping them for every request.
+			 * File IO requests consisting of a single buffer within a registered buffer will use `IORING_OP_READ_FIXED` or `IORING_OP_WRITE_FIXED`.
+			 * @param buffs Buffers to register with the context. Buffers must remain valid until unregistered.
+			 * @return Void result or an error code on failure to register the buffers.
+			 * @note Previously registered buffers are replaced.
+			 * @note Must not be called while IO operations on the context are in progress. */
+			ROD_API_PUBLIC result<void> register_buffers(std::span<const byte_buffer> buffs) noexcept;
+			/** Unregisters all buffers previously registered via `register_buffers`.
+			 * @return Void result or an error code on failure to unregister the buffers.
+			 * @note Must not be called while IO operations on the context are in progress. */
+			ROD_API_PUBLIC result<void> unregister_buffers() noexcept;
+
+			/** Registers native handles \a hnds with the kernel, allowing IO operations on these handles to avoid the file table lookup for every request.
+			 * File IO requests for a registered handle will be submitted with `IOSQE_FIXED_FILE`.
+			 * @param hnds Native handles to register with the context. Handles must remain open until unregistered.
+			 * @return Void result or an error code on failure to register the handles.
+			 * @note Previously registered handles are replaced.
+			 * @note Must not be called while IO operations on the context are in progress. */
+			ROD_API_PUBLIC result<void> register_files(std::span<const native_handle_type> hnds) noexcept;
+			/** Unregisters all native handles previously registered via `register_files`.
+			 * @return Void result or an error code on failure to unregister the handles.
+			 * @note Must not be called while IO operations on the context are in progress. */
+			ROD_API_PUBLIC result<void> unregister_files() noexcept;
 
+		private:
 			[[nodiscard]] ROD_API_PUBLIC bool is_consumer_thread() const noexcept;
+			[[nodiscard]] bool has_free_sqes(std::uint32_t n) const noexcept;
+
+			template<typename... Fs>
+			bool submit_sqe(Fs &&...init) noexcept;
 
-			void schedule(operation_base *node)
+			void schedule(operation_base *node) noexcept
 			{
 				if (!is_consumer_thread())
 					schedule_producer(node);
 				else
 					schedule_consumer(node);
 			}
-			ROD_API_PUBLIC void schedule_producer(operation_base *node);
-			ROD_API_PUBLIC void schedule_consumer(operation_base *node);
-			ROD_API_PUBLIC void schedule_waitlist(operation_base *node);
+			ROD_API_PUBLIC void schedule_producer(operation_base *node) noexcept;
+			void notify_event_fd() noexcept;
+			ROD_API_PUBLIC void schedule_consumer(operation_base *node) noexcept;
+			ROD_API_PUBLIC void schedule_waitlist(operation_base *node) noexcept;
+			ROD_API_PUBLIC void erase_waitlist(operation_base *node) noexcept;
 
-			bool submit_io_event(int op, void *data, int fd, void *addr, std::size_t n, std::size_t off) noexcept;
+			[[nodiscard]] int find_fixed_file(int fd) const noexcept;
+			[[nodiscard]] int find_fixed_buffer(const void *data, std::size_t size) const noexcept;
+
+			void init_io_sqe(io_uring_sqe &sqe, const io_event &event) const noexcept;
 			bool submit_timer_event(time_point timeout) noexcept;
 			bool submit_queue_event() noexcept;
+			bool submit_message_event(context *dst) noexcept;
 			bool cancel_timer_event() noexcept;
 
-			ROD_API_PUBLIC bool submit_io_event(operation_base *node, io_cmd<async_read_some_t, std::span<std::byte>> cmd) noexcept;
-			ROD_API_PUBLIC bool submit_io_event(operation_base *node, io_cmd<async_write_some_t, std::span<std::byte>> cmd) noexcept;
-			ROD_API_PUBLIC bool submit_io_event(operation_base *node, io_cmd<async_read_some_at_t, std::span<std::byte>> cmd) noexcept;
-			ROD_API_PUBLIC bool submit_io_event(operation_base *node, io_cmd<async_write_some_at_t, std::span<std::byte>> cmd) noexcept;
-
-			template<one_of<async_read_some_t, async_write_some_t> Op, typename Buff>
-			bool submit_io_event(operation_base *node, io_cmd<Op, Buff> cmd) noexcept
-			{
-				const auto bytes = rod::as_byte_buffer(const_cast<std::ranges::range_value_t<Buff> *>(std::data(cmd.buff)), std::size(cmd.buff));
-				return submit_io_event(node, io_cmd<Op, std::span<std::byte>>{cmd.fd, bytes});
-			}
-			template<one_of<async_read_some_at_t, async_write_some_at_t> Op, typename Buff>
-			bool submit_io_event(operation_base *node, io_cmd<Op, Buff> cmd) noexcept
-			{
-				const auto bytes = rod::as_byte_buffer(const_cast<std::ranges::range_value_t<Buff> *>(std::data(cmd.buff)), std::size(cmd.buff));
-				return submit_io_event(node, io_cmd<Op, std::span<std::byte>>{cmd.fd, cmd.off, bytes});
-			}
-
-			ROD_API_PUBLIC bool cancel_io_event(operation_base *node) noexcept;
+			[[nodiscard]] ROD_API_PUBLIC io_event make_io_event(io_operation_base *node, read_some_at_t, int fd, std::span<byte_buffer> buffs, extent_type off, const kernel_timespec_t *to) const noexcept;
+			[[nodiscard]] ROD_API_PUBLIC io_event make_io_event(io_operation_base *node, write_some_at_t, int fd, std::span<const_byte_buffer> buffs, extent_type off, const kernel_timespec_t *to) const noexcept;
+			ROD_API_PUBLIC bool submit_io_event(const io_event &event) noexcept;
+			ROD_API_PUBLIC bool submit_io_chain(const io_event &first, const io_event &second, bool hard) noexcept;
+			ROD_API_PUBLIC bool cancel_io_event(io_operation_base *node, io_operation_base *result_node = nullptr) noexcept;
 
 			ROD_API_PUBLIC void add_timer(timer_operation_base *node) noexcept;
 			ROD_API_PUBLIC void del_timer(timer_operation_base *node) noexcept;
 
 			void acquire_consumer_queue();
 			void acquire_elapsed_timers();
+			void acquire_waitlist() noexcept;
+			void acquire_sq_state() noexcept;
+			/* Submits pending entries without waiting for completion events. Returns `false` if the entries could not be submitted. */
+			bool submit_pending() noexcept;
 			void uring_enter();
 
 			/* TID of the current consumer thread. */
 			std::atomic<std::thread::id> _consumer_tid = {};
 
 			/* Descriptors used for io_uring notifications. */
-			_detail::unique_descriptor _uring_fd = {};
-			_detail::unique_descriptor _event_fd = {};
+			basic_handle _uring_fd;
+			basic_handle _event_fd;
 
 			/* Memory mappings of io_uring queues. */
-			_detail::mmap_handle _cq_mmap = {};
-			_detail::mmap_handle _sq_mmap = {};
-			_detail::mmap_handle _sqe_mmap = {};
+			mmap_handle _cq_mmap = {};
+			mmap_handle _sq_mmap = {};
+			mmap_handle _sqe_mmap = {};
 
 			/* State of io_uring queues. */
 			cq_state_t _cq = {};
 			sq_state_t _sq = {};
 
+			context_flags _flags = {};
+			std::uint32_t _submit_threshold = 1;
+			bool _ring_disabled = false;
+
 			/* Stop source associated with the context. */
 			in_place_stop_source _stop_src;
 			/* Queue of operations waiting for more space in the IO queues. */
-			consumer_queue_t _waitlist_queue;
+			waitlist_queue_t _waitlist_queue;
 			/* Queue of operations pending for dispatch by consumer thread. */
 			consumer_queue_t _consumer_queue;
 			/* Queue of operation pending for acquisition by consumer thread. */
@@ -304,6 +381,10 @@ namespace rod
 			/* Priority queue of pending timers. */
 			timer_queue_t _timers;
 
+			/* Registered buffers & files sorted by address and descriptor respectively. */
+			std::vector<fixed_buffer> _fixed_buffers;
+			std::vector<fixed_file> _fixed_files;
+
 			kernel_timespec_t _ktime = {};
 			time_point _next_timeout = {};
 
@@ -311,385 +392,606 @@ namespace rod
 			bool _timer_started = false;
 			bool _timer_pending = false;
 			bool _queue_active = false;
+			bool _queue_armed = false;
 			bool _stop_pending = false;
+			bool _no_msg_ring = false;
 		};
 
 		template<typename Rcv>
-		class operation<Rcv>::type : operation_base
+		class basic_operation<Rcv>::type : operation_base, empty_base<Rcv>
 		{
-			static void notify_complete(operation_base *ptr) noexcept
-			{
-				auto &op = *static_cast<type *>(ptr);
-				if (get_stop_token(get_env(op._rcv)).stop_requested())
-					set_stopped(std::move(op._rcv));
-				else
-					set_value(std::move(op._rcv));
-			}
+			using rcv_base = empty_base<Rcv>;
 
 		public:
-			constexpr explicit type(context *ctx, Rcv &&rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>) : _rcv(std::forward<Rcv>(rcv)), _ctx(ctx) { notify_func = notify_complete; }
+			constexpr type(context *ctx, Rcv &&rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>) : rcv_base(std::forward<Rcv>(rcv)), _ctx(ctx) {}
 
 			friend void tag_invoke(start_t, type &op) noexcept { op.start(); }
 
 		private:
-			void start() noexcept { _ctx->schedule(this); }
+			void start() noexcept
+			{
+				notify_func = [](operation_base *p) noexcept { static_cast<type *>(p)->complete(); };
+				_ctx->schedule(this);
+			}
+			void complete() noexcept
+			{
+				if (get_stop_token(get_env(rcv_base::value())).stop_requested())
+					set_stopped(std::move(rcv_base::value()));
+				else
+					set_value(std::move(rcv_base::value()));
+			}
 
-			ROD_NO_UNIQUE_ADDRESS Rcv _rcv;
 			context *_ctx;
 		};
 		template<typename Rcv>
-		class timer_operation<Rcv>::type : timer_operation_base
+		class timer_operation<Rcv>::type : timer_operation_base, empty_base<Rcv>
 		{
-			static void notify_value(operation_base *ptr) { static_cast<type *>(ptr)->complete_value(); }
-			static void notify_stopped(operation_base *ptr) { static_cast<type *>(ptr)->complete_stopped(); }
-			static void notify_request_stop(operation_base *ptr) { static_cast<type *>(ptr)->request_stop_consumer(); }
+			using rcv_base = empty_base<Rcv>;
 
 		public:
-			constexpr explicit type(context *ctx, time_point timeout, Rcv rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>) : timer_operation_base(ctx, timeout, get_stop_token(get_env(rcv)).stop_possible()), _rcv(std::move(rcv)) {}
+			constexpr type(context *ctx, time_point tp, Rcv &&rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>) : timer_operation_base(tp), rcv_base(std::forward<Rcv>(rcv)), _ctx(ctx) {}
 
 			friend void tag_invoke(start_t, type &op) noexcept { op.start(); }
 
 		private:
-			void complete_value() noexcept
+			void start() noexcept
 			{
-				/* Handle spontaneous stop requests. */
-				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
+				if (_ctx->is_consumer_thread())
+					start_consumer();
+				else
 				{
-					_stop_cb.reset();
-					if (get_stop_token(get_env(_rcv)).stop_requested())
+					notify_func = [](operation_base *p) noexcept { static_cast<type *>(p)->start_consumer(); };
+					_ctx->schedule_producer(this);
+				}
+			}
+			void start_consumer() noexcept
+			{
+				/* Bail if a stop has already been requested. */
+				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
+					if (get_stop_token(get_env(rcv_base::value())).stop_requested())
 					{
-						complete_stopped();
+						notify_func = [](operation_base *p) noexcept { static_cast<type *>(p)->complete_stopped(); };
+						_ctx->schedule_consumer(this);
 						return;
 					}
-				}
-				set_value(std::move(_rcv));
+
+				notify_func = [](operation_base *p) noexcept { static_cast<type *>(p)->complete_value(); };
+				_ctx->add_timer(this);
+
+				/* Initialize the stop callback for stoppable environments. */
+				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
+					_stop_cb.init(get_env(rcv_base::value()), this);
+			}
+
+			void request_stop()
+			{
+				/* Timer has already been dispatched by the consumer thread. */
+				if (flags.fetch_or(flags_t::stop_requested, std::memory_order_acq_rel) & flags_t::dispatched)
+					return;
+
+				notify_func = [](operation_base *p) noexcept { static_cast<type *>(p)->request_stop_consumer(); };
+				_ctx->schedule(this);
+			}
+			void request_stop_consumer() noexcept
+			{
+				/* Timer is still in the queue unless it has elapsed. */
+				if (!(flags.load(std::memory_order_acquire) & flags_t::dispatched))
+					_ctx->del_timer(this);
+				complete_stopped();
+			}
+
+			void complete_value() noexcept
+			{
+				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
+					_stop_cb.reset();
+				set_value(std::move(rcv_base::value()));
 			}
 			void complete_stopped() noexcept
 			{
 				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
-					set_stopped(std::move(_rcv));
+				{
+					_stop_cb.reset();
+					set_stopped(std::move(rcv_base::value()));
+				}
 				else
 					std::terminate();
 			}
 
+			context *_ctx;
+			stop_cb<env_of_t<Rcv>, &type::request_stop> _stop_cb;
+		};
+		/* Trims the buffers to the amount of bytes transferred. */
+		template<typename Buff>
+		inline std::span<Buff> trim_buffers(std::span<Buff> buffs, std::int32_t res) noexcept
+		{
+			auto bytes_done = extent_type(res);
+			for (std::size_t i = 0; i < buffs.size(); ++i)
+			{
+				if (bytes_done == 0)
+					return std::span(buffs.begin(), i);
+
+				const auto chunk_size = std::min(bytes_done, buffs[i].size());
+				buffs[i] = std::span(buffs[i].begin(), chunk_size);
+				bytes_done -= chunk_size;
+			}
+			return buffs;
+		}
+
+		template<typename Op, typename Rcv>
+		class io_operation<Op, Rcv>::type : io_operation_base, io_stop_operation, empty_base<Rcv>
+		{
+			using request_t = io_request_t<fs::file_handle, Op>;
+			using result_t = io_result_t<fs::file_handle, Op>;
+			using rcv_base = empty_base<Rcv>;
+
+		public:
+			type(type &&) = delete;
+			type &operator=(type &&) = delete;
+
+			type(context *ctx, int fd, request_t req, const fs::file_timeout &to, Rcv &&rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>) : rcv_base(std::forward<Rcv>(rcv)), _req(std::move(req)), _ctx(ctx), _fd(fd)
+			{
+				_has_timeout = to_kernel_timespec(to, _ktime);
+			}
+
+			friend void tag_invoke(start_t, type &op) noexcept { op.start(); }
+
+		private:
 			void start() noexcept
 			{
-				if (ctx->is_consumer_thread())
+				if (_ctx->is_consumer_thread())
 					start_consumer();
 				else
 				{
-					notify_func = [](operation_base *p) noexcept { static_cast<type *>(p)->start_consumer(); };
-					ctx->schedule_producer(this);
+					io_operation_base::notify_func = [](operation_base *p) noexcept { static_cast<type *>(static_cast<io_operation_base *>(p))->start_consumer(); };
+					_ctx->schedule_producer(static_cast<io_operation_base *>(this));
 				}
 			}
-			void start_consumer()
+			void start_consumer() noexcept
 			{
 				/* Bail if a stop has already been requested. */
 				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
-					if (get_stop_token(get_env(_rcv)).stop_requested())
+					if (get_stop_token(get_env(rcv_base::value())).stop_requested())
 					{
-						notify_func = notify_stopped;
-						ctx->schedule_consumer(this);
+						complete_stopped();
 						return;
 					}
 
-				notify_func = notify_value;
-				ctx->add_timer(this);
+				submit_io();
 
 				/* Initialize the stop callback for stoppable environments. */
 				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
-					_stop_cb.init(get_env(_rcv), this);
+					_stop_cb.init(get_env(rcv_base::value()), this);
+			}
+			void submit_io() noexcept
+			{
+				io_operation_base::notify_func = [](operation_base *p) noexcept { static_cast<type *>(static_cast<io_operation_base *>(p))->complete_io(); };
+				if (!(io_operation_base::waiting = !_ctx->submit_io_event(_ctx->make_io_event(this, Op{}, _fd, _req.buffs, _req.off, _has_timeout ? &_ktime : nullptr))))
+					return;
+
+				/* Wait for space in the submission queue. */
+				io_operation_base::notify_func = [](operation_base *p) noexcept { static_cast<type *>(static_cast<io_operation_base *>(p))->submit_io(); };
+				_ctx->schedule_waitlist(static_cast<io_operation_base *>(this));
 			}
 
 			void request_stop()
 			{
-				if constexpr (!_detail::stoppable_env<env_of_t<Rcv>>)
-					std::terminate();
-				else if (ctx->is_consumer_thread())
-					request_stop_consumer();
-				else if (!(flags.fetch_or(flags_t::stop_requested, std::memory_order_acq_rel) & flags_t::dispatched))
+				/* Operation has already been dispatched by the consumer thread. */
+				if (io_operation_base::flags.fetch_or(flags_t::stop_requested, std::memory_order_acq_rel) & flags_t::dispatched)
+					return;
+
+				io_stop_operation::notify_func = [](operation_base *p) noexcept { static_cast<type *>(static_cast<io_stop_operation *>(p))->request_stop_consumer(); };
+				_ctx->schedule(static_cast<io_stop_operation *>(this));
+			}
+			void request_stop_consumer() noexcept
+			{
+				io_operation_base::stopped = true;
+				if (io_operation_base::completed)
+					complete_result();
+				else if (io_operation_base::waiting)
+				{
+					_ctx->erase_waitlist(static_cast<io_operation_base *>(this));
+					complete_stopped();
+				}
+				else if (!_ctx->cancel_io_event(this))
 				{
-					/* Timer has not yet been dispatched, schedule stop request. */
-					notify_func = notify_request_stop;
-					ctx->schedule_producer(this);
+					/* Retry the cancellation once there is space in the submission queue. */
+					io_operation_base::stopped = false;
+					io_stop_operation::notify_func = [](operation_base *p) noexcept { static_cast<type *>(static_cast<io_stop_operation *>(p))->request_stop_consumer(); };
+					_ctx->schedule_waitlist(static_cast<io_stop_operation *>(this));
 				}
 			}
-			void request_stop_consumer()
+
+			void complete_io() noexcept
+			{
+				io_operation_base::completed = true;
+
+				/* Pending stop request will take care of completion. */
+				if ((io_operation_base::flags.fetch_or(flags_t::dispatched, std::memory_order_acq_rel) & flags_t::stop_requested) && !io_operation_base::stopped)
+					return;
+				complete_result();
+			}
+			void complete_result() noexcept
 			{
 				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
 					_stop_cb.reset();
 
-				notify_func = notify_stopped;
-				if (!(flags.load(std::memory_order_relaxed) & flags_t::dispatched))
+				if (const auto res = io_operation_base::result; res >= 0) [[likely]]
+					set_value(std::move(rcv_base::value()), result_t(trim_buffers(std::move(_req.buffs), res)));
+				else if (res != -ECANCELED)
+					set_value(std::move(rcv_base::value()), result_t(io_status_code(std::error_code(-res, std::system_category()), 0)));
+				else if (!io_operation_base::stopped)
+					set_value(std::move(rcv_base::value()), result_t(io_status_code(std::make_error_code(std::errc::timed_out), 0)));
+				else
+					complete_stopped();
+			}
+			void complete_stopped() noexcept
+			{
+				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
 				{
-					/* Timer has not yet been dispatched, schedule stop completion. */
-					ctx->del_timer(this);
-					ctx->schedule_consumer(this);
+					_stop_cb.reset();
+					set_stopped(std::move(rcv_base::value()));
 				}
+				else
+					std::terminate();
 			}
 
-			using stop_cb_t = stop_cb<env_of_t<Rcv>, &type::request_stop>;
+			stop_cb<env_of_t<Rcv>, &type::request_stop> _stop_cb;
+			request_t _req;
+			context *_ctx;
+			int _fd;
 
-			ROD_NO_UNIQUE_ADDRESS stop_cb_t _stop_cb;
-			ROD_NO_UNIQUE_ADDRESS Rcv _rcv;
+			kernel_timespec_t _ktime = {};
+			bool _has_timeout = false;
 		};
-		template<typename Op, typename Buff, typename Rcv>
-		class io_operation<Op, Rcv>::type : complete_base, stop_base
+		template<typename Op0, typename Op1, typename Rcv>
+		class linked_operation<Op0, Op1, Rcv>::type : io_link_operation<0>, io_link_operation<1>, io_link_operation<2>, io_stop_operation, empty_base<Rcv>
 		{
-			using io_cmd_t = io_cmd<Op, Buff>;
+			template<std::size_t I>
+			using link_t = io_link_operation<I>;
+			using rcv_base = empty_base<Rcv>;
+
+			template<typename Op>
+			struct link_request
+			{
+				template<typename Snd>
+				explicit link_request(const Snd &snd) noexcept : req(snd._req), fd(snd._fd) { has_timeout = to_kernel_timespec(snd._to, ktime); }
+
+				[[nodiscard]] const kernel_timespec_t *timeout() const noexcept { return has_timeout ? &ktime : nullptr; }
 
-			static void notify_start(operation_base *ptr) { static_cast<type *>(static_cast<complete_base *>(ptr))->start_consumer(); }
-			static void notify_value(operation_base *ptr) { static_cast<type *>(static_cast<complete_base *>(ptr))->complete_value(); }
-			static void notify_stopped(operation_base *ptr) { static_cast<type *>(static_cast<stop_base *>(ptr))->complete_stopped(); }
-			static void notify_request_stop(operation_base *ptr) { static_cast<type *>(static_cast<stop_base *>(ptr))->request_stop(); }
+				io_request_t<fs::file_handle, Op> req;
+				kernel_timespec_t ktime = {};
+				bool has_timeout = false;
+				int fd;
+			};
 
 		public:
-			constexpr explicit type(context *ctx, Rcv &&rcv, io_cmd_t cmd) noexcept(std::is_nothrow_move_constructible_v<Rcv>) : _rcv(std::forward<Rcv>(rcv)), _cmd(std::move(cmd)), _ctx(ctx) {}
+			type(type &&) = delete;
+			type &operator=(type &&) = delete;
+
+			template<typename Snd0, typename Snd1>
+			type(context *ctx, const Snd0 &first, const Snd1 &second, bool hard, Rcv &&rcv) noexcept(std::is_nothrow_move_constructible_v<Rcv>) : rcv_base(std::forward<Rcv>(rcv)), _first(first), _second(second), _ctx(ctx), _hard(hard) {}
 
 			friend void tag_invoke(start_t, type &op) noexcept { op.start(); }
 
 		private:
-			void complete_value() noexcept
-			{
-				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
-					_stop_cb.reset();
-				if (_flags.fetch_or(flags_t::dispatched, std::memory_order_acq_rel) & flags_t::stop_requested)
-					return;
-
-				if (complete_base::result >= 0)
-					[[likely]] set_value(std::move(_rcv), static_cast<std::size_t>(complete_base::result));
-				else if (const auto err = int(-complete_base::result); err != ECANCELED)
-					set_error(std::move(_rcv), std::error_code{err, std::system_category()});
-				else
-					set_stopped(std::move(_rcv));
-			}
-
 			void start() noexcept
 			{
 				if (_ctx->is_consumer_thread())
 					start_consumer();
 				else
 				{
-					complete_base::notify_func = notify_start;
-					_ctx->schedule_producer(static_cast<complete_base *>(this));
+					link_t<0>::notify_func = [](operation_base *p) noexcept { static_cast<type *>(static_cast<link_t<0> *>(p))->start_consumer(); };
+					_ctx->schedule_producer(static_cast<link_t<0> *>(this));
 				}
 			}
-			void start_consumer()
+			void start_consumer() noexcept
+			{
+				/* Bail if a stop has already been requested. */
+				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
+					if (get_stop_token(get_env(rcv_base::value())).stop_requested())
+					{
+						complete_stopped();
+						return;
+					}
+
+				submit_io();
+
+				/* Initialize the stop callback for stoppable environments. */
+				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
+					_stop_cb.init(get_env(rcv_base::value()), this);
+			}
+			void submit_io() noexcept
 			{
-				if (_flags.load(std::memory_order_acquire) & flags_t::stop_requested)
-					return; /* Stopped on a different thread. */
+				link_t<0>::notify_func = [](operation_base *p) noexcept { static_cast<type *>(static_cast<link_t<0> *>(p))->template complete_io<0>(); };
+				link_t<1>::notify_func = [](operation_base *p) noexcept { static_cast<type *>(static_cast<link_t<1> *>(p))->template complete_io<1>(); };
 
-				complete_base::notify_func = notify_value;
-				if (!_ctx->submit_io_event(static_cast<complete_base *>(this), _cmd))
+				/* Both requests are submitted in the same batch, the kernel will start the second one once the first one completes. */
+				const auto first = _ctx->make_io_event(static_cast<link_t<0> *>(this), Op0{}, _first.fd, _first.req.buffs, _first.req.off, _first.timeout());
+				const auto second = _ctx->make_io_event(static_cast<link_t<1> *>(this), Op1{}, _second.fd, _second.req.buffs, _second.req.off, _second.timeout());
+				if (!(link_t<0>::waiting = !_ctx->submit_io_chain(first, second, _hard)))
+					return;
+
+				/* Wait for space in the submission queue. */
+				link_t<0>::notify_func = [](operation_base *p) noexcept { static_cast<type *>(static_cast<link_t<0> *>(p))->submit_io(); };
+				_ctx->schedule_waitlist(static_cast<link_t<0> *>(this));
+			}
+
+			void request_stop()
+			{
+				/* Operation has already been dispatched by the consumer thread. */
+				if (link_t<0>::flags.fetch_or(flags_t::stop_requested, std::memory_order_acq_rel) & flags_t::dispatched)
+					return;
+
+				io_stop_operation::notify_func = [](operation_base *p) noexcept { static_cast<type *>(static_cast<io_stop_operation *>(p))->request_stop_consumer(); };
+				_ctx->schedule(static_cast<io_stop_operation *>(this));
+			}
+			void request_stop_consumer() noexcept
+			{
+				link_t<0>::stopped = true;
+				if (link_t<0>::completed && link_t<1>::completed)
+					complete_result();
+				else if (link_t<0>::waiting)
 				{
-					complete_base::notify_func = notify_start;
-					_ctx->schedule_waitlist(static_cast<complete_base *>(this));
+					_ctx->erase_waitlist(static_cast<link_t<0> *>(this));
+					complete_stopped();
+				}
+				else if (link_t<0>::completed)
+					cancel_second();
+				else if (!_ctx->cancel_io_event(static_cast<link_t<0> *>(this)))
+				{
+					/* Retry the cancellation once there is space in the submission queue. */
+					link_t<0>::stopped = false;
+					io_stop_operation::notify_func = [](operation_base *p) noexcept { static_cast<type *>(static_cast<io_stop_operation *>(p))->request_stop_consumer(); };
+					_ctx->schedule_waitlist(static_cast<io_stop_operation *>(this));
 				}
 			}
 
-			void request_stop()
+			/* Second request is not visible to the kernel until the first one completes, and is not cancelled with it if hard-linked.
+			 * Use the third operation header to receive the result of the cancellation, and retry until the second request is found. */
+			void cancel_second() noexcept
+			{
+				if (link_t<1>::completed || link_t<2>::completed || link_t<2>::waiting)
+					return;
+
+				link_t<2>::notify_func = [](operation_base *p) noexcept { static_cast<type *>(static_cast<link_t<2> *>(p))->complete_cancel(); };
+				if ((link_t<2>::completed = _ctx->cancel_io_event(static_cast<link_t<1> *>(this), static_cast<link_t<2> *>(this))))
+					return;
+
+				/* Retry the cancellation once there is space in the submission queue. */
+				link_t<2>::notify_func = [](operation_base *p) noexcept
+				{
+					const auto op = static_cast<type *>(static_cast<link_t<2> *>(p));
+					op->link_t<2>::waiting = false;
+					op->cancel_second();
+				};
+				link_t<2>::waiting = true;
+				_ctx->schedule_waitlist(static_cast<link_t<2> *>(this));
+			}
+			void complete_cancel() noexcept
 			{
-				if (_flags.fetch_or(flags_t::stop_requested, std::memory_order_acq_rel) & flags_t::dispatched)
-					return; /* Already completed on a different thread */
+				/* Completion flag of the cancellation header is used to mark a pending cancellation request. */
+				link_t<2>::completed = false;
+				if (link_t<2>::result == -ENOENT)
+					cancel_second();
+				complete_chain();
+			}
 
-				stop_base::notify_func = notify_stopped;
-				if (!_ctx->is_consumer_thread())
+			template<std::size_t I>
+			void complete_io() noexcept
+			{
+				link_t<I>::completed = true;
+				if constexpr (I == 0)
 				{
-					stop_base::notify_func = notify_request_stop;
-					_ctx->schedule_producer(static_cast<stop_base *>(this));
+					/* Second request may have been started by the kernel before the first one was cancelled. */
+					if (link_t<0>::stopped)
+						cancel_second();
 				}
-				else if (!_ctx->cancel_io_event(static_cast<stop_base *>(this)))
+				complete_chain();
+			}
+			void complete_chain() noexcept
+			{
+				/* Wait for completion events of both requests and the pending cancellation. */
+				if (!link_t<0>::completed || !link_t<1>::completed || link_t<2>::completed)
+					return;
+				if (link_t<2>::waiting)
 				{
-					stop_base::notify_func = notify_request_stop;
-					_ctx->schedule_waitlist(static_cast<stop_base *>(this));
+					link_t<2>::waiting = false;
+					_ctx->erase_waitlist(static_cast<link_t<2> *>(this));
 				}
+
+				/* Pending stop request will take care of completion. */
+				if ((link_t<0>::flags.fetch_or(flags_t::dispatched, std::memory_order_acq_rel) & flags_t::stop_requested) && !link_t<0>::stopped)
+					return;
+				complete_result();
+			}
+			void complete_result() noexcept
+			{
+				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
+					_stop_cb.reset();
+
+				const auto res0 = link_t<0>::result, res1 = link_t<1>::result;
+				if (link_t<0>::stopped && (res0 == -ECANCELED || res1 == -ECANCELED))
+					return complete_stopped();
+
+				/* Unless hard-linked, the kernel cancels the second request if the first one fails or transfers less bytes than requested. */
+				const auto broken = !_hard && (res0 < 0 || extent_type(res0) != request_size(_first.req.buffs));
+				auto result0 = make_result(_first, res0, false);
+				auto result1 = make_result(_second, res1, broken);
+				set_value(std::move(rcv_base::value()), std::move(result0), std::move(result1));
 			}
 			void complete_stopped() noexcept
 			{
 				if constexpr (_detail::stoppable_env<env_of_t<Rcv>>)
-					set_stopped(std::move(_rcv));
+				{
+					_stop_cb.reset();
+					set_stopped(std::move(rcv_base::value()));
+				}
 				else
 					std::terminate();
 			}
 
-			using stop_cb_t = stop_cb<env_of_t<Rcv>, &type::request_stop>;
+			template<typename Buff>
+			[[nodiscard]] static extent_type request_size(std::span<Buff> buffs) noexcept
+			{
+				extent_type result = 0;
+				for (auto &buff: buffs) result += buff.size();
+				return result;
+			}
+			template<typename Op>
+			[[nodiscard]] static io_result_t<fs::file_handle, Op> make_result(link_request<Op> &link, std::int32_t res, bool broken) noexcept
+			{
+				using result_t = io_result_t<fs::file_handle, Op>;
+				if (res >= 0) [[likely]]
+					return result_t(trim_buffers(std::move(link.req.buffs), res));
+				else if (res != -ECANCELED)
+					return result_t(io_status_code(std::error_code(-res, std::system_category()), 0));
+				else
+					return result_t(io_status_code(std::make_error_code(broken ? std::errc::operation_canceled : std::errc::timed_out), 0));
+			}
 
-			ROD_NO_UNIQUE_ADDRESS stop_cb_t _stop_cb;
-			ROD_NO_UNIQUE_ADDRESS Rcv _rcv;
-			std::atomic<int> _flags = {};
-			io_cmd_t _cmd;
+			stop_cb<env_of_t<Rcv>, &type::request_stop> _stop_cb;
+			link_request<Op0> _first;
+			link_request<Op1> _second;
 			context *_ctx;
+			bool _hard;
 		};
 
-		class sender
+		class basic_sender : public sender_base<set_value_t()>
 		{
-		public:
-			using is_sender = std::true_type;
-
-		private:
 			template<typename Rcv>
-			using operation_t = typename operation<std::decay_t<Rcv>>::type;
-
-			template<typename Env>
-			using stop_signs_t = std::conditional_t<_detail::stoppable_env<Env>, completion_signatures<set_stopped_t()>, completion_signatures<>>;
-			template<typename Env>
-			using signs_t = _detail::concat_tuples_t<completion_signatures<set_value_t(), set_error_t(std::error_code)>, stop_signs_t<Env>>;
+			using operation_t = typename basic_operation<std::decay_t<Rcv>>::type;
 
 		public:
-			constexpr explicit sender(context *ctx) noexcept : _ctx(ctx) {}
+			using sender_base::sender_base;
 
-			friend constexpr env tag_invoke(get_env_t, const sender &s) noexcept { return {s._ctx}; }
-			template<decays_to_same<sender> T, typename Env>
-			friend constexpr signs_t<Env> tag_invoke(get_completion_signatures_t, T &&, Env) noexcept { return {}; }
-
-			template<decays_to_same<sender> T, rod::receiver Rcv> requires receiver_of<Rcv, signs_t<env_of_t<Rcv>>>
+			template<decays_to_same<basic_sender> T, rod::receiver Rcv> requires receiver_of<Rcv, completion_signatures_of_t<basic_sender, env_of_t<Rcv>>>
 			friend constexpr operation_t<Rcv> tag_invoke(connect_t, T &&s, Rcv &&rcv) noexcept(std::is_nothrow_constructible_v<std::decay_t<Rcv>, Rcv>)
 			{
 				return operation_t<Rcv>{s._ctx, std::forward<Rcv>(rcv)};
 			}
-
-		private:
-			context *_ctx;
 		};
-		class timer_sender
+		class timer_sender : public sender_base<set_value_t()>
 		{
-		public:
-			using is_sender = std::true_type;
-
-		private:
 			template<typename Rcv>
 			using operation_t = typename timer_operation<std::decay_t<Rcv>>::type;
 
-			template<typename Env>
-			using stop_signs_t = std::conditional_t<_detail::stoppable_env<Env>, completion_signatures<set_stopped_t()>, completion_signatures<>>;
-			template<typename Env>
-			using signs_t = _detail::concat_tuples_t<completion_signatures<set_value_t(), set_error_t(std::error_code)>, stop_signs_t<Env>>;
-
 		public:
-			constexpr explicit timer_sender(time_point tp, context *ctx) noexcept : _tp(tp), _ctx(ctx) {}
-
-			friend constexpr env tag_invoke(get_env_t, const timer_sender &s) noexcept { return {s._ctx}; }
-			template<decays_to_same<timer_sender> T, typename Env>
-			friend constexpr signs_t<Env> tag_invoke(get_completion_signatures_t, T &&, Env) noexcept { return {}; }
+			constexpr explicit timer_sender(context *ctx, time_point tp) noexcept : sender_base(ctx), _tp(tp) {}
 
-			template<decays_to_same<timer_sender> T, rod::receiver Rcv> requires receiver_of<Rcv, signs_t<env_of_t<Rcv>>>
+			template<decays_to_same<timer_sender> T, rod::receiver Rcv> requires receiver_of<Rcv, completion_signatures_of_t<timer_sender, env_of_t<Rcv>>>
 			friend constexpr operation_t<Rcv> tag_invoke(connect_t, T &&s, Rcv &&rcv) noexcept(std::is_nothrow_constructible_v<std::decay_t<Rcv>, Rcv>)
 			{
-				return operation_t<Rcv>{s._ctx, s._tp, std::forward<Rcv>(rcv)};
+				return operation_t<Rcv>(s._ctx, s._tp, std::forward<Rcv>(rcv));
 			}
 
 		private:
 			time_point _tp;
-			context *_ctx;
 		};
-		template<typename Op, typename Buff>
-		class io_sender<Op, Buff>::type
+		template<typename Op>
+		class io_sender<Op>::type : public sender_base<set_value_t(io_result_t<fs::file_handle, Op>)>
 		{
-		public:
-			using is_sender = std::true_type;
-
-		private:
-			using signs_t = completion_signatures<set_value_t(std::size_t), set_error_t(std::error_code), set_stopped_t()>;
 			template<typename Rcv>
-			using operation_t = typename io_operation<Op, Buff, std::decay_t<Rcv>>::type;
-			using io_cmd_t = io_cmd<Op, Buff>;
+			using operation_t = typename io_operation<Op, std::decay_t<Rcv>>::type;
+			using request_t = io_request_t<fs::file_handle, Op>;
+
+			template<typename, typename>
+			friend struct linked_sender;
+			template<typename, typename, typename>
+			friend struct linked_operation;
 
 		public:
-			template<typename... Args>
-			constexpr explicit type(context *ctx, Buff2 &&buff, Args &&...args) noexcept : _cmd(std::forward<Args>(args)...), _ctx(ctx) {}
+			using io_operation_type = Op;
+
+			constexpr explicit type(context *ctx, int fd, request_t req, const fs::file_timeout &to) noexcept : type::sender_base(ctx), _req(std::move(req)), _to(to), _fd(fd) {}
 
-			friend env tag_invoke(get_env_t, const type &s) noexcept { return {s._ctx}; }
-			template<decays_to_same<type> T, typename Env>
-			friend signs_t tag_invoke(get_completion_signatures_t, T &&, Env) noexcept { return {}; }
-			template<decays_to_same<type> T, receiver_of<signs_t> Rcv>
+			template<decays_to_same<type> T, rod::receiver Rcv> requires receiver_of<Rcv, completion_signatures_of_t<type, env_of_t<Rcv>>>
 			friend operation_t<Rcv> tag_invoke(connect_t, T &&s, Rcv &&rcv) noexcept(std::is_nothrow_constructible_v<std::decay_t<Rcv>, Rcv>)
 			{
-				return operation_t<Rcv>{s._ctx, std::forward<Rcv>(rcv), std::forward<T>(s)._cmd};
+				return operation_t<Rcv>(s._ctx, s._fd, std::forward<T>(s)._req, s._to, std::forward<Rcv>(rcv));
 			}
 
 		private:
-			io_cmd_t _cmd;
-			context *_ctx;
+			request_t _req;
+			fs::file_timeout _to;
+			int _fd;
 		};
-
-		/* io_uring scheduler handles. */
-		class file_handle : public _file::system_handle
+		template<typename Op0, typename Op1>
+		class linked_sender<Op0, Op1>::type : public sender_base<set_value_t(io_result_t<fs::file_handle, Op0>, io_result_t<fs::file_handle, Op1>)>
 		{
-			template<typename Op, typename Buff>
-			using io_sender_t = typename io_sender<Op, Buff>::type;
+			template<typename Rcv>
+			using operation_t = typename linked_operation<Op0, Op1, std::decay_t<Rcv>>::type;
+			using first_t = typename io_sender<Op0>::type;
+			using second_t = typename io_sender<Op1>::type;
 
 		public:
-			file_handle() = delete;
+			constexpr explicit type(first_t first, second_t second, bool hard) noexcept : type::sender_base(first._ctx), _first(std::move(first)), _second(std::move(second)), _hard(hard) {}
 
-			constexpr file_handle(file_handle &&other) noexcept { swap(other); }
-			constexpr file_handle &operator=(file_handle &&other) noexcept { return (swap(other), *this); }
-
-			constexpr explicit file_handle(context *ctx) noexcept : _ctx(ctx) {}
-
-			std::error_code open(const char *path, int mode, int prot) noexcept { return _file::system_handle::open(path, mode, prot | _file::system_handle::nonblock); }
-			std::error_code open(const wchar_t *path, int mode, int prot) noexcept { return _file::system_handle::open(path, mode, prot | _file::system_handle::nonblock); }
-
-			constexpr void swap(file_handle &other) noexcept
+			template<decays_to_same<type> T, rod::receiver Rcv> requires receiver_of<Rcv, completion_signatures_of_t<type, env_of_t<Rcv>>>
+			friend operation_t<Rcv> tag_invoke(connect_t, T &&s, Rcv &&rcv) noexcept(std::is_nothrow_constructible_v<std::decay_t<Rcv>, Rcv>)
 			{
-				_file::system_handle::swap(other);
-				std::swap(_ctx, other._ctx);
+				return operation_t<Rcv>(s._ctx, s._first, s._second, s._hard, std::forward<Rcv>(rcv));
 			}
-			friend constexpr void swap(file_handle &a, file_handle &b) noexcept { a.swap(b); }
-
-		public:
-			template<reference_to_same<file_handle> Hnd, typename Buff>
-			friend auto tag_invoke(async_read_some_t, Hnd &&hnd, Buff &&buff) noexcept { return io_sender_t<async_read_some_t, Buff>{hnd._ctx, hnd.native_handle(), std::forward<Buff>(buff)}; }
-			template<reference_to_same<file_handle> Hnd, typename Buff>
-			friend auto tag_invoke(async_write_some_t, Hnd &&hnd, Buff &&buff) noexcept { return io_sender_t<async_write_some_t, Buff>{hnd._ctx, hnd.native_handle(), std::forward<Buff>(buff)}; }
-			template<reference_to_same<file_handle> Hnd, std::convertible_to<std::size_t> Pos, typename Buff>
-			friend auto tag_invoke(async_read_some_at_t, Hnd &&hnd, Pos pos, Buff &&buff) noexcept { return io_sender_t<async_read_some_at_t, Buff>{hnd._ctx, hnd.native_handle(), static_cast<std::size_t>(pos), std::forward<Buff>(buff)}; }
-			template<reference_to_same<file_handle> Hnd, std::convertible_to<std::size_t> Pos, typename Buff>
-			friend auto tag_invoke(async_write_some_at_t, Hnd &&hnd, Pos pos, Buff &&buff) noexcept { return io_sender_t<async_write_some_at_t, Buff>{hnd._ctx, hnd.native_handle(), static_cast<std::size_t>(pos), std::forward<Buff>(buff)}; }
 
 		private:
-			/* Hide base open so the above overloads will work. */
-			using _file::system_handle::open;
-
-			context *_ctx = nullptr;
+			first_t _first;
+			second_t _second;
+			bool _hard;
 		};
-		/* fifo_handle */
-		/* sock_handle */
+
+		template<typename Snd>
+		concept linkable_sender = requires { typename std::decay_t<Snd>::io_operation_type; } && std::same_as<std::decay_t<Snd>, typename io_sender<typename std::decay_t<Snd>::io_operation_type>::type>;
+		template<typename Snd0, typename Snd1>
+		using linked_sender_t = typename linked_sender<typename std::decay_t<Snd0>::io_operation_type, typename std::decay_t<Snd1>::io_operation_type>::type;
+
+		/** Returns a sender that submits file IO operations of \a first and \a second as a chain of linked submission queue entries (`IOSQE_IO_LINK`).
+		 * The kernel starts the operation of \a second once the operation of \a first completes, without a round trip through the consumer thread.
+		 * @param first File IO sender of an io_uring context, executed first.
+		 * @param second File IO sender of the same io_uring context, executed after \a first.
+		 * @return Sender completing with results of both operations.
+		 * @note If the operation of \a first fails or transfers less bytes than requested, the operation of \a second completes with `std::errc::operation_canceled`. */
+		template<linkable_sender Snd0, linkable_sender Snd1>
+		[[nodiscard]] constexpr linked_sender_t<Snd0, Snd1> linked(Snd0 &&first, Snd1 &&second) noexcept { return linked_sender_t<Snd0, Snd1>(std::forward<Snd0>(first), std::forward<Snd1>(second), false); }
+		/** Returns a sender that submits file IO operations of \a first and \a second as a chain of hard-linked submission queue entries (`IOSQE_IO_HARDLINK`).
+		 * Unlike `linked`, the operation of \a second is executed even if the operation of \a first fails or transfers less bytes than requested.
+		 * @param first File IO sender of an io_uring context, executed first.
+		 * @param second File IO sender of the same io_uring context, executed after \a first.
+		 * @return Sender completing with results of both operations. */
+		template<linkable_sender Snd0, linkable_sender Snd1>
+		[[nodiscard]] constexpr linked_sender_t<Snd0, Snd1> hard_linked(Snd0 &&first, Snd1 &&second) noexcept { return linked_sender_t<Snd0, Snd1>(std::forward<Snd0>(first), std::forward<Snd1>(second), true); }
 
 		class scheduler
 		{
-			template<typename Op, typename Buff>
-			using io_sender_t = typename io_sender<Op, Buff>::type;
+			template<typename Op>
+			using io_sender_t = typename io_sender<Op>::type;
 
 		public:
 			constexpr explicit scheduler(context *ctx) noexcept : _ctx(ctx) {}
 
+			/** Returns the current time point of the clock used by the context. */
+			[[nodiscard]] time_point now() const noexcept { return clock::now(); }
+
+			[[nodiscard]] friend constexpr bool operator==(const scheduler &a, const scheduler &b) noexcept { return a._ctx == b._ctx; }
+			[[nodiscard]] friend constexpr bool operator!=(const scheduler &a, const scheduler &b) noexcept { return a._ctx != b._ctx; }
+
+		private:
+			context *_ctx;
+
+		public:
 			friend constexpr auto tag_invoke(get_forward_progress_guarantee_t, const scheduler &) noexcept { return forward_progress_guarantee::weakly_parallel; }
 			friend constexpr bool tag_invoke(execute_may_block_caller_t, const scheduler &) noexcept { return true; }
 
 			template<decays_to_same<scheduler> T>
-			friend constexpr auto tag_invoke(schedule_t, T &&s) noexcept { return sender{s._ctx}; }
-			template<decays_to_same<scheduler> T, decays_to_same<time_point> Tp>
-			friend constexpr auto tag_invoke(schedule_at_t, T &&s, Tp &&tp) noexcept { return timer_sender{std::forward<Tp>(tp), s._ctx}; }
+			friend constexpr auto tag_invoke(schedule_t, T &&s) noexcept { return basic_sender{s._ctx}; }
+			template<decays_to_same<scheduler> T, typename Tp> requires std::constructible_from<time_point, Tp>
+			friend constexpr auto tag_invoke(schedule_at_t, T &&s, Tp &&tp) noexcept { return timer_sender(s._ctx, time_point(std::forward<Tp>(tp))); }
 			template<decays_to_same<scheduler> T, typename Dur>
 			friend constexpr auto tag_invoke(schedule_after_t, T &&s, Dur &&dur) noexcept { return schedule_at(std::forward<T>(s), s.now() + dur); }
 
-			template<decays_to_same<scheduler> T>
-			friend result<_file::basic_file<file_handle>, std::error_code> tag_invoke(open_file_t, T &&sch, auto &&path, int mode, int prot) noexcept
-			{
-				auto file = _file::basic_file<file_handle>{sch._ctx};
-				if (auto err = file.open(path, mode, prot); !err) [[likely]]
-					return file;
-				else
-					return err;
-			}
-
-			/** Returns the current time point of the clock used by the context. */
-			[[nodiscard]] time_point now() const noexcept { return clock::now(); }
-
-			[[nodiscard]] friend constexpr bool operator==(const scheduler &, const scheduler &) noexcept = default;
-
-		private:
-			context *_ctx;
+			/* File IO is submitted directly to the io_uring queue as a scatter/gather read or write. */
+			template<decays_to_same<async_read_some_at_t> Op, decays_to_same<scheduler> T, decays_to_same<fs::file_handle> Hnd, std::convertible_to<io_request_t<fs::file_handle, read_some_at_t>> Req, std::convertible_to<fs::file_timeout> To>
+			friend auto tag_invoke(Op, T &&s, Hnd &&hnd, Req &&req, To &&to) noexcept { return io_sender_t<read_some_at_t>(s._ctx, hnd.native_handle().value, std::forward<Req>(req), std::forward<To>(to)); }
+			template<decays_to_same<async_write_some_at_t> Op, decays_to_same<scheduler> T, decays_to_same<fs::file_handle> Hnd, std::convertible_to<io_request_t<fs::file_handle, write_some_at_t>> Req, std::convertible_to<fs::file_timeout> To>
+			friend auto tag_invoke(Op, T &&s, Hnd &&hnd, Req &&req, To &&to) noexcept { return io_sender_t<write_some_at_t>(s._ctx, hnd.native_handle().value, std::forward<Req>(req), std::forward<To>(to)); }
 		};
 
 		constexpr scheduler context::get_scheduler() noexcept { return scheduler{this}; }
@@ -700,7 +1002,9 @@ namespace rod
 
 	/** Linux-specific execution context implemented via io_uring. */
 	using io_uring_context = _io_uring::context;
+	/** Flags used to configure `io_uring_context`. */
+	using io_uring_flags = _io_uring::context_flags;
 
-	static_assert(rod::scheduler<decltype(std::declval<context>().get_scheduler())>);
+	static_assert(rod::scheduler<decltype(std::declval<io_uring_context>().get_scheduler())>);
 }
 #endif
@@ -14,12 +14,16 @@
 #include "detail/queries/allocator.hpp"
 #include "detail/queries/may_block.hpp"
 #include "detail/queries/progress.hpp"
+#include "detail/queries/priority.hpp"
+#include "detail/queries/numa.hpp"
 
 #include "detail/adaptors/closure.hpp"
 #include "detail/adaptors/with_stop_token.hpp"
 #include "detail/adaptors/schedule_from.hpp"
 #include "detail/adaptors/stopped_as.hpp"
+#include "detail/adaptors/accumulate.hpp"
 #include "detail/adaptors/transfer.hpp"
+#include "detail/adaptors/when_all_range.hpp"
 #include "detail/adaptors/when_all.hpp"
 #include "detail/adaptors/split.hpp"
 #include "detail/adaptors/bulk.hpp"
@@ -223,7 +223,9 @@ namespace rod
 		{
 			if (!try_lock())
 			{
+				/* Mark the callback as complete, so that removing it from another thread does not wait for the stop request to invoke it. */
 				node->invoke();
+				node->complete.test_and_set(std::memory_order_release);
 				return;
 			}
 
@@ -296,8 +298,9 @@ namespace rod
 
 	/** Structure used to associate callback `CB` with an `in_place_stop_source`. */
 	template<typename CB>
-	class in_place_stop_callback : in_place_stop_source::node_t, empty_base<CB>
+	class in_place_stop_callback : empty_base<CB>, in_place_stop_source::node_t
 	{
+		/* Callback must be initialized before the node, since the node will invoke it immediately if a stop was already requested. */
 		using node_base = in_place_stop_source::node_t;
 
 	public:
@@ -309,7 +312,7 @@ namespace rod
 	public:
 		/** Adds a stop callback function \a fn to the stop source associated with stop token \a st. */
 		template<typename F> requires std::constructible_from<CB, F>
-		in_place_stop_callback(in_place_stop_token st, F &&fn) noexcept(std::is_nothrow_constructible_v<CB, F>) : node_base(st._src, invoke), empty_base<CB>(std::forward<F>(fn)) {}
+		in_place_stop_callback(in_place_stop_token st, F &&fn) noexcept(std::is_nothrow_constructible_v<CB, F>) : empty_base<CB>(std::forward<F>(fn)), node_base(st._src, invoke) {}
 	};
 
 	template<typename F>
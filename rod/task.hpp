@@ -8,6 +8,7 @@
 
 #ifdef ROD_HAS_COROUTINES
 
+#include "detail/frame_allocator.hpp"
 #include "scheduling.hpp"
 
 namespace rod
@@ -122,7 +123,7 @@ namespace rod
 			};
 
 		public:
-			using promise_type = promise<task, promise_base, T, std::allocator<void>>;
+			using promise_type = promise<task, promise_base, T, frame_allocator<void>>;
 			template<typename Alloc>
 			using allocator_promise_type = promise<task, promise_base, T, Alloc>;
 
@@ -282,7 +283,7 @@ namespace rod
 			};
 
 		public:
-			using promise_type = promise<shared_task, promise_base, T, std::allocator<void>>;
+			using promise_type = promise<shared_task, promise_base, T, frame_allocator<void>>;
 			template<typename Alloc>
 			using allocator_promise_type = promise<shared_task, promise_base, T, Alloc>;
 
@@ -368,7 +369,8 @@ namespace rod
 		Task<T> promise<Task, Base, T, Alloc>::get_return_object() noexcept { return Task<T>{std::coroutine_handle<promise>::from_promise(*this)}; }
 	}
 
-	/** Lazily-evaluated coroutine returning \a T as the promised result type. */
+	/** Lazily-evaluated coroutine returning \a T as the promised result type.
+	 * @note Coroutine frames are allocated using `frame_allocator`, unless an allocator is passed after `std::allocator_arg` as the first (or second for member functions) argument of the coroutine. */
 	template<typename T = void>
 	using task = _task::task<T>;
 	/** Task that can be atomically shared and awaited by multiple coroutines. */
@@ -12,7 +12,7 @@
 
 #include "../detail/io_handle_base.hpp"
 #include "../detail/priority_queue.hpp"
-#include "../detail/atomic_queue.hpp"
+#include "../detail/mpsc_queue.hpp"
 #include "../detail/basic_queue.hpp"
 #include "../detail/file_handle.hpp"
 #include "../detail/tid_lock.hpp"
@@ -96,8 +96,7 @@ namespace rod
 		{
 			constexpr timer_operation_base(fs::file_timeout to) noexcept : to(to) {}
 
-			timer_operation_base *timer_prev = {};
-			timer_operation_base *timer_next = {};
+			_detail::heap_hook<timer_operation_base> timer_hook;
 			std::atomic<int> flags;
 			fs::file_timeout to;
 		};
@@ -162,11 +161,11 @@ namespace rod
 			using clock = fs::file_clock;
 
 		private:
-			struct timer_cmp { constexpr bool operator()(const timer_operation_base &a, const timer_operation_base &b) const noexcept { return a.to.absolute({}) <= b.to.absolute({}); }};
-			using timer_queue_t = _detail::priority_queue<timer_operation_base, timer_cmp, &timer_operation_base::timer_prev, &timer_operation_base::timer_next>;
+			struct timer_cmp { constexpr bool operator()(const timer_operation_base &a, const timer_operation_base &b) const noexcept { return a.to.absolute({}) < b.to.absolute({}); }};
+			using timer_queue_t = _detail::priority_queue<timer_operation_base, timer_cmp, &timer_operation_base::timer_hook>;
 
 			using waitlist_queue_t = _detail::basic_queue<operation_base, &operation_base::next, &operation_base::prev>;
-			using producer_queue_t = _detail::atomic_queue<operation_base, &operation_base::next>;
+			using producer_queue_t = _detail::mpsc_queue<operation_base, &operation_base::next>;
 			using consumer_queue_t = _detail::basic_queue<operation_base, &operation_base::next>;
 
 			using io_event_pool_t = _detail::basic_queue<io_event, &io_event::next>;
@@ -0,0 +1,76 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#include <rod/async_mutex.hpp>
+#include <rod/scheduling.hpp>
+#include <cstdio>
+#include <map>
+
+#include "common.hpp"
+
+struct bench_result
+{
+	double throughput;
+	/* Largest share of critical sections executed by a single thread. */
+	double max_share;
+};
+
+/* Measures throughput of `n` contending lock operations started from pool workers, with the lock handed off either inline by `unlock` or through the pool. */
+template<bool Scheduled>
+static bench_result run_bench(rod::thread_pool &pool, std::size_t n, std::size_t work)
+{
+	auto sch = pool.get_scheduler();
+	rod::async_mutex mtx;
+
+	std::map<std::thread::id, std::size_t> owners;
+	std::size_t counter = 0;
+
+	const auto critical = [&]()
+	{
+		for (std::size_t i = 0; i < work; ++i)
+			counter = counter * 31 + i;
+		++owners[std::this_thread::get_id()];
+	};
+	const auto lock_one = [&]()
+	{
+		if constexpr (Scheduled)
+			return mtx.async_scoped_lock(sch) | rod::then([&](rod::async_lock_guard) { critical(); });
+		else
+			return mtx.async_scoped_lock() | rod::then([&](rod::async_lock_guard) { critical(); });
+	};
+
+	auto senders = std::vector<decltype(rod::schedule(sch) | rod::let_value(lock_one))>();
+	for (std::size_t i = 0; i < n; ++i) senders.push_back(rod::schedule(sch) | rod::let_value(lock_one));
+
+	const auto start = std::chrono::steady_clock::now();
+	rod::sync_wait(rod::when_all_range(senders));
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::size_t total = 0, max_owned = 0;
+	for (auto [id, owned] : owners) (total += owned, max_owned = std::max(max_owned, owned));
+	TEST_ASSERT(total == n);
+
+	return {static_cast<double>(n) / elapsed, static_cast<double>(max_owned) / static_cast<double>(n)};
+}
+
+int main()
+{
+	constexpr std::size_t n = 1 << 16;
+	const auto max_threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+	std::printf("%8s %8s %16s %12s %16s %12s\n", "threads", "work", "inline (l/s)", "inline max", "scheduled (l/s)", "sched max");
+	for (std::size_t threads = 1;; threads = std::min(threads * 2, max_threads))
+	{
+		rod::thread_pool pool(threads);
+		for (const std::size_t work : {0, 256})
+		{
+			const auto inline_res = run_bench<false>(pool, n, work);
+			const auto sched_res = run_bench<true>(pool, n, work);
+			std::printf("%8zu %8zu %16.0f %11.0f%% %16.0f %11.0f%%\n", threads, work, inline_res.throughput, inline_res.max_share * 100, sched_res.throughput, sched_res.max_share * 100);
+		}
+		pool.finish();
+
+		if (threads == max_threads) break;
+	}
+}
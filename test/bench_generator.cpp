@@ -0,0 +1,76 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#include <rod/generator.hpp>
+#include <rod/task.hpp>
+#include <cstdio>
+#include <vector>
+
+#include "common.hpp"
+
+/* Yields `n` values either one at a time, or in batches of `batch` values. */
+static rod::generator_task<std::size_t> produce(std::size_t n, std::size_t batch)
+{
+	if (batch == 0)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			co_yield i;
+		co_return;
+	}
+
+	auto buff = std::vector<std::size_t>(batch);
+	for (std::size_t i = 0; i < n;)
+	{
+		const auto size = std::min(batch, n - i);
+		for (std::size_t j = 0; j < size; ++j)
+			buff[j] = i++;
+		co_yield std::span(buff.data(), size);
+	}
+}
+
+/* Consumes the generator value-by-value through its iterator. */
+static rod::task<std::size_t> consume_iter(rod::generator_task<std::size_t> &g)
+{
+	std::size_t sum = 0;
+	for (auto curr = co_await g.begin(); curr != g.end(); co_await ++curr)
+		sum += *curr;
+	co_return sum;
+}
+/* Consumes the generator batch-by-batch through the `next_batch` awaiter, awaited via `sync_wait`. */
+static std::size_t consume_batch(rod::generator_task<std::size_t> &g)
+{
+	std::size_t sum = 0;
+	for (;;)
+	{
+		const auto [batch] = *rod::sync_wait(g.next_batch());
+		if (batch.empty()) break;
+		for (auto value : batch) sum += value;
+	}
+	return sum;
+}
+
+/* Returns average time per element in nanoseconds. */
+template<typename F>
+static double run_bench(std::size_t n, F &&consume)
+{
+	const auto start = std::chrono::steady_clock::now();
+	const auto sum = consume();
+	const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+	TEST_ASSERT(sum == n * (n - 1) / 2);
+	return elapsed / static_cast<double>(n);
+}
+
+int main()
+{
+	constexpr std::size_t n = 1 << 22;
+
+	std::printf("%8s %16s %22s\n", "batch", "iter (ns/elem)", "next_batch (ns/elem)");
+	for (const std::size_t batch : {0, 1, 16, 256, 4096})
+	{
+		const auto iter_res = run_bench(n, [&]() { auto g = produce(n, batch); return std::get<0>(*rod::sync_wait(consume_iter(g))); });
+		const auto batch_res = run_bench(n, [&]() { auto g = produce(n, batch); return consume_batch(g); });
+		std::printf("%8zu %16.2f %22.2f\n", batch, iter_res, batch_res);
+	}
+}
@@ -0,0 +1,92 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#include <rod/scheduling.hpp>
+#include <cstdio>
+#include <memory>
+
+#include "common.hpp"
+
+struct counting_receiver
+{
+	using is_receiver = std::true_type;
+
+	friend rod::empty_env tag_invoke(rod::get_env_t, const counting_receiver &) noexcept { return {}; }
+	friend void tag_invoke(rod::set_value_t, counting_receiver &&r) noexcept
+	{
+		/* The operation may be destroyed as soon as the counter is incremented, so the receiver is moved out of it first. */
+		const auto counter = std::move(r.counter);
+		const auto total = r.total;
+		if (counter->fetch_add(1, std::memory_order_acq_rel) + 1 == total)
+			counter->notify_all();
+	}
+	friend void tag_invoke(rod::set_stopped_t, counting_receiver &&) noexcept { std::terminate(); }
+
+	std::shared_ptr<std::atomic<std::size_t>> counter;
+	std::size_t total;
+};
+
+using schedule_sender_t = rod::schedule_result_t<decltype(std::declval<rod::thread_pool &>().get_scheduler())>;
+using operation_t = rod::connect_result_t<schedule_sender_t, counting_receiver>;
+
+struct operation_storage
+{
+	operation_storage(schedule_sender_t snd, counting_receiver rcv) : op(rod::connect(std::move(snd), std::move(rcv))) {}
+
+	operation_t op;
+};
+
+/* Measures throughput of `schedule` for operations started either from an external thread or from a pool worker (fan-out). */
+static double run_bench(rod::thread_pool &pool, std::size_t n, bool from_worker)
+{
+	/* Counter is shared with the receivers, so that it outlives the final notification. */
+	const auto counter_ptr = std::make_shared<std::atomic<std::size_t>>(0);
+	auto &counter = *counter_ptr;
+
+	auto ops = std::vector<std::unique_ptr<operation_storage>>(n);
+	for (auto &op: ops) op = std::make_unique<operation_storage>(rod::schedule(pool.get_scheduler()), counting_receiver{counter_ptr, n});
+
+	const auto start_all = [&]() { for (auto &op: ops) rod::start(op->op); };
+	const auto start = std::chrono::steady_clock::now();
+
+	if (from_worker)
+		rod::sync_wait(rod::schedule(pool.get_scheduler()) | rod::then(start_all));
+	else
+		start_all();
+	for (auto i = counter.load(); i != n; i = counter.load()) counter.wait(i);
+
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	TEST_ASSERT(counter.load() == n);
+	return static_cast<double>(n) / elapsed;
+}
+
+/* Measures average round-trip latency of `sync_wait(schedule(pool))`, which includes waking up a worker and then the waiting thread. */
+static double run_round_trip(rod::thread_pool &pool, std::size_t n)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < n; ++i)
+		rod::sync_wait(rod::schedule(pool.get_scheduler()));
+
+	const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	return elapsed / static_cast<double>(n);
+}
+
+int main()
+{
+	constexpr std::size_t n = 1 << 18;
+	const auto max_threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+	std::printf("%8s %16s %16s %20s\n", "threads", "external (t/s)", "fan-out (t/s)", "sync_wait (ns/op)");
+	for (std::size_t threads = 1;; threads = std::min(threads * 2, max_threads))
+	{
+		rod::thread_pool pool(threads);
+		const auto external = run_bench(pool, n, false);
+		const auto fan_out = run_bench(pool, n, true);
+		const auto round_trip = run_round_trip(pool, n / 16);
+		std::printf("%8zu %16.0f %16.0f %20.0f\n", threads, external, fan_out, round_trip);
+		pool.finish();
+
+		if (threads == max_threads) break;
+	}
+}
\ No newline at end of file
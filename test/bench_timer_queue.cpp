@@ -0,0 +1,123 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#include <rod/detail/priority_queue.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "common.hpp"
+
+struct timer_node
+{
+	std::uint64_t timeout = 0;
+	rod::_detail::heap_hook<timer_node> timer_hook;
+	timer_node *timer_prev = {};
+	timer_node *timer_next = {};
+};
+struct timer_cmp { constexpr bool operator()(const timer_node &a, const timer_node &b) const noexcept { return a.timeout < b.timeout; }};
+
+/* Sorted list previously used to order timers, kept as a baseline. */
+struct sorted_list
+{
+	[[nodiscard]] bool empty() const noexcept { return !head; }
+	[[nodiscard]] timer_node *front() const noexcept { return head; }
+	[[nodiscard]] timer_node *pop_front() noexcept
+	{
+		const auto node = std::exchange(head, head->timer_next);
+		if (head) head->timer_prev = {};
+		node->timer_next = {};
+		return node;
+	}
+
+	timer_node *insert(timer_node *node) noexcept
+	{
+		if (!head || node->timeout <= head->timeout)
+		{
+			if ((node->timer_next = head)) head->timer_prev = node;
+			return head = node;
+		}
+
+		auto prev = head;
+		while (prev->timer_next && prev->timer_next->timeout < node->timeout)
+			prev = prev->timer_next;
+
+		if ((node->timer_next = prev->timer_next)) node->timer_next->timer_prev = node;
+		node->timer_prev = prev;
+		prev->timer_next = node;
+		return head;
+	}
+	void erase(timer_node *node) noexcept
+	{
+		const auto next = std::exchange(node->timer_next, {});
+		const auto prev = std::exchange(node->timer_prev, {});
+		if (next) next->timer_prev = prev;
+		if (prev) prev->timer_next = next;
+		else head = next;
+	}
+
+	timer_node *head = {};
+};
+using timer_heap = rod::_detail::priority_queue<timer_node, timer_cmp, &timer_node::timer_hook>;
+
+/* Measures the average time of one reactor iteration with `n` pending timers: a timer is cancelled and re-armed
+ * (i.e. a request timeout is refreshed), and the earliest timer expires and is re-armed (i.e. a periodic timer). */
+template<typename Queue>
+static double run_bench(std::size_t n, std::size_t iterations)
+{
+	auto rng = std::mt19937_64{n};
+	auto deadline = std::uniform_int_distribution<std::uint64_t>{0, n * 16};
+	auto nodes = std::vector<timer_node>(n);
+	auto queue = Queue{};
+
+	for (auto &node: nodes) node.timeout = deadline(rng);
+	/* Insert in descending order, so that the sorted list can be filled in linear time. */
+	auto sorted = std::vector<timer_node *>(n);
+	std::ranges::transform(nodes, sorted.begin(), [](auto &node) { return &node; });
+	std::ranges::sort(sorted, std::greater<>{}, &timer_node::timeout);
+	for (auto node: sorted) queue.insert(node);
+
+	std::uint64_t now = 0;
+	auto index = std::uniform_int_distribution<std::size_t>{0, n - 1};
+	const auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < iterations; ++i)
+	{
+		auto &refreshed = nodes[index(rng)];
+		queue.erase(&refreshed);
+		refreshed.timeout = now + deadline(rng);
+		queue.insert(&refreshed);
+
+		const auto expired = queue.pop_front();
+		now = expired->timeout;
+		expired->timeout = now + deadline(rng);
+		queue.insert(expired);
+	}
+
+	const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	for (std::uint64_t prev = 0; !queue.empty();)
+	{
+		const auto node = queue.pop_front();
+		TEST_ASSERT(node->timeout >= prev);
+		prev = node->timeout;
+	}
+	return elapsed / static_cast<double>(iterations);
+}
+
+int main()
+{
+	constexpr std::size_t iterations = 1 << 14;
+	/* Sorted list is quadratic, do not wait for it with a large amount of pending timers. */
+	constexpr std::size_t max_list_size = 10000;
+
+	std::printf("%10s %16s %16s\n", "pending", "heap (ns/it)", "list (ns/it)");
+	for (std::size_t n = 100; n <= 1000000; n *= 10)
+	{
+		const auto heap = run_bench<timer_heap>(n, iterations);
+		if (n <= max_list_size)
+			std::printf("%10zu %16.1f %16.1f\n", n, heap, run_bench<sorted_list>(n, iterations));
+		else
+			std::printf("%10zu %16.1f %16s\n", n, heap, "-");
+	}
+}
\ No newline at end of file
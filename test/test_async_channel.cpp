@@ -0,0 +1,74 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#include <rod/async_channel.hpp>
+#include <rod/scheduling.hpp>
+#include <rod/task.hpp>
+
+#include "common.hpp"
+
+int main()
+{
+	rod::thread_pool pool(4);
+	auto sch = pool.get_scheduler();
+
+	/* Values sent by multiple producers through a bounded channel are received by the consumers exactly once. */
+	{
+		constexpr std::size_t producers = 4, consumers = 4, n = 10000;
+
+		rod::async_channel<std::size_t> chan(16);
+		std::atomic<std::size_t> remaining = producers;
+
+		const auto produce = [&](std::size_t id) -> rod::task<>
+		{
+			for (std::size_t i = 0; i < n; ++i)
+				TEST_ASSERT(co_await chan.send(id * n + i));
+			if (remaining.fetch_sub(1) == 1)
+				chan.close();
+		};
+		const auto consume = [&]() -> rod::task<std::size_t>
+		{
+			std::size_t sum = 0;
+			while (auto value = co_await chan.receive())
+				sum += *value;
+			co_return sum;
+		};
+
+		auto results = std::vector<decltype(rod::ensure_started(rod::on(sch, consume())))>();
+		for (std::size_t i = 0; i < consumers; ++i)
+			results.push_back(rod::ensure_started(rod::on(sch, consume())));
+		auto tasks = std::vector<decltype(rod::ensure_started(rod::on(sch, produce(0))))>();
+		for (std::size_t i = 0; i < producers; ++i)
+			tasks.push_back(rod::ensure_started(rod::on(sch, produce(i))));
+
+		std::size_t sum = 0;
+		for (auto &task : tasks)
+			rod::sync_wait(std::move(task));
+		for (auto &result : results)
+			sum += std::get<0>(*rod::sync_wait(std::move(result)));
+		TEST_ASSERT(sum == (producers * n) * (producers * n - 1) / 2);
+	}
+	/* Closed channel rejects new values, and completes receivers once drained. */
+	{
+		rod::async_channel<int> chan(2);
+		TEST_ASSERT(chan.try_send(1) && chan.try_send(2) && !chan.try_send(3));
+
+		auto blocked = rod::ensure_started(chan.send(3));
+		chan.close();
+		TEST_ASSERT(rod::sync_wait(std::move(blocked)).value() == std::tuple{false});
+		TEST_ASSERT(rod::sync_wait(chan.send(4)).value() == std::tuple{false});
+
+		TEST_ASSERT(rod::sync_wait(chan.receive()).value() == std::tuple{std::optional{1}});
+		TEST_ASSERT(chan.try_receive() == 2);
+		TEST_ASSERT(rod::sync_wait(chan.receive()).value() == std::tuple{std::optional<int>{}});
+	}
+	/* Cancelled receivers complete via the stop channel without consuming values. */
+	{
+		rod::async_channel<int> chan(1);
+		TEST_ASSERT(!rod::sync_wait(rod::when_all(chan.receive(), rod::just_stopped())));
+		TEST_ASSERT(chan.try_send(1) && chan.try_receive() == 1);
+	}
+
+	pool.finish();
+}
@@ -0,0 +1,97 @@
+/*
+ * Created by switchblade on 2026-10-18.
+ */
+
+#include <rod/async_shared_mutex.hpp>
+#include <rod/async_semaphore.hpp>
+#include <rod/async_barrier.hpp>
+#include <rod/async_latch.hpp>
+#include <rod/scheduling.hpp>
+
+#include "common.hpp"
+
+int main()
+{
+	rod::thread_pool pool(4);
+	auto sch = pool.get_scheduler();
+
+	/* Semaphore bounds the number of concurrent operations by the number of permits. */
+	{
+		constexpr std::size_t n = 1000;
+
+		rod::async_semaphore sem(2);
+		std::atomic<int> inside = 0;
+		std::atomic<bool> exceeded = false;
+
+		const auto acquire = [&]() { return sem.async_acquire(); };
+		const auto critical = [&]()
+		{
+			if (inside.fetch_add(1) >= 2) exceeded = true;
+			inside.fetch_sub(1);
+			sem.release();
+		};
+
+		auto senders = std::vector<decltype(rod::schedule(sch) | rod::let_value(acquire) | rod::then(critical))>();
+		for (std::size_t i = 0; i < n; ++i) senders.push_back(rod::schedule(sch) | rod::let_value(acquire) | rod::then(critical));
+
+		rod::sync_wait(rod::when_all_range(senders));
+		TEST_ASSERT(!exceeded.load());
+		TEST_ASSERT(sem.try_acquire() && sem.try_acquire() && !sem.try_acquire());
+
+		/* Cancelled waiters complete via the stop channel without consuming permits. */
+		TEST_ASSERT(!rod::sync_wait(rod::when_all(sem.async_acquire(), rod::just_stopped())));
+		sem.release();
+		TEST_ASSERT(sem.try_acquire());
+	}
+	/* Queued exclusive waiter of a shared mutex blocks shared waiters queued after it. */
+	{
+		rod::async_shared_mutex mtx;
+		rod::sync_wait(mtx.async_lock_shared());
+		TEST_ASSERT(mtx.try_lock_shared());
+		TEST_ASSERT(!mtx.try_lock());
+
+		auto writer = rod::ensure_started(mtx.async_lock());
+		auto reader = rod::ensure_started(mtx.async_lock_shared());
+		TEST_ASSERT(!mtx.try_lock_shared());
+
+		mtx.unlock_shared();
+		mtx.unlock_shared();
+		rod::sync_wait(std::move(writer));
+
+		mtx.unlock();
+		rod::sync_wait(std::move(reader));
+		mtx.unlock_shared();
+		TEST_ASSERT(mtx.try_lock());
+		mtx.unlock();
+	}
+	/* Latch resumes waiters once counted down to zero. */
+	{
+		rod::async_latch latch(3);
+		auto waiter = rod::ensure_started(latch.async_wait());
+
+		rod::sync_wait(rod::schedule(sch) | rod::bulk(3, [&](auto) { latch.count_down(); }));
+		rod::sync_wait(std::move(waiter));
+		TEST_ASSERT(latch.try_wait());
+	}
+	/* Barrier phases complete once all participants have arrived. */
+	{
+		constexpr std::size_t n = 8;
+
+		rod::async_barrier barrier(n);
+		std::atomic<std::size_t> arrived = 0;
+		std::atomic<bool> early = false;
+		std::size_t target = n;
+
+		const auto arrive = [&]() { return (arrived.fetch_add(1), barrier.async_arrive_and_wait()); };
+		const auto check = [&]() { if (arrived.load() < target) early = true; };
+		auto senders = std::vector<decltype(rod::schedule(sch) | rod::let_value(arrive) | rod::then(check))>();
+		for (std::size_t i = 0; i < n; ++i) senders.push_back(rod::schedule(sch) | rod::let_value(arrive) | rod::then(check));
+
+		rod::sync_wait(rod::when_all_range(senders));
+		target += n;
+		rod::sync_wait(rod::when_all_range(senders));
+		TEST_ASSERT(!early.load());
+	}
+
+	pool.finish();
+}
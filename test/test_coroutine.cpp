@@ -3,6 +3,9 @@
  */
 
 #include <memory_resource>
+#include <atomic>
+#include <thread>
+#include <vector>
 #include <array>
 
 #include <rod/generator.hpp>
@@ -33,6 +36,24 @@ struct test_coroutine
 
 	std::coroutine_handle<promise_type> _handle;
 };
+
+/* Sender that completes from a new thread, which is joined before `start` returns. */
+struct joined_thread_sender
+{
+	using is_sender = std::true_type;
+	using completion_signatures = rod::completion_signatures<rod::set_value_t()>;
+
+	template<typename Rcv>
+	struct operation
+	{
+		friend void tag_invoke(rod::start_t, operation &op) noexcept { std::thread([&]() { rod::set_value(std::move(op.rcv)); }).join(); }
+
+		Rcv rcv;
+	};
+
+	template<typename Rcv>
+	friend operation<Rcv> tag_invoke(rod::connect_t, joined_thread_sender, Rcv rcv) { return {std::move(rcv)}; }
+};
 #endif
 
 int main()
@@ -84,6 +105,54 @@ int main()
 			TEST_ASSERT(*curr == i);
 	}();
 
+	/* Senders that complete synchronously resume the awaiting coroutine without growing the stack. */
+	const auto sum = []() -> rod::task<int>
+	{
+		int sum = 0;
+		for (int i = 0; i < 1'000'000; ++i)
+			sum += co_await rod::just(1);
+		co_return sum;
+	};
+	TEST_ASSERT(std::get<0>(*rod::sync_wait(sum())) == 1'000'000);
+
+	/* Senders that complete on another thread before `start` returns resume the awaiting coroutine on the completing thread. */
+	const auto resumed_on = []() -> rod::task<std::thread::id>
+	{
+		co_await joined_thread_sender{};
+		co_return std::this_thread::get_id();
+	};
+	TEST_ASSERT(std::get<0>(*rod::sync_wait(resumed_on())) != std::this_thread::get_id());
+
+	/* Batches are iterated value-by-value, and are returned whole by `next_batch`. */
+	const auto batches = [](int n) -> rod::generator_task<int>
+	{
+		auto buff = std::array<int, 4>{};
+		for (int i = 0; i < n;)
+		{
+			const auto size = std::min<std::size_t>(buff.size(), static_cast<std::size_t>(n - i));
+			for (std::size_t j = 0; j < size; ++j)
+				buff[j] = i++;
+			co_yield std::span(buff.data(), size);
+			co_yield std::span<int>();
+		}
+		co_yield n;
+	};
+	[&]() -> test_coroutine
+	{
+		int i = 0;
+		auto g = batches(10);
+		for (auto curr = co_await g.begin(); curr != g.end(); co_await ++curr, ++i)
+			TEST_ASSERT(*curr == i);
+		TEST_ASSERT(i == 11);
+	}();
+	{
+		auto g = batches(10);
+		auto sizes = std::vector<std::size_t>();
+		for (auto batch = std::get<0>(*rod::sync_wait(g.next_batch())); !batch.empty(); batch = std::get<0>(*rod::sync_wait(g.next_batch())))
+			sizes.push_back(batch.size());
+		TEST_ASSERT((sizes == std::vector<std::size_t>{4, 4, 2, 1}));
+	}
+
 	auto test_snd = [](int v) -> rod::sender_of<rod::set_value_t(std::variant<int, std::exception_ptr>)> auto
 	{
 		return [](int v) -> rod::task<int> { if (v >= 0) co_return v; else ROD_THROW(-v); }(v)
@@ -93,5 +162,45 @@ int main()
 
 	rod::sync_wait(test_snd(-1) | rod::then([](auto &&v){ TEST_ASSERT(v.index() == 1); }));
 	rod::sync_wait(test_snd(1) | rod::then([](auto &&v){ TEST_ASSERT(v.index() == 0); }));
+
+	{
+		auto alloc = rod::frame_allocator<std::byte>();
+		auto *a = alloc.allocate(100);
+		alloc.deallocate(a, 100);
+		auto *b = alloc.allocate(100);
+		TEST_ASSERT(a == b);
+
+		/* Frames freed on another thread are returned to the owner pool, and frames outliving their owner thread are freed directly. */
+		std::byte *c = nullptr;
+		std::thread([&]() { alloc.deallocate(b, 100); c = alloc.allocate(200); }).join();
+		alloc.deallocate(c, 200);
+
+		auto *d = alloc.allocate(100);
+		TEST_ASSERT(d == b);
+		alloc.deallocate(d, 100);
+	}
+	{
+		/* Remote frees racing the exit of the owner thread release its pool exactly once. */
+		auto alloc = rod::frame_allocator<std::byte>();
+		for (int i = 0; i < 1000; ++i)
+		{
+			auto block = std::atomic<std::byte *>();
+			auto owner = std::thread([&]() { block.store(alloc.allocate(100), std::memory_order_release); });
+			auto remote = std::thread([&]()
+			{
+				auto ptr = block.load(std::memory_order_acquire);
+				for (; ptr == nullptr; ptr = block.load(std::memory_order_acquire))
+					std::this_thread::yield();
+				alloc.deallocate(ptr, 100);
+			});
+			owner.join();
+			remote.join();
+		}
+	}
+	{
+		auto t = std::thread([]() { for (int i = 0; i < 100; ++i) TEST_ASSERT(rod::sync_wait(async_return(i))); });
+		for (int i = 0; i < 100; ++i) TEST_ASSERT(rod::sync_wait(async_return(i)));
+		t.join();
+	}
 #endif
 }
@@ -37,5 +37,22 @@ inline void test_io_context(auto &&ctx)
 		rod::sync_wait([&]() -> rod::task<> { co_await rod::schedule_after(sch, 50ms); }());
 	}
 #endif
+	{
+		auto curr_dir = rod::fs::path_handle::open({}, rod::fs::current_path().value()).value();
+		auto file = rod::fs::file_handle::open(curr_dir, "io-context.txt", rod::fs::file_flags::readwrite | rod::fs::file_flags::unlink_on_close, rod::fs::open_mode::always).value();
+
+		auto str_src = std::string_view("hello, world.");
+		auto str_dst = std::string(str_src.size(), 0);
+		auto buff_src = rod::as_bytes(str_src);
+		auto buff_dst = rod::as_bytes(str_dst);
+
+		auto write_res = rod::sync_wait(rod::async_write_some_at(sch, file, {.buffs = {&buff_src, 1}, .off = 0}));
+		TEST_ASSERT(write_res.has_value() && std::get<0>(*write_res).has_value());
+		TEST_ASSERT(std::get<0>(*write_res)->front().size() == buff_src.size());
+
+		auto read_res = rod::sync_wait(rod::async_read_some_at(sch, file, {.buffs = {&buff_dst, 1}, .off = 0}, std::chrono::seconds(1)));
+		TEST_ASSERT(read_res.has_value() && std::get<0>(*read_res).has_value());
+		TEST_ASSERT(str_dst == str_src);
+	}
 	ctx.finish();
 }
@@ -4,4 +4,161 @@
 
 #include "test_io_context.hpp"
 
-int main() { test_io_context(rod::io_uring_context{}); }
+static void test_fixed_io()
+{
+	auto ctx = rod::io_uring_context{};
+	auto trd = std::jthread{[&]() { ctx.run(); }};
+	auto sch = ctx.get_scheduler();
+
+	auto curr_dir = rod::fs::path_handle::open({}, rod::fs::current_path().value()).value();
+	auto file = rod::fs::file_handle::open(curr_dir, "io-uring-fixed.txt", rod::fs::file_flags::readwrite | rod::fs::file_flags::unlink_on_close, rod::fs::open_mode::always).value();
+
+	auto str_src = std::string("hello, world.");
+	auto str_dst = std::string(str_src.size(), 0);
+	auto buff_src = rod::as_bytes(str_src);
+	auto buff_dst = rod::as_bytes(str_dst);
+
+	const rod::byte_buffer fixed_buffs[] = {buff_src, buff_dst};
+	TEST_ASSERT(ctx.register_buffers(fixed_buffs).has_value());
+	const rod::io_uring_context::native_handle_type fixed_files[] = {file.native_handle()};
+	TEST_ASSERT(ctx.register_files(fixed_files).has_value());
+
+	auto write_buff = rod::const_byte_buffer(buff_src);
+	auto write_res = rod::sync_wait(rod::async_write_some_at(sch, file, {.buffs = {&write_buff, 1}, .off = 0}));
+	TEST_ASSERT(write_res.has_value() && std::get<0>(*write_res).has_value());
+	TEST_ASSERT(std::get<0>(*write_res)->front().size() == str_src.size());
+
+	auto read_res = rod::sync_wait(rod::async_read_some_at(sch, file, {.buffs = {&buff_dst, 1}, .off = 0}));
+	TEST_ASSERT(read_res.has_value() && std::get<0>(*read_res).has_value());
+	TEST_ASSERT(str_dst == str_src);
+
+	TEST_ASSERT(ctx.unregister_files().has_value());
+	TEST_ASSERT(ctx.unregister_buffers().has_value());
+	ctx.finish();
+}
+
+static void test_linked_io()
+{
+	auto ctx = rod::io_uring_context{};
+	auto trd = std::jthread{[&]() { ctx.run(); }};
+	auto sch = ctx.get_scheduler();
+
+	auto curr_dir = rod::fs::path_handle::open({}, rod::fs::current_path().value()).value();
+	auto src = rod::fs::file_handle::open(curr_dir, "io-uring-src.txt", rod::fs::file_flags::readwrite | rod::fs::file_flags::unlink_on_close, rod::fs::open_mode::always).value();
+	auto dst = rod::fs::file_handle::open(curr_dir, "io-uring-dst.txt", rod::fs::file_flags::readwrite | rod::fs::file_flags::unlink_on_close, rod::fs::open_mode::always).value();
+
+	auto str_src = std::string("hello, world.");
+	auto str_tmp = std::string(str_src.size(), 0);
+	auto str_dst = std::string(str_src.size(), 0);
+	auto buff_src = rod::const_byte_buffer(rod::as_bytes(str_src));
+	auto buff_tmp = rod::as_bytes(str_tmp);
+	auto buff_dst = rod::as_bytes(str_dst);
+	TEST_ASSERT(rod::sync_wait(rod::async_write_some_at(sch, src, {.buffs = {&buff_src, 1}, .off = 0})).has_value());
+
+	/* Copy the source file to the destination file without a round trip between the read and the write. */
+	auto copy_buff = rod::const_byte_buffer(buff_tmp);
+	auto copy_res = rod::sync_wait(linked(rod::async_read_some_at(sch, src, {.buffs = {&buff_tmp, 1}, .off = 0}), rod::async_write_some_at(sch, dst, {.buffs = {&copy_buff, 1}, .off = 0})));
+	TEST_ASSERT(copy_res.has_value() && std::get<0>(*copy_res).has_value() && std::get<1>(*copy_res).has_value());
+	TEST_ASSERT(std::get<1>(*copy_res)->front().size() == str_src.size());
+
+	TEST_ASSERT(rod::sync_wait(rod::async_read_some_at(sch, dst, {.buffs = {&buff_dst, 1}, .off = 0})).has_value());
+	TEST_ASSERT(str_dst == str_src);
+
+	/* Short read past the end of file breaks the chain unless it is hard-linked. */
+	auto eof_res = rod::sync_wait(linked(rod::async_read_some_at(sch, src, {.buffs = {&buff_tmp, 1}, .off = 1024}), rod::async_write_some_at(sch, dst, {.buffs = {&copy_buff, 1}, .off = 0})));
+	TEST_ASSERT(eof_res.has_value() && std::get<0>(*eof_res).has_value() && std::get<0>(*eof_res)->empty());
+	TEST_ASSERT(std::get<1>(*eof_res).has_error() && std::get<1>(*eof_res).error() == std::make_error_code(std::errc::operation_canceled));
+
+	auto hard_res = rod::sync_wait(hard_linked(rod::async_read_some_at(sch, src, {.buffs = {&buff_tmp, 1}, .off = 1024}), rod::async_write_some_at(sch, dst, {.buffs = {&copy_buff, 1}, .off = 0})));
+	TEST_ASSERT(hard_res.has_value() && std::get<0>(*hard_res).has_value() && std::get<1>(*hard_res).has_value());
+
+	ctx.finish();
+}
+
+static void test_message_ring()
+{
+	auto ctx_a = rod::io_uring_context{};
+	auto ctx_b = rod::io_uring_context{};
+	auto trd_a = std::jthread{[&]() { ctx_a.run(); }};
+	auto trd_b = std::jthread{[&]() { ctx_b.run(); }};
+
+	/* Consumer thread of one context notifies the other one via a message to its ring. */
+	rod::sync_wait([&]() -> rod::task<>
+	{
+		for (int i = 0; i < 1000; ++i)
+		{
+			co_await rod::schedule(ctx_a.get_scheduler());
+			TEST_ASSERT(std::this_thread::get_id() == trd_a.get_id());
+			co_await rod::schedule(ctx_b.get_scheduler());
+			TEST_ASSERT(std::this_thread::get_id() == trd_b.get_id());
+		}
+	}());
+
+	ctx_a.finish();
+	ctx_b.finish();
+
+	/* Message to a sleeping ring is delivered even if the consumer thread of the sender blocks without entering its own ring again. */
+	{
+		auto ctx_c = rod::io_uring_context{};
+		auto ctx_d = rod::io_uring_context{};
+		auto trd_c = std::jthread{[&]() { ctx_c.run(); }};
+		auto trd_d = std::jthread{[&]() { ctx_d.run(); }};
+
+		/* Let the consumer of the destination ring go to sleep. */
+		rod::sync_wait(rod::schedule(ctx_d.get_scheduler()));
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+		std::atomic<bool> flag = false;
+		rod::sync_wait(rod::schedule(ctx_c.get_scheduler()) | rod::then([&]()
+		{
+			rod::start_detached(rod::schedule(ctx_d.get_scheduler()) | rod::then([&]() { flag = true; }));
+			for (const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2); !flag && std::chrono::steady_clock::now() < deadline;)
+				std::this_thread::yield();
+		}));
+		TEST_ASSERT(flag.load());
+
+		ctx_c.finish();
+		ctx_d.finish();
+	}
+
+	/* Messages from multiple rings to the same ring do not overflow its completion queue. */
+	{
+		auto ctx_dst = rod::io_uring_context{8};
+		auto trd_dst = std::jthread{[&]() { ctx_dst.run(); }};
+
+		std::array<rod::io_uring_context, 4> ctx_src;
+		std::vector<std::jthread> trd_src;
+		for (auto &ctx : ctx_src) trd_src.emplace_back([&]() { ctx.run(); });
+
+		std::atomic<int> hops = 0;
+		std::vector<std::jthread> trd_hop;
+		for (auto &ctx : ctx_src)
+			trd_hop.emplace_back([&]()
+			{
+				rod::sync_wait([&]() -> rod::task<>
+				{
+					for (int i = 0; i < 1000; ++i)
+					{
+						co_await rod::schedule(ctx.get_scheduler());
+						co_await rod::schedule(ctx_dst.get_scheduler());
+						TEST_ASSERT(std::this_thread::get_id() == trd_dst.get_id());
+						++hops;
+					}
+				}());
+			});
+		trd_hop.clear();
+		TEST_ASSERT(hops.load() == 4000);
+
+		for (auto &ctx : ctx_src) ctx.finish();
+		ctx_dst.finish();
+	}
+}
+
+int main()
+{
+	test_io_context(rod::io_uring_context{});
+	test_io_context(rod::io_uring_context{64, rod::io_uring_flags::busy_poll, 8});
+	test_fixed_io();
+	test_linked_io();
+	test_message_ring();
+}
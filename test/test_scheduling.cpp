@@ -3,12 +3,52 @@
  */
 
 #include <thread>
+#include <vector>
 
 #include <rod/task.hpp>
 #include <rod/io.hpp>
 
 #include "common.hpp"
 
+template<typename T>
+struct counting_allocator
+{
+	using value_type = T;
+
+	constexpr counting_allocator(int *live) noexcept : live(live) {}
+	template<typename U>
+	constexpr counting_allocator(const counting_allocator<U> &other) noexcept : live(other.live) {}
+
+	T *allocate(std::size_t n) { return (++*live, std::allocator<T>{}.allocate(n)); }
+	void deallocate(T *ptr, std::size_t n) { (--*live, std::allocator<T>{}.deallocate(ptr, n)); }
+
+	constexpr bool operator==(const counting_allocator &) const noexcept = default;
+
+	int *live;
+};
+/* Sender adaptor that provides a counting allocator via its environment. */
+template<typename Snd>
+struct alloc_sender
+{
+	using is_sender = std::true_type;
+
+	struct env
+	{
+		friend counting_allocator<std::byte> tag_invoke(rod::get_allocator_t, const env &e) noexcept { return {e.live}; }
+
+		int *live;
+	};
+
+	friend env tag_invoke(rod::get_env_t, const alloc_sender &s) noexcept { return {s.live}; }
+	template<rod::decays_to_same<alloc_sender> T, typename E>
+	friend rod::completion_signatures_of_t<rod::copy_cvref_t<T, Snd>, E> tag_invoke(rod::get_completion_signatures_t, T &&, E) noexcept { return {}; }
+	template<rod::decays_to_same<alloc_sender> T, typename Rcv>
+	friend auto tag_invoke(rod::connect_t, T &&s, Rcv rcv) { return rod::connect(std::forward<T>(s).snd, std::move(rcv)); }
+
+	Snd snd;
+	int *live;
+};
+
 int main()
 {
 	{
@@ -43,11 +83,55 @@ int main()
 		rod::sync_wait(final_snd);
 #endif
 	}
+	{
+		int live = 0, value = 0;
+		{
+			const auto snd = rod::split(alloc_sender<decltype(rod::just(1))>{rod::just(1), &live});
+			TEST_ASSERT(live == 1);
+
+			rod::sync_wait(snd | rod::then([&](int i) { value += i; }));
+			rod::sync_wait(snd | rod::then([&](int i) { value += i; }));
+		}
+		TEST_ASSERT(live == 0 && value == 2);
+
+		{
+			auto snd = rod::ensure_started(alloc_sender<decltype(rod::just(1))>{rod::just(1), &live});
+			TEST_ASSERT(live == 1);
+			TEST_ASSERT(std::get<0>(*rod::sync_wait(std::move(snd))) == 1);
+		}
+		TEST_ASSERT(live == 0);
+
+		/* Detached state is released by the inline completion. */
+		auto snd = rod::just() | rod::then([&]() { TEST_ASSERT(live == 1); });
+		rod::start_detached(alloc_sender<decltype(snd)>{std::move(snd), &live});
+		TEST_ASSERT(live == 0);
+	}
 	{
 		const auto snd = rod::just(std::make_shared<int>(1)) | rod::then([](const auto &p) { TEST_ASSERT(p && *p == 1); });
 		rod::sync_wait(snd);
 		rod::sync_wait(snd);
 	}
+	{
+		/* ensure_started senders are move-only, so relocating them does not detach the pending operations. */
+		rod::run_loop loop;
+		const auto make_snd = [&](int i) { return rod::ensure_started(rod::schedule(loop.get_scheduler()) | rod::then([i]() { return i; })); };
+		static_assert(!std::is_copy_constructible_v<decltype(make_snd(0))>);
+
+		auto snds = std::vector<decltype(make_snd(0))>();
+		for (int i = 0; i < 16; ++i) snds.push_back(make_snd(i));
+
+		loop.finish();
+		loop.run();
+		for (int i = 0; i < 16; ++i) TEST_ASSERT(std::get<0>(*rod::sync_wait(std::move(snds[i]))) == i);
+	}
+	{
+		/* Polling a finished run loop does not block. */
+		rod::run_loop loop;
+		loop.finish();
+		loop.run();
+		TEST_ASSERT(loop.poll(true) == 0);
+		loop.run();
+	}
 	{
 		using namespace std::chrono_literals;
 
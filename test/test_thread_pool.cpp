@@ -2,11 +2,106 @@
  * Created by switchblade on 2023-06-14.
  */
 
+#include <rod/async_mutex.hpp>
 #include <rod/scheduling.hpp>
+#include <latch>
+#include <mutex>
 #include <set>
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 #include "common.hpp"
 
+struct priority_env
+{
+	friend constexpr rod::priority tag_invoke(rod::get_priority_t, const priority_env &e) noexcept { return e.prio; }
+
+	rod::priority prio;
+};
+template<typename Sch>
+struct scheduler_env
+{
+	friend constexpr Sch tag_invoke(rod::get_scheduler_t, const scheduler_env &e) noexcept { return e.sch; }
+
+	Sch sch;
+};
+struct stop_env
+{
+	friend constexpr rod::in_place_stop_token tag_invoke(rod::get_stop_token_t, const stop_env &e) noexcept { return e.tok; }
+
+	rod::in_place_stop_token tok;
+};
+template<typename Env>
+struct recording_receiver
+{
+	using is_receiver = std::true_type;
+
+	friend Env tag_invoke(rod::get_env_t, const recording_receiver &r) noexcept { return r.env; }
+	friend void tag_invoke(rod::set_value_t, recording_receiver &&r) noexcept
+	{
+		r.order->push_back(r.id);
+		r.done->count_down();
+	}
+	friend void tag_invoke(rod::set_stopped_t, recording_receiver &&r) noexcept
+	{
+		r.order->push_back(-1);
+		r.done->count_down();
+	}
+	friend void tag_invoke(rod::set_error_t, recording_receiver &&, std::exception_ptr) noexcept { std::terminate(); }
+
+	Env env;
+	int id;
+	std::vector<int> *order;
+	std::latch *done;
+};
+
+template<typename T>
+struct counting_allocator
+{
+	using value_type = T;
+
+	constexpr counting_allocator(int *live) noexcept : live(live) {}
+	template<typename U>
+	constexpr counting_allocator(const counting_allocator<U> &other) noexcept : live(other.live) {}
+
+	T *allocate(std::size_t n) { return (++*live, std::allocator<T>{}.allocate(n)); }
+	void deallocate(T *ptr, std::size_t n) { (--*live, std::allocator<T>{}.deallocate(ptr, n)); }
+
+	constexpr bool operator==(const counting_allocator &) const noexcept = default;
+
+	int *live;
+};
+struct allocator_env
+{
+	friend counting_allocator<std::byte> tag_invoke(rod::get_allocator_t, const allocator_env &e) noexcept { return {e.live}; }
+
+	int *live;
+};
+template<typename Env>
+struct value_receiver
+{
+	using is_receiver = std::true_type;
+
+	friend Env tag_invoke(rod::get_env_t, const value_receiver &r) noexcept { return r.env; }
+	friend void tag_invoke(rod::set_value_t, value_receiver &&r, std::size_t value) noexcept { *r.value = value; }
+	friend void tag_invoke(rod::set_stopped_t, value_receiver &&) noexcept { std::terminate(); }
+	friend void tag_invoke(rod::set_error_t, value_receiver &&, std::exception_ptr) noexcept { std::terminate(); }
+
+	Env env;
+	std::size_t *value;
+};
+
+/* Connects and starts an operation, keeping its state alive within \a ops. */
+template<typename Snd, typename Rcv>
+static void start_op(std::vector<std::shared_ptr<void>> &ops, Snd &&snd, Rcv rcv)
+{
+	auto *op = new auto(rod::connect(std::forward<Snd>(snd), std::move(rcv)));
+	ops.emplace_back(std::shared_ptr<std::remove_pointer_t<decltype(op)>>(op));
+	rod::start(*op);
+}
+
 int main()
 {
 	rod::thread_pool pool;
@@ -14,14 +109,300 @@ int main()
 
 	TEST_ASSERT(pool.size() != 0);
 
+	std::mutex mtx;
 	std::set<std::thread::id> workers;
 	const auto main_tid = std::this_thread::get_id();
+	const auto add_worker = [&]() { const auto g = std::lock_guard(mtx); workers.emplace(std::this_thread::get_id()); };
 
-	rod::sync_wait(rod::schedule(sch) | rod::bulk(pool.size(), [&](auto) { workers.emplace(std::this_thread::get_id()); }));
-	rod::sync_wait(rod::schedule(sch) | rod::then([&]() { workers.emplace(std::this_thread::get_id()); }));
+	rod::sync_wait(rod::schedule(sch) | rod::bulk(pool.size(), [&](auto) { add_worker(); }));
+	rod::sync_wait(rod::schedule(sch) | rod::then([&]() { add_worker(); }));
 
 	TEST_ASSERT(!workers.contains(main_tid));
 	TEST_ASSERT(!workers.empty());
 
+	/* `sync_wait` waits on its run loop both for senders completing on another thread and for senders delegating to the run loop's scheduler. */
+	{
+		std::size_t sum = 0;
+		for (std::size_t i = 0; i < 10000; ++i)
+			sum += std::get<0>(*rod::sync_wait(rod::schedule(sch) | rod::then([i]() { return i; })));
+		TEST_ASSERT(sum == 10000 * 9999 / 2);
+
+		const auto delegated = rod::read(rod::get_delegatee_scheduler) | rod::let_value([](auto dsch) { return rod::schedule(dsch) | rod::then([]() { return std::this_thread::get_id(); }); });
+		TEST_ASSERT(std::get<0>(*rod::sync_wait(rod::schedule(sch) | rod::let_value([&]() { return delegated; }))) == main_tid);
+	}
+
+	/* Every index of a bulk operation must be visited exactly once, regardless of chunking or which worker executes the chunk. */
+	for (const std::size_t grain: {0, 1, 7, 100000})
+	{
+		constexpr std::size_t n = 10000;
+		auto visited = std::vector<std::atomic<int>>(n);
+		auto grain_sch = sch.with_bulk_grain(grain);
+
+		TEST_ASSERT(grain_sch.bulk_grain() == grain);
+		rod::sync_wait(rod::schedule(grain_sch) | rod::bulk(n, [&](std::size_t i) { visited[i].fetch_add(1, std::memory_order_relaxed); }));
+		for (auto &v: visited) TEST_ASSERT(v.load() == 1);
+	}
+	/* Skewed iterations must be balanced between workers, and exceptions must propagate. */
+	{
+		rod::thread_pool pool4(4);
+		std::atomic<std::size_t> sum = 0;
+
+		rod::sync_wait(rod::schedule(pool4.get_scheduler()) | rod::bulk(256, [&](int i)
+		{
+			if (i < 4) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			sum.fetch_add(static_cast<std::size_t>(i), std::memory_order_relaxed);
+		}));
+		TEST_ASSERT(sum.load() == 255 * 256 / 2);
+
+		bool has_error = false;
+		try { rod::sync_wait(rod::schedule(pool4.get_scheduler()) | rod::bulk(1000, [](int i) { if (i == 500) throw std::runtime_error("bulk"); })); }
+		catch (std::runtime_error &) { has_error = true; }
+		TEST_ASSERT(has_error);
+	}
+	/* Work scheduled from within a worker goes to its local queue, and must be stolen by other workers while that worker is blocked. */
+	{
+		constexpr std::size_t n = 4096;
+		std::atomic<std::size_t> counter = 0;
+		rod::thread_pool pool4(4);
+
+		auto sch4 = pool4.get_scheduler();
+		rod::sync_wait(rod::schedule(sch4) | rod::then([&]()
+		{
+			rod::sync_wait(rod::schedule(sch4) | rod::bulk(n, [&](std::size_t) { counter.fetch_add(1, std::memory_order_relaxed); }));
+		}));
+		TEST_ASSERT(counter.load() == n);
+	}
+	/* Work of higher priority lanes is executed first, with priority taken from the receiver's environment or the scheduler. */
+	{
+		constexpr int n = 8;
+		rod::thread_pool pool1(1);
+		auto sch1 = pool1.get_scheduler();
+		auto low_sch = sch1.with_priority(rod::priority::low);
+		TEST_ASSERT(sch1.priority() == rod::priority::normal && low_sch.priority() == rod::priority::low);
+
+		std::latch gate(1), done(3 * n + 1);
+		std::vector<int> order;
+		std::vector<std::shared_ptr<void>> ops;
+
+		/* Block the only worker so that all operations are queued before any of them are executed. */
+		start_op(ops, rod::schedule(sch1) | rod::then([&]() { gate.wait(); }), recording_receiver<rod::empty_env>{{}, 1, &order, &done});
+		for (int i = 0; i < n; ++i)
+		{
+			start_op(ops, rod::schedule(low_sch), recording_receiver<rod::empty_env>{{}, 2, &order, &done});
+			start_op(ops, rod::schedule(sch1), recording_receiver<rod::empty_env>{{}, 1, &order, &done});
+			start_op(ops, rod::schedule(low_sch), recording_receiver<priority_env>{{rod::priority::high}, 0, &order, &done});
+		}
+		gate.count_down();
+		done.wait();
+
+		/* Lower lanes may occasionally be visited first to avoid starvation, so only compare the average positions of each lane. */
+		std::size_t positions[3] = {};
+		for (std::size_t i = 0; i < order.size(); ++i)
+			positions[order[i]] += i;
+		TEST_ASSERT(positions[0] < positions[1] && positions[1] < positions[2]);
+	}
+	/* Operations of the thread pool scheduler started together by `when_all` are submitted in a batch, both from outside and from within the pool. */
+	{
+		constexpr int n = 256;
+		std::atomic<int> counter = 0;
+		const auto count = [&]() { counter.fetch_add(1, std::memory_order_relaxed); };
+
+		for (int i = 0; i < n; ++i)
+		{
+			rod::sync_wait(rod::when_all(rod::schedule(sch), rod::schedule(sch), rod::schedule(sch.with_priority(rod::priority::high)), rod::schedule(sch)) | rod::then(count));
+			rod::sync_wait(rod::schedule(sch) | rod::let_value([&]() { return rod::when_all(rod::schedule(sch), rod::schedule(sch), rod::schedule(sch)); }) | rod::then(count));
+		}
+		TEST_ASSERT(counter.load() == 2 * n);
+	}
+	/* Timers are completed on a worker in the order of their timeouts, and may be cancelled via the stop token of the receiver. */
+	{
+		rod::thread_pool pool1(1);
+		auto sch1 = pool1.get_scheduler();
+
+		const auto start = sch1.now();
+		rod::sync_wait(rod::schedule_after(sch1, std::chrono::milliseconds(10)) | rod::then([&]() { add_worker(); }));
+		TEST_ASSERT(sch1.now() - start >= std::chrono::milliseconds(10));
+		TEST_ASSERT(!workers.contains(main_tid));
+
+		std::latch done(4);
+		std::vector<int> order;
+		std::vector<std::shared_ptr<void>> ops;
+		rod::in_place_stop_source src;
+
+		const auto now = sch1.now();
+		start_op(ops, rod::schedule_after(sch1, std::chrono::hours(1)), recording_receiver<stop_env>{{src.get_token()}, 3, &order, &done});
+		start_op(ops, rod::schedule_at(sch1, now + std::chrono::milliseconds(150)), recording_receiver<rod::empty_env>{{}, 2, &order, &done});
+		start_op(ops, rod::schedule_at(sch1, now + std::chrono::milliseconds(50)), recording_receiver<rod::empty_env>{{}, 0, &order, &done});
+		start_op(ops, rod::schedule_at(sch1, now + std::chrono::milliseconds(100)), recording_receiver<rod::empty_env>{{}, 1, &order, &done});
+		src.request_stop();
+		done.wait();
+		TEST_ASSERT((order == std::vector{-1, 0, 1, 2}));
+
+		/* Timers started with an already stopped token are completed immediately. */
+		std::latch stopped(1);
+		start_op(ops, rod::schedule_after(sch1, std::chrono::hours(1)), recording_receiver<stop_env>{{src.get_token()}, 3, &order, &stopped});
+		stopped.wait();
+		TEST_ASSERT(order.back() == -1);
+	}
+	/* Worker statistics account for every executed operation, and collect latencies only while latency tracking is enabled. */
+	{
+		constexpr std::size_t n = 1000;
+		rod::thread_pool pool4(4);
+		auto sch4 = pool4.get_scheduler();
+
+		TEST_ASSERT(!pool4.latency_tracking());
+		rod::sync_wait(rod::schedule(sch4) | rod::bulk(n, [](std::size_t) {}));
+		pool4.set_latency_tracking(true);
+		TEST_ASSERT(pool4.latency_tracking());
+		for (std::size_t i = 0; i < n; ++i)
+			rod::sync_wait(rod::schedule(sch4));
+
+		const auto stats = pool4.stats();
+		TEST_ASSERT(stats.size() == pool4.size());
+
+		std::uint64_t executed = 0, measured = 0;
+		for (auto &worker: stats)
+		{
+			executed += worker.executed;
+			for (auto count: worker.latency) measured += count;
+			TEST_ASSERT(worker.queue_depth == 0);
+		}
+		/* Bulk operations execute at least one task, and every `schedule` operation is measured. */
+		TEST_ASSERT(executed >= n + 1);
+		TEST_ASSERT(measured == n);
+	}
+	/* Workers blocked within a `blocking_region` are taken over by compensating threads, so that the rest of the work is not stalled. */
+	{
+		constexpr int n = 8;
+		rod::thread_pool pool1(1);
+		auto sch1 = pool1.get_scheduler();
+		auto blocking_sch = pool1.get_blocking_scheduler();
+		TEST_ASSERT(!sch1.is_blocking() && blocking_sch.is_blocking());
+		TEST_ASSERT(blocking_sch.with_priority(rod::priority::high).is_blocking());
+
+		std::latch gate(1), released(2), others(n);
+		std::vector<int> blocked_order[2], others_order;
+		std::vector<std::shared_ptr<void>> ops;
+
+		/* Both operations block the only worker until all other work is complete. */
+		start_op(ops, rod::schedule(sch1) | rod::then([&]() { const auto g = rod::blocking_region(); gate.wait(); }), recording_receiver<rod::empty_env>{{}, 0, &blocked_order[0], &released});
+		start_op(ops, rod::schedule(blocking_sch) | rod::then([&]() { gate.wait(); }), recording_receiver<rod::empty_env>{{}, 1, &blocked_order[1], &released});
+		for (int i = 0; i < n; ++i)
+			start_op(ops, rod::schedule(sch1), recording_receiver<rod::empty_env>{{}, i, &others_order, &others});
+
+		others.wait();
+		TEST_ASSERT(others_order.size() == n);
+		gate.count_down();
+		released.wait();
+
+		/* Blocked threads either take their workers back or become compensating threads themselves. */
+		rod::sync_wait(rod::schedule(sch1) | rod::then([&]() { add_worker(); }));
+		TEST_ASSERT(!workers.contains(main_tid));
+	}
+	/* Results of a dynamic range of senders are collected in the order of the range, regardless of which worker completes them. */
+	{
+		constexpr std::size_t n = 1000;
+		using sender_t = decltype(rod::schedule(sch) | rod::then(std::function<std::size_t()>()));
+
+		std::vector<sender_t> senders;
+		for (std::size_t i = 0; i < n; ++i)
+			senders.push_back(rod::schedule(sch) | rod::then(std::function<std::size_t()>([i]() { return i; })));
+
+		const auto [values] = *rod::sync_wait(rod::when_all_range(senders));
+		TEST_ASSERT(values.size() == n);
+		for (std::size_t i = 0; i < n; ++i) TEST_ASSERT(values[i] == i);
+
+		const auto [sum] = *rod::sync_wait(rod::accumulate(senders, std::size_t(0), [](std::size_t acc, std::size_t i) { return acc + i; }));
+		TEST_ASSERT(sum == n * (n - 1) / 2);
+
+		senders.clear();
+		TEST_ASSERT(std::get<0>(*rod::sync_wait(rod::when_all_range(senders))).empty());
+	}
+	/* Child operations are allocated using the allocator of the receiver's environment in favor of the allocator of the range. */
+	{
+		using sender_t = decltype(rod::just(std::size_t()));
+		const auto acc = [](std::size_t acc, std::size_t i) { return acc + i; };
+		int env_live = 0, rng_live = 0;
+		{
+			auto senders = std::vector<sender_t, counting_allocator<sender_t>>(&rng_live);
+			for (std::size_t i = 0; i < 16; ++i) senders.push_back(rod::just(i));
+			TEST_ASSERT(rng_live == 1);
+
+			std::size_t sum = 0;
+			{
+				auto op = rod::connect(rod::accumulate(senders, std::size_t(0), acc), value_receiver<allocator_env>{{&env_live}, &sum});
+				TEST_ASSERT(env_live == 1 && rng_live == 1);
+				rod::start(op);
+				TEST_ASSERT(sum == 120);
+			}
+			{
+				auto op = rod::connect(rod::accumulate(senders, std::size_t(0), acc), value_receiver<rod::empty_env>{{}, &sum});
+				TEST_ASSERT(env_live == 0 && rng_live == 2);
+			}
+		}
+		TEST_ASSERT(env_live == 0 && rng_live == 0);
+	}
+	/* Waiters of `async_mutex` acquire the lock one at a time, whether the lock is handed off inline or through the pool. */
+	{
+		constexpr std::size_t n = 1000;
+
+		rod::async_mutex mtx;
+		std::atomic<int> inside = 0;
+		std::size_t counter = 0;
+		bool overlap = false;
+
+		const auto critical = [&]() { overlap |= inside.fetch_add(1) != 0; ++counter; inside.fetch_sub(1); };
+		const auto scheduled = [&](rod::async_lock_guard) { critical(); };
+		const auto inline_lock = [&]() { return mtx.async_lock() | rod::then([&]() { critical(); mtx.unlock(); }); };
+
+		auto scheduled_senders = std::vector<decltype(mtx.async_scoped_lock(sch) | rod::then(scheduled))>();
+		auto inline_senders = std::vector<decltype(rod::schedule(sch) | rod::let_value(inline_lock))>();
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			scheduled_senders.push_back(mtx.async_scoped_lock(sch) | rod::then(scheduled));
+			inline_senders.push_back(rod::schedule(sch) | rod::let_value(inline_lock));
+		}
+
+		rod::sync_wait(rod::when_all(rod::when_all_range(scheduled_senders), rod::when_all_range(inline_senders)));
+		TEST_ASSERT(counter == 2 * n);
+		TEST_ASSERT(!overlap);
+		TEST_ASSERT(mtx.try_lock());
+	}
+	/* Workers of a pool constructed from the CPU topology are grouped by node and pinned to the node's CPUs. */
+	{
+		const auto topology = rod::cpu_topology();
+		TEST_ASSERT(!topology.empty());
+
+		rod::thread_pool numa_pool(topology);
+		TEST_ASSERT(numa_pool.node_count() == topology.size());
+		TEST_ASSERT(numa_pool.this_node() == rod::thread_pool::any_node);
+		TEST_ASSERT(rod::get_numa_node(numa_pool.get_scheduler()) == rod::unknown_numa_node);
+		TEST_ASSERT(rod::get_numa_node(pool.get_scheduler().on_node(0)) == rod::unknown_numa_node);
+
+		std::atomic<bool> pinned = true;
+		for (std::size_t i = 0; i < topology.size(); ++i)
+		{
+			const auto node_sch = numa_pool.get_scheduler(i);
+			TEST_ASSERT(node_sch.node() == i);
+			TEST_ASSERT(rod::get_completion_scheduler<rod::set_value_t>(rod::get_env(rod::schedule(node_sch))) == node_sch);
+
+			/* NUMA node is reported by the scheduler, by its sender environment, and by environments of receivers that provide the scheduler. */
+			TEST_ASSERT(rod::get_numa_node(node_sch) == topology[i].id);
+			TEST_ASSERT(rod::get_numa_node(rod::get_env(rod::schedule(node_sch))) == topology[i].id);
+			TEST_ASSERT(rod::get_numa_node(scheduler_env<decltype(node_sch)>{node_sch}) == topology[i].id);
+
+			rod::sync_wait(rod::schedule(node_sch) | rod::bulk(numa_pool.size(), [&](std::size_t)
+			{
+				const auto node = numa_pool.this_node();
+				if (node >= topology.size()) pinned = false;
+#ifdef __linux__
+				else if (std::ranges::find(topology[node].cpus, static_cast<std::size_t>(::sched_getcpu())) == topology[node].cpus.end())
+					pinned = false;
+#endif
+			}));
+		}
+		TEST_ASSERT(pinned.load());
+	}
+
 	pool.finish();
 }
\ No newline at end of file